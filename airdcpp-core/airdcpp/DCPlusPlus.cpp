@@ -19,7 +19,10 @@
 #include "stdinc.h"
 #include <airdcpp/DCPlusPlus.h>
 
+#include <airdcpp/core/classes/ScopedFunctor.h>
 #include <airdcpp/core/header/format.h>
+#include <airdcpp/core/thread/CriticalSection.h>
+#include <airdcpp/core/timer/TimerManager.h>
 #include <airdcpp/util/AppUtil.h>
 #include <airdcpp/core/io/File.h>
 #include <airdcpp/util/PathUtil.h>
@@ -57,10 +60,197 @@
 #include <airdcpp/hub/user_command/UserCommandManager.h>
 #include <airdcpp/viewed_files/ViewFileManager.h>
 
+#include <condition_variable>
+#include <future>
+
 namespace dcpp {
 
 #define RUNNING_FLAG AppUtil::getPath(AppUtil::PATH_USER_LOCAL) + "RUNNING"
 
+static StartupPhaseList startupPhases;
+static CriticalSection startupPhaseCS;
+static uint64_t startupTick = 0;
+
+StartupPhaseList getStartupPhases() noexcept {
+	Lock l(startupPhaseCS);
+	return startupPhases;
+}
+
+static void runStartupPhase(const string& aId, const Callback& aCallback) {
+	auto start = GET_TICK();
+	aCallback();
+	auto end = GET_TICK();
+
+	Lock l(startupPhaseCS);
+	startupPhases.push_back({ aId, start - startupTick, end - start });
+}
+
+// Startup phases that don't depend on each other and can be loaded concurrently
+// Each phase has its own loader so that the post load tasks are run in a fixed order
+// The loader callbacks of the phases are called from the thread running the phases (as with the sequential phases)
+class ParallelStartupPhases {
+public:
+	using PhaseCallback = function<void (StartupLoader&)>;
+
+	explicit ParallelStartupPhases(StartupLoader& aParentLoader) : parentLoader(aParentLoader) { }
+
+	void addPhase(const string& aId, const string& aTitle, PhaseCallback&& aCallback) noexcept {
+		auto index = phases.size();
+		auto phase = make_unique<Phase>(aId, aTitle, std::move(aCallback));
+		phase->stepF = [this](const string& aStep) {
+			invoke<void>([&] { parentLoader.stepF(aStep); });
+		};
+
+		phase->progressF = [this, index](float aProgress) {
+			invoke<void>([&] { onProgress(index, aProgress); });
+		};
+
+		phase->messageF = [this](const string& aMessage, bool aIsQuestion, bool aIsError) {
+			return invoke<bool>([&] { return parentLoader.messageF(aMessage, aIsQuestion, aIsError); });
+		};
+
+		phase->loader = make_unique<StartupLoader>(phase->stepF, phase->progressF, phase->messageF);
+		phases.push_back(std::move(phase));
+	}
+
+	// Blocks until all phases have completed, rethrows the first exception
+	void run() {
+		running = true;
+
+		vector<std::future<void>> tasks;
+		for (const auto& phase: phases) {
+			tasks.push_back(std::async(std::launch::async, [this, &phase] {
+				ScopedFunctor([this] { onPhaseCompleted(); });
+				runPhase(*phase);
+			}));
+		}
+
+		dispatchCallbacks();
+		running = false;
+
+		for (auto& task: tasks) {
+			task.get();
+		}
+
+		for (const auto& phase: phases) {
+			for (const auto& cb: phase->loader->getPostLoadTasks()) {
+				parentLoader.addPostLoadTask(Callback(cb));
+			}
+		}
+	}
+
+	string getTitle() const noexcept {
+		StringList titles;
+		for (const auto& phase: phases) {
+			titles.push_back(phase->title);
+		}
+
+		return Util::toString(", ", titles);
+	}
+private:
+	struct Phase {
+		Phase(const string& aId, const string& aTitle, PhaseCallback&& aCallback) : id(aId), title(aTitle), callback(std::move(aCallback)) { }
+
+		const string id;
+		const string title;
+		const PhaseCallback callback;
+
+		float progress = 0;
+
+		StepFunction stepF;
+		ProgressFunction progressF;
+		MessageFunction messageF;
+		unique_ptr<StartupLoader> loader;
+	};
+
+	static void runPhase(Phase& aPhase) {
+		runStartupPhase(aPhase.id, [&aPhase] {
+			aPhase.callback(*aPhase.loader);
+		});
+	}
+
+	// Run the callback in the thread calling run() and wait for the result
+	template<class RetT>
+	RetT invoke(function<RetT ()>&& aCallback) {
+		if (!running) {
+			// Post load task
+			return aCallback();
+		}
+
+		std::packaged_task<RetT ()> task(std::move(aCallback));
+		auto result = task.get_future();
+
+		{
+			std::lock_guard<std::mutex> l(cs);
+			pendingCallbacks.emplace_back([&task] { task(); });
+		}
+
+		cond.notify_one();
+		return result.get();
+	}
+
+	void onPhaseCompleted() noexcept {
+		{
+			std::lock_guard<std::mutex> l(cs);
+			completedPhases++;
+		}
+
+		cond.notify_one();
+	}
+
+	// Run the callbacks of the phases until all of them have completed
+	void dispatchCallbacks() {
+		std::unique_lock<std::mutex> l(cs);
+		while (true) {
+			cond.wait(l, [this] { return !pendingCallbacks.empty() || completedPhases == phases.size(); });
+			if (pendingCallbacks.empty()) {
+				// The phases wait for their callbacks so nothing can be pending after completion
+				break;
+			}
+
+			auto callback = std::move(pendingCallbacks.front());
+			pendingCallbacks.pop_front();
+
+			l.unlock();
+			callback();
+			l.lock();
+		}
+	}
+
+	void onProgress(size_t aIndex, float aProgress) noexcept {
+		if (!parentLoader.progressF) {
+			return;
+		}
+
+		if (!running) {
+			// Post load task
+			parentLoader.progressF(aProgress);
+			return;
+		}
+
+		// Report the combined progress of all phases
+		phases[aIndex]->progress = aProgress;
+
+		float total = 0;
+		for (const auto& phase: phases) {
+			total += phase->progress;
+		}
+
+		parentLoader.progressF(total / static_cast<float>(phases.size()));
+	}
+
+	StartupLoader& parentLoader;
+	vector<unique_ptr<Phase>> phases;
+
+	atomic<bool> running = false;
+
+	// Callbacks from the phase threads
+	std::mutex cs;
+	std::condition_variable cond;
+	deque<Callback> pendingCallbacks;
+	size_t completedPhases = 0;
+};
+
 void initializeUtil(const string& aConfigPath) noexcept {
 	AppUtil::initialize(aConfigPath);
 	ValueGenerator::initialize();
@@ -88,8 +278,8 @@ void startup(StepFunction aStepF, MessageFunction aMessageF, Callback aRunWizard
 	ResourceManager::newInstance();
 	SettingsManager::newInstance();
 
-	LogManager::newInstance();
 	TimerManager::newInstance();
+	LogManager::newInstance();
 	HashManager::newInstance();
 	CryptoManager::newInstance();
 	SearchManager::newInstance();
@@ -122,6 +312,12 @@ void startup(StepFunction aStepF, MessageFunction aMessageF, Callback aRunWizard
 		aModuleInitF();
 	}
 
+	startupTick = GET_TICK();
+	{
+		Lock l(startupPhaseCS);
+		startupPhases.clear();
+	}
+
 	const auto announce = [&aStepF](const string& str) {
 		if (aStepF) {
 			aStepF(str);
@@ -134,10 +330,13 @@ void startup(StepFunction aStepF, MessageFunction aMessageF, Callback aRunWizard
 		aMessageF
 	);
 
-	SettingsManager::getInstance()->load(loader);
-	FavoriteManager::getInstance()->load();
+	runStartupPhase("settings", [&loader] {
+		SettingsManager::getInstance()->load(loader);
+		FavoriteManager::getInstance()->load();
+	});
 
 	UploadManager::getInstance()->setFreeSlotMatcher();
+	UploadManager::getInstance()->setBlockCacheSize();
 	Localization::init();
 	if (SETTING(WIZARD_PENDING) && aRunWizardF) {
 		aRunWizardF();
@@ -149,41 +348,59 @@ void startup(StepFunction aStepF, MessageFunction aMessageF, Callback aRunWizard
 		ResourceManager::getInstance()->loadLanguage(SETTING(LANGUAGE_FILE));
 	}
 
-	CryptoManager::getInstance()->loadCertificates();
+	runStartupPhase("certificates", [] {
+		CryptoManager::getInstance()->loadCertificates();
+	});
 
 	loader.stepF(STRING(HASH_DATABASE));
-	try {
-		HashManager::getInstance()->startup(loader);
-	} catch (const HashException&) {
-		throw Exception();
+	runStartupPhase("hash_database", [&loader] {
+		try {
+			HashManager::getInstance()->startup(loader);
+		} catch (const HashException&) {
+			throw Exception();
+		}
+	});
+
+	// The queue and share cache depend only on the hash database
+	ParallelStartupPhases parallelPhases(loader);
+	parallelPhases.addPhase("queue", STRING(DOWNLOAD_QUEUE), [](StartupLoader& aLoader) {
+		QueueManager::getInstance()->loadQueue(aLoader);
+	});
+
+	parallelPhases.addPhase("share", STRING(SHARED_FILES), [](StartupLoader& aLoader) {
+		ShareManager::getInstance()->startup(aLoader);
+	});
+
+	if (SETTING(GET_USER_COUNTRY)) {
+		parallelPhases.addPhase("geoip", STRING(COUNTRY_INFORMATION), [](StartupLoader&) {
+			GeoManager::getInstance()->init();
+		});
 	}
 
-	loader.stepF(STRING(DOWNLOAD_QUEUE));
-	QueueManager::getInstance()->loadQueue(loader);
-
-	loader.stepF(STRING(SHARED_FILES));
-	ShareManager::getInstance()->startup(loader);
+	loader.stepF(parallelPhases.getTitle());
+	parallelPhases.run();
 
 	IgnoreManager::getInstance()->load();
 	RecentManager::getInstance()->load();
 
-	if(SETTING(GET_USER_COUNTRY)) {
-		loader.stepF(STRING(COUNTRY_INFORMATION));
-		GeoManager::getInstance()->init();
-	}
-
 	loader.stepF(STRING(CONNECTIVITY));
-	ConnectivityManager::getInstance()->startup(loader);
+	runStartupPhase("connectivity", [&loader] {
+		ConnectivityManager::getInstance()->startup(loader);
+	});
 
 	// Modules may depend on data loaded in other sections
 	// Initialization should still be performed before loading SettingsManager as some modules save their config there
 	if (aModuleLoadF) {
-		aModuleLoadF(loader);
+		runStartupPhase("modules", [&aModuleLoadF, &loader] {
+			aModuleLoadF(loader);
+		});
 	}
 
-	for (const auto& cb: loader.getPostLoadTasks()) {
-		cb();
-	}
+	runStartupPhase("post_load_tasks", [&loader] {
+		for (const auto& cb: loader.getPostLoadTasks()) {
+			cb();
+		}
+	});
 }
 
 void shutdown(StepFunction stepF, ProgressFunction progressF, ShutdownUnloadCallback aModuleUnloadF, Callback aModuleDestroyF) {
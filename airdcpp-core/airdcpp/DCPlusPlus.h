@@ -45,6 +45,16 @@ private:
 	vector<Callback> postLoadTasks;
 };
 
+struct StartupPhase {
+	string id;
+
+	// Milliseconds from the beginning of the startup
+	uint64_t started;
+	uint64_t duration;
+};
+
+using StartupPhaseList = vector<StartupPhase>;
+
 using StartupLoadCallback = function<void (StartupLoader&)>;
 using ShutdownUnloadCallback = function<void (StepFunction&, ProgressFunction&)>;
 
@@ -55,6 +65,9 @@ extern void shutdown(StepFunction stepF, ProgressFunction progressF, ShutdownUnl
 
 extern void initializeUtil(const string& aConfigPath = "") noexcept;
 
+// Timings of the startup phases that have been completed
+extern StartupPhaseList getStartupPhases() noexcept;
+
 } // namespace dcpp
 
 #endif // !defined(DC_PLUS_PLUS_H)
\ No newline at end of file
@@ -29,6 +29,35 @@ namespace dcpp {
 
 using std::vector;
 
+// Identifies the listener loop that is currently being run by a speaker in this thread
+// Listeners may use it to share data that is generated from the event arguments (e.g. serialized events)
+class SpeakerDispatch {
+public:
+	// Returns 0 if no listeners are being fired
+	static uint64_t getCurrentId() noexcept {
+		return currentId;
+	}
+
+	class Scope {
+	public:
+		Scope() noexcept : prevId(currentId) {
+			currentId = ++lastId;
+		}
+
+		~Scope() {
+			currentId = prevId;
+		}
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+	private:
+		const uint64_t prevId;
+	};
+private:
+	static inline thread_local uint64_t currentId = 0;
+	static inline thread_local uint64_t lastId = 0;
+};
+
 template<typename Listener>
 class Speaker {
 	typedef vector<Listener*> ListenerList;
@@ -42,6 +71,7 @@ public:
 	template<typename... ArgT>
 	void fire(ArgT&&... args) noexcept {
 		Lock l(listenerCS);
+		SpeakerDispatch::Scope dispatch;
 		tmpListeners = listeners;
 		for(auto listener: tmpListeners) {
 			listener->on(std::forward<ArgT>(args)...);
@@ -53,6 +83,7 @@ public:
 	template<typename... ArgT>
 	void fireReversed(ArgT&&... args) noexcept {
 		Lock l(listenerCS);
+		SpeakerDispatch::Scope dispatch;
 		tmpListeners = listeners;
 		for (auto listener : tmpListeners | views::reverse) {
 			listener->on(std::forward<ArgT>(args)...);
@@ -29,8 +29,8 @@ public:
 	BloomFilter(size_t tableSize) { table.resize(tableSize); }
 	~BloomFilter() { }
 
-	void add(const string& s) { xadd(s, N); }
-	bool match(const string& s) const {
+	void add(string_view s) { xadd(s, N); }
+	bool match(string_view s) const {
 		if(s.length() >= N) {
 			string::size_type l = s.length() - N;
 			for(string::size_type i = 0; i <= l; ++i) {
@@ -65,7 +65,7 @@ public:
 	}
 #endif
 private:
-	void xadd(const string& s, size_t n) {
+	void xadd(string_view s, size_t n) {
 		if(s.length() >= n) {
 			string::size_type l = s.length() - n;
 			for(string::size_type i = 0; i <= l; ++i) {
@@ -75,7 +75,7 @@ private:
 	}
 
 	/* This is roughly how boost::hash does it */
-	size_t getPos(const string& s, size_t i, size_t l) const {
+	size_t getPos(string_view s, size_t i, size_t l) const {
 		size_t h = 0;
 		const char* c = s.data() + i;
 		const char* end = s.data() + i + l;
@@ -29,6 +29,14 @@
 
 #include <maxminddb.h>
 
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#endif
+
+// Each entry is a network from the database so the cache stays small in practice
+#define MAX_CACHED_PREFIXES 20000
+
 namespace dcpp {
 
 // Application locales mapped to supported GeoIP languages
@@ -84,49 +92,205 @@ static string parseData(MMDB_lookup_result_s res, ...) {
 
 } // unnamed namespace
 
+size_t GeoIP::PrefixHash::operator()(const Prefix& aPrefix) const noexcept {
+	auto addressHash = std::hash<string_view>()(string_view(reinterpret_cast<const char*>(aPrefix.address.data()), aPrefix.address.size()));
+	return addressHash ^ (static_cast<size_t>(aPrefix.bits) << 1 | static_cast<size_t>(aPrefix.v6));
+}
+
+bool GeoIP::parseAddress(const string& aIp, Prefix& address_) noexcept {
+	if (inet_pton(AF_INET, aIp.c_str(), address_.address.data()) == 1) {
+		address_.bits = 32;
+		address_.v6 = false;
+		return true;
+	}
+
+	if (inet_pton(AF_INET6, aIp.c_str(), address_.address.data()) == 1) {
+		address_.bits = 128;
+		address_.v6 = true;
+		return true;
+	}
+
+	return false;
+}
+
+GeoIP::Prefix GeoIP::getNetwork(const Prefix& aAddress, uint8_t aBits) noexcept {
+	Prefix ret;
+	ret.bits = aBits;
+	ret.v6 = aAddress.v6;
+
+	auto bytes = aBits / 8;
+	copy_n(aAddress.address.begin(), bytes, ret.address.begin());
+	if (aBits % 8 != 0) {
+		ret.address[bytes] = aAddress.address[bytes] & static_cast<uint8_t>(0xFF << (8 - aBits % 8));
+	}
+
+	return ret;
+}
+
 string GeoIP::getCountry(const string& ip) const {
-	if (geo) {
-		int gai_error, mmdb_error;
-		MMDB_lookup_result_s res = MMDB_lookup_string(
-			geo, 
-			ip.c_str(), 
-			&gai_error, 
-			&mmdb_error
-		);
-
-		if (res.found_entry && mmdb_error == MMDB_SUCCESS && gai_error == 0) {
-			const string& setting = SETTING(COUNTRY_FORMAT);
-
-			ParamMap params;
-			params["2code"] = [&] { return parseData(res, "country", "iso_code", NULL); };
-			params["continent"] = [&] { return parseData(res, "continent", "code", NULL); };
-			params["engname"] = [&] { return parseData(res, "country", "names", "en", NULL); };
-			params["name"] = [&] { return parseData(res, "country", "names", language.c_str(), NULL); };
-			params["officialname"] = [&] { return parseData(res, "country", "names", language.c_str(), NULL); };
-
-			return Util::formatParams(setting, params);
-		} else {
-			if (gai_error != 0) {
-#ifdef WIN32
-				dcdebug("Error from getaddrinfo for %s - %ls\n",
-#else
-				dcdebug("Error from getaddrinfo for %s - %s\n",
-#endif
-					ip.c_str(), gai_strerror(gai_error));
-			}
+	Prefix address;
+	if (!geo || !parseAddress(ip, address)) {
+		return Util::emptyString;
+	}
+
+	return getCountry(address, SETTING(COUNTRY_FORMAT));
+}
+
+StringList GeoIP::getCountries(const StringList& aIps) const {
+	StringList ret(aIps.size());
+	if (!geo) {
+		return ret;
+	}
 
-			if (mmdb_error != MMDB_SUCCESS) {
-				dcdebug("Got an error from libmaxminddb (MMDB_lookup_string): %s\n",
-					MMDB_strerror(mmdb_error));          	
+	const auto& format = SETTING(COUNTRY_FORMAT);
+
+	// Cached networks
+	vector<pair<size_t, Prefix>> missing;
+	{
+		RLock l(cs);
+		for (size_t i = 0; i < aIps.size(); ++i) {
+			Prefix address;
+			if (parseAddress(aIps[i], address) && !findCachedUnsafe(address, format, ret[i])) {
+				missing.emplace_back(i, address);
 			}
 		}
 	}
 
-	return Util::emptyString;
+	if (missing.empty()) {
+		return ret;
+	}
+
+	// Database lookups
+	vector<pair<Prefix, size_t>> networks;
+	for (const auto& [pos, address]: missing) {
+		optional<Prefix> network;
+		ret[pos] = lookupCountry(address, format, network);
+		if (network) {
+			networks.emplace_back(*network, pos);
+		}
+	}
+
+	{
+		WLock l(cs);
+		for (const auto& [network, pos]: networks) {
+			addCachedUnsafe(network, ret[pos], format);
+		}
+	}
+
+	return ret;
+}
+
+string GeoIP::getCountry(const Prefix& aAddress, const string& aFormat) const noexcept {
+	string country;
+
+	{
+		RLock l(cs);
+		if (findCachedUnsafe(aAddress, aFormat, country)) {
+			return country;
+		}
+	}
+
+	optional<Prefix> network;
+	country = lookupCountry(aAddress, aFormat, network);
+	if (network) {
+		WLock l(cs);
+		addCachedUnsafe(*network, country, aFormat);
+	}
+
+	return country;
+}
+
+bool GeoIP::findCachedUnsafe(const Prefix& aAddress, const string& aFormat, string& country_) const noexcept {
+	if (aFormat != cacheFormat) {
+		return false;
+	}
+
+	// Networks in the database don't overlap so there can be only a single match
+	for (auto bits: aAddress.v6 ? prefixLengths6 : prefixLengths4) {
+		auto i = cache.find(getNetwork(aAddress, bits));
+		if (i != cache.end()) {
+			country_ = i->second;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+string GeoIP::lookupCountry(const Prefix& aAddress, const string& aFormat, optional<Prefix>& network_) const noexcept {
+	sockaddr_storage storage;
+	memset(&storage, 0, sizeof(storage));
+	if (aAddress.v6) {
+		auto sa = reinterpret_cast<sockaddr_in6*>(&storage);
+		sa->sin6_family = AF_INET6;
+		memcpy(&sa->sin6_addr, aAddress.address.data(), 16);
+	} else {
+		auto sa = reinterpret_cast<sockaddr_in*>(&storage);
+		sa->sin_family = AF_INET;
+		memcpy(&sa->sin_addr, aAddress.address.data(), 4);
+	}
+
+	int mmdb_error;
+	auto res = MMDB_lookup_sockaddr(geo, reinterpret_cast<const sockaddr*>(&storage), &mmdb_error);
+	if (mmdb_error != MMDB_SUCCESS) {
+		dcdebug("Got an error from libmaxminddb (MMDB_lookup_sockaddr): %s\n", MMDB_strerror(mmdb_error));
+		return Util::emptyString;
+	}
+
+	if (!res.found_entry) {
+		return Util::emptyString;
+	}
+
+	// The netmask of IPv4 addresses is reported in the IPv6 address space with IPv6 databases
+	int bits = res.netmask;
+	if (!aAddress.v6 && geo->metadata.ip_version == 6) {
+		bits -= 96;
+	}
+
+	if (bits > 0 && bits <= aAddress.bits) {
+		network_ = getNetwork(aAddress, static_cast<uint8_t>(bits));
+	}
+
+	return formatCountry(res, aFormat);
+}
+
+void GeoIP::addCachedUnsafe(const Prefix& aNetwork, const string& aCountry, const string& aFormat) const noexcept {
+	if (aFormat != cacheFormat || cache.size() >= MAX_CACHED_PREFIXES) {
+		cache.clear();
+		prefixLengths4.clear();
+		prefixLengths6.clear();
+		cacheFormat = aFormat;
+	}
+
+	cache.try_emplace(aNetwork, aCountry);
+
+	auto& prefixLengths = aNetwork.v6 ? prefixLengths6 : prefixLengths4;
+	if (ranges::find(prefixLengths, aNetwork.bits) == prefixLengths.end()) {
+		prefixLengths.insert(ranges::upper_bound(prefixLengths, aNetwork.bits, std::greater<uint8_t>()), aNetwork.bits);
+	}
+}
+
+string GeoIP::formatCountry(const MMDB_lookup_result_s& aResult, const string& aFormat) const noexcept {
+	ParamMap params;
+	params["2code"] = [&] { return parseData(aResult, "country", "iso_code", NULL); };
+	params["continent"] = [&] { return parseData(aResult, "continent", "code", NULL); };
+	params["engname"] = [&] { return parseData(aResult, "country", "names", "en", NULL); };
+	params["name"] = [&] { return parseData(aResult, "country", "names", language.c_str(), NULL); };
+	params["officialname"] = [&] { return parseData(aResult, "country", "names", language.c_str(), NULL); };
+
+	return Util::formatParams(aFormat, params);
+}
+
+void GeoIP::clearCache() noexcept {
+	WLock l(cs);
+	cache.clear();
+	prefixLengths4.clear();
+	prefixLengths6.clear();
 }
 
 void GeoIP::update() {
 	close();
+	clearCache();
 
 	if(decompress()) {
 		open();
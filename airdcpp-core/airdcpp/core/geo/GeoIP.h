@@ -19,10 +19,16 @@
 #ifndef DCPLUSPLUS_DCPP_GEOIP_H
 #define DCPLUSPLUS_DCPP_GEOIP_H
 
+#include <airdcpp/core/header/typedefs.h>
+#include <airdcpp/core/thread/CriticalSection.h>
+
+#include <array>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 struct MMDB_s;
+struct MMDB_lookup_result_s;
 
 namespace dcpp {
 
@@ -35,15 +41,60 @@ public:
 	~GeoIP();
 
 	string getCountry(const string& ip) const;
-	void update();
 
+	// Resolve multiple addresses with a single settings and cache lookup (e.g. for user lists)
+	// The results are in the same order as the addresses
+	StringList getCountries(const StringList& aIps) const;
+
+	void update();
 private:
+	// Network in the address space of the IP version
+	struct Prefix {
+		std::array<uint8_t, 16> address = {};
+		uint8_t bits = 0;
+		bool v6 = false;
+
+		bool operator==(const Prefix& aOther) const noexcept = default;
+	};
+
+	struct PrefixHash {
+		size_t operator()(const Prefix& aPrefix) const noexcept;
+	};
+
+	// Parse a numeric address (no name resolution is performed)
+	static bool parseAddress(const string& aIp, Prefix& address_) noexcept;
+	static Prefix getNetwork(const Prefix& aAddress, uint8_t aBits) noexcept;
+
+	string getCountry(const Prefix& aAddress, const string& aFormat) const noexcept;
+
+	// Look up the address from the database
+	// The network is set if the result can be cached
+	string lookupCountry(const Prefix& aAddress, const string& aFormat, optional<Prefix>& network_) const noexcept;
+
+	// Must be called with the cache lock held
+	bool findCachedUnsafe(const Prefix& aAddress, const string& aFormat, string& country_) const noexcept;
+	void addCachedUnsafe(const Prefix& aNetwork, const string& aCountry, const string& aFormat) const noexcept;
+
+	string formatCountry(const ::MMDB_lookup_result_s& aResult, const string& aFormat) const noexcept;
+
 	bool decompress() const;
 	void open();
 	void close();
+	void clearCache() noexcept;
 
 	::MMDB_s* geo;
 
+	// Formatted countries for the networks returned by the database
+	mutable SharedMutex cs;
+	mutable std::unordered_map<Prefix, string, PrefixHash> cache;
+
+	// Prefix lengths present in the cache for each IP version (longest first)
+	mutable vector<uint8_t> prefixLengths4;
+	mutable vector<uint8_t> prefixLengths6;
+
+	// Cached values are invalidated if the format changes
+	mutable string cacheFormat;
+
 	const string path;
 	const string language;
 };
@@ -61,6 +61,14 @@ string GeoManager::getCountry(const string& ip) const {
 	return Util::emptyString;
 }
 
+StringList GeoManager::getCountries(const StringList& aIps) const {
+	if (geo) {
+		return geo->getCountries(aIps);
+	}
+
+	return StringList(aIps.size());
+}
+
 string GeoManager::getDbPath() {
 	return AppUtil::getPath(AppUtil::PATH_USER_LOCAL) + "country_ip_db.mmdb";
 }
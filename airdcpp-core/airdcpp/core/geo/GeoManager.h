@@ -45,6 +45,9 @@ public:
 	/** Map an IP address to a country. The flags specify which database(s) to look into. */
 	string getCountry(const string& ip) const;
 
+	/** Map multiple IP addresses to countries (the results are in the same order). */
+	StringList getCountries(const StringList& aIps) const;
+
 	static string getDbPath();
 
 private:
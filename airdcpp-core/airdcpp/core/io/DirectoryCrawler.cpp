@@ -0,0 +1,326 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "stdinc.h"
+
+#include <airdcpp/core/io/DirectoryCrawler.h>
+
+#include <airdcpp/util/SystemUtil.h>
+#include <airdcpp/util/text/Text.h>
+
+#include <atomic>
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Maximum number of directories that can be listed ahead of the caller
+#define MAX_PREFETCHED_DIRECTORIES 256
+
+// Maximum number of parent directory handles kept open by all crawlers
+#define MAX_OPEN_DIRECTORY_HANDLES 128
+
+namespace dcpp {
+
+#ifndef _WIN32
+static std::atomic<int> openDirectoryHandles = 0;
+#endif
+
+DirectoryCrawler::Directory::Directory(const string& aPath, const shared_ptr<Directory>& aParent, const string& aName) noexcept : path(aPath), name(aName), parent(aParent) {
+
+}
+
+DirectoryCrawler::Directory::~Directory() {
+	if (crawler) {
+		crawler->removePrefetched(*this);
+	}
+
+	closeHandle();
+}
+
+void DirectoryCrawler::Directory::closeHandle() noexcept {
+#ifndef _WIN32
+	if (fd != -1) {
+		::close(fd);
+		fd = -1;
+		openDirectoryHandles--;
+	}
+#endif
+}
+
+#ifdef _WIN32
+
+void DirectoryCrawler::Directory::list() noexcept {
+	for (FileFindIter i(path, "*"); i != FileFindIter(); ++i) {
+		auto& entry = entries.emplace_back();
+		entry.name = i->getFileName();
+		entry.directory = i->isDirectory();
+		entry.hidden = i->isHidden();
+		entry.link = i->isLink();
+		entry.size = i->getSize();
+		entry.lastWrite = i->getLastWriteTime();
+	}
+}
+
+#else
+
+void DirectoryCrawler::Directory::list() noexcept {
+	// The parent handle won't be closed before all added subdirectories have been listed
+	auto dirFd = -1;
+	if (parent && parent->fd != -1) {
+		dirFd = ::openat(parent->fd, name.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	}
+
+	if (dirFd == -1) {
+		// Root directory or the parent handle wasn't kept open
+		dirFd = ::open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	}
+
+	if (dirFd == -1) {
+		errorCode = errno;
+		error = SystemUtil::translateError(errorCode);
+		return;
+	}
+
+	// The stream takes the ownership of the handle
+	auto dir = fdopendir(::dup(dirFd));
+	if (!dir) {
+		errorCode = errno;
+		error = SystemUtil::translateError(errorCode);
+		::close(dirFd);
+		return;
+	}
+
+	auto hasDirectories = false;
+	while (auto ent = readdir(dir)) {
+		if (strcmp(ent->d_name, ".") == 0 || strcmp(ent->d_name, "..") == 0) {
+			continue;
+		}
+
+		if (!Text::validateUtf8(ent->d_name)) {
+			dcdebug("DirectoryCrawler: UTF-8 validation failed for the item name (%s)\n", Text::sanitizeUtf8(ent->d_name).c_str());
+			continue;
+		}
+
+		auto& entry = entries.emplace_back();
+		entry.name = ent->d_name;
+		entry.hidden = ent->d_name[0] == '.';
+
+		struct stat inode;
+		if (ent->d_type == DT_LNK) {
+			entry.link = true;
+		} else if (ent->d_type == DT_UNKNOWN && fstatat(dirFd, ent->d_name, &inode, AT_SYMLINK_NOFOLLOW) == 0) {
+			entry.link = S_ISLNK(inode.st_mode);
+		}
+
+		// Links are followed
+		if (fstatat(dirFd, ent->d_name, &inode, 0) == 0) {
+			entry.directory = S_ISDIR(inode.st_mode);
+			entry.size = inode.st_size;
+			entry.lastWrite = inode.st_mtime;
+
+			hasDirectories |= entry.directory;
+		}
+	}
+
+	closedir(dir);
+
+	if (hasDirectories && openDirectoryHandles++ < MAX_OPEN_DIRECTORY_HANDLES) {
+		fd = dirFd;
+	} else {
+		if (hasDirectories) {
+			openDirectoryHandles--;
+		}
+
+		::close(dirFd);
+	}
+}
+
+#endif
+
+DirectoryCrawler::DirectoryCrawler(size_t aThreads) {
+	for (size_t i = 0; i < aThreads; ++i) {
+		auto& worker = workers.emplace_back(make_unique<Worker>(*this));
+		worker->start();
+	}
+}
+
+DirectoryCrawler::~DirectoryCrawler() {
+	std::deque<DirectoryPtr> pending;
+
+	{
+		std::lock_guard<std::mutex> l(mtx);
+		stopping = true;
+		pending.swap(queue);
+	}
+
+	cond.notify_all();
+	for (const auto& worker: workers) {
+		worker->join();
+	}
+}
+
+DirectoryCrawler::DirectoryPtr DirectoryCrawler::createRoot(const string& aPath) noexcept {
+	return make_shared<Directory>(aPath, nullptr, Util::emptyString);
+}
+
+DirectoryCrawler::DirectoryPtr DirectoryCrawler::addDirectory(const DirectoryPtr& aParent, const Entry& aEntry) noexcept {
+	dcassert(aEntry.directory);
+	auto directory = make_shared<Directory>(aParent->path + aEntry.name + PATH_SEPARATOR, aParent, aEntry.name);
+
+	{
+		std::lock_guard<std::mutex> l(mtx);
+		dcassert(lastRead.lock() == aParent && !aParent->childrenAdded);
+		aParent->unlistedChildren++;
+
+		if (workers.empty() || prefetchedCount >= MAX_PREFETCHED_DIRECTORIES) {
+			// Will be listed by the caller
+			return directory;
+		}
+
+		directory->crawler = this;
+		prefetchedCount++;
+		queue.push_back(directory);
+	}
+
+	cond.notify_one();
+	return directory;
+}
+
+const DirectoryCrawler::EntryList& DirectoryCrawler::getEntries(const DirectoryPtr& aDirectory) {
+	auto listed = false;
+
+	{
+		std::unique_lock<std::mutex> l(mtx);
+		if (aDirectory->crawler) {
+			aDirectory->crawler = nullptr;
+			prefetchedCount--;
+		}
+
+		// All subdirectories of the previous directory have been added
+		if (auto previous = lastRead.lock()) {
+			setChildrenAdded(*previous);
+		}
+
+		lastRead = aDirectory;
+
+		if (aDirectory->state == Directory::State::LISTING) {
+			cond.wait(l, [&] { return aDirectory->state == Directory::State::LISTED; });
+		}
+
+		listed = aDirectory->state == Directory::State::LISTED;
+		if (!listed) {
+			// Not picked up by the workers yet
+			aDirectory->state = Directory::State::LISTING;
+		}
+	}
+
+	if (!listed) {
+		aDirectory->list();
+		onListed(*aDirectory);
+	}
+
+	if (!aDirectory->error.empty()) {
+		throw FileException(aDirectory->error, aDirectory->errorCode);
+	}
+
+	return aDirectory->entries;
+}
+
+bool DirectoryCrawler::isResourceError(const FileException& aException) noexcept {
+#ifdef _WIN32
+	return false;
+#else
+	auto code = aException.getErrorCode();
+	return code == EMFILE || code == ENFILE || code == ENOMEM;
+#endif
+}
+
+void DirectoryCrawler::onListed(Directory& aDirectory) noexcept {
+	{
+		std::lock_guard<std::mutex> l(mtx);
+		aDirectory.state = Directory::State::LISTED;
+		releaseParent(aDirectory);
+	}
+
+	cond.notify_all();
+}
+
+void DirectoryCrawler::releaseParent(Directory& aDirectory) noexcept {
+	if (!aDirectory.parent) {
+		return;
+	}
+
+	auto& parent = *aDirectory.parent;
+	dcassert(parent.unlistedChildren > 0);
+	parent.unlistedChildren--;
+	if (parent.childrenAdded && parent.unlistedChildren == 0) {
+		parent.closeHandle();
+	}
+
+	aDirectory.parent = nullptr;
+}
+
+void DirectoryCrawler::setChildrenAdded(Directory& aDirectory) noexcept {
+	aDirectory.childrenAdded = true;
+	if (aDirectory.unlistedChildren == 0) {
+		aDirectory.closeHandle();
+	}
+}
+
+void DirectoryCrawler::removePrefetched(Directory& aDirectory) noexcept {
+	std::lock_guard<std::mutex> l(mtx);
+	if (aDirectory.crawler) {
+		aDirectory.crawler = nullptr;
+		prefetchedCount--;
+	}
+}
+
+DirectoryCrawler::DirectoryPtr DirectoryCrawler::getNextDirectory() noexcept {
+	std::unique_lock<std::mutex> l(mtx);
+	for (;;) {
+		cond.wait(l, [this] { return stopping || !queue.empty(); });
+		if (stopping) {
+			return nullptr;
+		}
+
+		auto directory = std::move(queue.front());
+		queue.pop_front();
+
+		// Skip directories that are being listed by the caller
+		dcassert(directory->state == Directory::State::QUEUED || !directory->crawler);
+		if (directory->state == Directory::State::QUEUED) {
+			directory->state = Directory::State::LISTING;
+			return directory;
+		}
+	}
+}
+
+int DirectoryCrawler::Worker::run() {
+	while (auto directory = crawler.getNextDirectory()) {
+		directory->list();
+		crawler.onListed(*directory);
+	}
+
+	return 0;
+}
+
+} // namespace dcpp
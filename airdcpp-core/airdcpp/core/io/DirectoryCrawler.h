@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef DCPLUSPLUS_DCPP_DIRECTORY_CRAWLER_H
+#define DCPLUSPLUS_DCPP_DIRECTORY_CRAWLER_H
+
+#include <airdcpp/core/header/typedefs.h>
+#include <airdcpp/core/classes/Exception.h>
+#include <airdcpp/core/io/File.h>
+#include <airdcpp/core/thread/Thread.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+namespace dcpp {
+
+/**
+ * Lists directories of a tree in parallel
+ * 
+ * The caller walks the tree in its own order and queues the subdirectories that it's going to read next.
+ * Worker threads list the queued directories ahead of the caller, and the caller lists the directories 
+ * that haven't been picked up by the workers yet by itself.
+ * 
+ * On POSIX systems the items are read with syscalls relative to the directory handles so that the full path
+ * doesn't need to be resolved for every item. The number of directory handles that are kept open is limited 
+ * per process (directories will be opened by their full path after that).
+ */
+class DirectoryCrawler {
+public:
+	struct Entry : public FileItemInfoBase {
+		string name;
+		int64_t size = -1;
+		time_t lastWrite = 0;
+		bool directory = false;
+		bool hidden = false;
+		bool link = false;
+
+		bool isDirectory() const noexcept override { return directory; }
+		bool isHidden() const noexcept override { return hidden; }
+		bool isLink() const noexcept override { return link; }
+		int64_t getSize() const noexcept override { return size; }
+		time_t getLastWriteTime() const noexcept override { return lastWrite; }
+	};
+
+	using EntryList = vector<Entry>;
+
+	class Directory {
+	public:
+		Directory(const string& aPath, const shared_ptr<Directory>& aParent, const string& aName) noexcept;
+		~Directory();
+
+		const string& getPath() const noexcept { return path; }
+
+		Directory(const Directory&) = delete;
+		Directory& operator=(const Directory&) = delete;
+	private:
+		friend class DirectoryCrawler;
+
+		enum class State {
+			QUEUED,
+			LISTING,
+			LISTED
+		};
+
+		void list() noexcept;
+		void closeHandle() noexcept;
+
+		const string path;
+		const string name;
+
+		// Cleared after the directory has been listed
+		shared_ptr<Directory> parent;
+
+		State state = State::QUEUED;
+		EntryList entries;
+
+		// Set if the directory couldn't be read
+		string error;
+		int errorCode = 0;
+
+		// Set while the directory is counted as prefetched
+		DirectoryCrawler* crawler = nullptr;
+
+		// Added subdirectories that haven't been listed yet
+		size_t unlistedChildren = 0;
+
+		// No more subdirectories are going to be added
+		bool childrenAdded = false;
+
+#ifndef _WIN32
+		// Kept open until all added subdirectories have been listed
+		int fd = -1;
+#endif
+	};
+
+	using DirectoryPtr = shared_ptr<Directory>;
+
+	// Directories are listed by the calling thread only if aThreads is 0
+	explicit DirectoryCrawler(size_t aThreads);
+	~DirectoryCrawler();
+
+	DirectoryPtr createRoot(const string& aPath) noexcept;
+
+	// Queue a subdirectory of a listed directory to be read in background
+	// Directories should be added in the order in which they are going to be read
+	// Subdirectories may only be added for the directory that was read last
+	DirectoryPtr addDirectory(const DirectoryPtr& aParent, const Entry& aEntry) noexcept;
+
+	// Get the content of the directory, waits for the listing to complete if it's being read by a worker
+	// Throws FileException if the directory can't be read
+	const EntryList& getEntries(const DirectoryPtr& aDirectory);
+
+	// Returns true if the listing failed because of insufficient system resources (e.g. no free file handles) 
+	// rather than because of the directory itself
+	static bool isResourceError(const FileException& aException) noexcept;
+
+	DirectoryCrawler(const DirectoryCrawler&) = delete;
+	DirectoryCrawler& operator=(const DirectoryCrawler&) = delete;
+private:
+	class Worker : public Thread {
+	public:
+		explicit Worker(DirectoryCrawler& aCrawler) : crawler(aCrawler) { }
+	protected:
+		int run() override;
+	private:
+		DirectoryCrawler& crawler;
+	};
+
+	DirectoryPtr getNextDirectory() noexcept;
+	void onListed(Directory& aDirectory) noexcept;
+	void removePrefetched(Directory& aDirectory) noexcept;
+
+	// Called with the lock held
+	static void releaseParent(Directory& aDirectory) noexcept;
+	static void setChildrenAdded(Directory& aDirectory) noexcept;
+
+	std::mutex mtx;
+	std::condition_variable cond;
+
+	std::deque<DirectoryPtr> queue;
+
+	// Directories that have been queued but not read by the caller yet (limits the memory usage)
+	size_t prefetchedCount = 0;
+	bool stopping = false;
+
+	// Subdirectories can't be added for other directories after the next one has been read
+	weak_ptr<Directory> lastRead;
+
+	vector<unique_ptr<Worker>> workers;
+};
+
+} // namespace dcpp
+
+#endif // !defined(DCPLUSPLUS_DCPP_DIRECTORY_CRAWLER_H)
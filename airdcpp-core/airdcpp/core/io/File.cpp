@@ -37,7 +37,11 @@
 #include <utime.h>
 #endif
 
-#ifdef F_NOCACHE
+#ifdef __linux__
+#include <sys/sysmacros.h>
+#endif
+
+#if defined(F_NOCACHE) || defined(HAVE_FALLOCATE)
 #include <fcntl.h>
 #endif
 
@@ -210,6 +214,47 @@ void File::setEOF() {
 	}
 }
 
+size_t File::readAt(void* buf, size_t len, int64_t aPos) {
+	OVERLAPPED ov = { 0 };
+	ov.Offset = (DWORD)(aPos & 0xffffffff);
+	ov.OffsetHigh = (DWORD)(aPos >> 32);
+
+	DWORD x;
+	if (!::ReadFile(h, buf, (DWORD)len, &x, &ov)) {
+		auto error = GetLastError();
+		if (error == ERROR_HANDLE_EOF) {
+			return 0;
+		}
+
+		throw FileException(SystemUtil::translateError(error));
+	}
+
+	return x;
+}
+
+size_t File::writeAt(const void* buf, size_t len, int64_t aPos) {
+	OVERLAPPED ov = { 0 };
+	ov.Offset = (DWORD)(aPos & 0xffffffff);
+	ov.OffsetHigh = (DWORD)(aPos >> 32);
+
+	DWORD x;
+	if (!::WriteFile(h, buf, (DWORD)len, &x, &ov)) {
+		throw FileException(SystemUtil::translateError(GetLastError()));
+	}
+
+	dcassert(x == len);
+	return x;
+}
+
+void File::allocate(int64_t aNewSize) {
+	// NTFS allocates the clusters when the end of file is moved
+	FILE_END_OF_FILE_INFO info;
+	info.EndOfFile.QuadPart = aNewSize;
+	if (!::SetFileInformationByHandle(h, FileEndOfFileInfo, &info, sizeof(info))) {
+		throw FileException(SystemUtil::translateError(GetLastError()));
+	}
+}
+
 string File::getRealPath() const {
 	TCHAR buf[UNC_MAX_PATH];
 	auto ret = GetFinalPathNameByHandle(h, buf, UNC_MAX_PATH, FILE_NAME_OPENED);
@@ -341,6 +386,11 @@ int64_t File::getDeviceId(const string& aPath) noexcept {
 	return ret > 0 ? dwSerialNumber : -1;
 }
 
+bool File::isSolidStateDevice(int64_t /*aDeviceId*/) noexcept {
+	// Volume serial numbers can't be mapped to physical disks without additional queries
+	return false;
+}
+
 string File::getMountPath(const string& aPath) noexcept {
 	unique_ptr<TCHAR[]> buf(new TCHAR[aPath.length()+1]);
 	GetVolumePathName(Text::toT(PathUtil::formatPath(aPath)).c_str(), buf.get(), aPath.length());
@@ -511,6 +561,59 @@ size_t File::write(const void* buf, size_t len) {
 	return len;
 }
 
+size_t File::readAt(void* buf, size_t len, int64_t aPos) {
+	ssize_t result;
+	do {
+		result = ::pread(h, buf, len, (off_t)aPos);
+	} while (result == -1 && errno == EINTR);
+
+	if (result == -1) {
+		throw FileException(SystemUtil::translateError(errno));
+	}
+
+	return (size_t)result;
+}
+
+size_t File::writeAt(const void* buf, size_t len, int64_t aPos) {
+	ssize_t result;
+	char* pointer = (char*)buf;
+	ssize_t left = len;
+	off_t pos = (off_t)aPos;
+
+	while (left > 0) {
+		result = ::pwrite(h, pointer, left, pos);
+		if (result == -1) {
+			if (errno != EINTR) {
+				throw FileException(SystemUtil::translateError(errno));
+			}
+		} else {
+			pointer += result;
+			left -= result;
+			pos += result;
+		}
+	}
+	return len;
+}
+
+void File::allocate(int64_t aNewSize) {
+#ifdef HAVE_FALLOCATE
+	if (getSize() < aNewSize) {
+		// Unlike posix_fallocate, this won't fall back to writing zeros when the file system doesn't support it
+		if (::fallocate(h, 0, 0, (off_t)aNewSize) == 0) {
+			return;
+		}
+
+		if (errno != EOPNOTSUPP && errno != ENOSYS) {
+			throw FileException(SystemUtil::translateError(errno));
+		}
+	}
+#endif
+
+	if (ftruncate(h, (off_t)aNewSize) == -1) {
+		throw FileException(SystemUtil::translateError(errno));
+	}
+}
+
 // some ftruncate implementations can't extend files like SetEndOfFile,
 // not sure if the client code needs this...
 int File::extendFile(int64_t len) noexcept {
@@ -669,6 +772,28 @@ int64_t File::getDeviceId(const string& aPath) noexcept {
 	return (int64_t)statbuf.st_dev;
 }
 
+bool File::isSolidStateDevice(int64_t aDeviceId) noexcept {
+#ifdef __linux__
+	if (aDeviceId < 0) {
+		return false;
+	}
+
+	auto dev = static_cast<dev_t>(aDeviceId);
+	auto devicePath = "/sys/dev/block/" + Util::toString(major(dev)) + ":" + Util::toString(minor(dev));
+
+	// Partitions don't have a queue directory, use the one from the parent disk
+	for (const auto& path: { devicePath + "/queue/rotational", devicePath + "/../queue/rotational" }) {
+		try {
+			return Util::toInt(File(path, File::READ, File::OPEN).read()) == 0;
+		} catch (const FileException&) {
+			// Try the next path
+		}
+	}
+#endif
+
+	return false;
+}
+
 time_t File::getLastModified(const string& aPath) noexcept {
 	struct stat statbuf;
 	if (stat(aPath.c_str(), &statbuf) == -1) {
@@ -125,6 +125,15 @@ public:
 	size_t read(void* buf, size_t& len) override;
 	size_t write(const void* buf, size_t len) override;
 
+	// Positional I/O that doesn't depend on the current file position
+	// The same handle may be used from multiple threads concurrently
+	size_t readAt(void* buf, size_t len, int64_t aPos);
+	size_t writeAt(const void* buf, size_t len, int64_t aPos);
+
+	// Same as setSize but reserves disk space for the whole file when the file system supports it
+	// The file position isn't used
+	void allocate(int64_t aNewSize);
+
 	// This has no effect if aForce is false
 	// Generally the operating system should decide when the buffered data is written on disk
 	size_t flushBuffers(bool aForce = true) override;
@@ -169,6 +178,9 @@ public:
 	static string getMountPath(const string& aPath) noexcept;
 	static int64_t getDeviceId(const string& aPath) noexcept;
 
+	// Returns false if the device is rotational or the type can't be detected
+	static bool isSolidStateDevice(int64_t aDeviceId) noexcept;
+
 	// Parse mount point from the supplied volumes (avoids disk access)
 	static string getMountPath(const string& aPath, const VolumeSet& aVolumes, bool aIgnoreNetworkPaths) noexcept;
 
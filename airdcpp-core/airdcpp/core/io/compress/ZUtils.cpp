@@ -25,78 +25,145 @@
 #include <airdcpp/core/classes/ScopedFunctor.h>
 #include <airdcpp/settings/SettingsManager.h>
 
+#include <chrono>
+#include <thread>
+
 namespace dcpp {
 
 using std::max;
 
 const double ZFilter::MIN_COMPRESSION_LEVEL = 0.9;
 
-ZFilter::ZFilter() : totalIn(0), totalOut(0), compressing(true) {
+atomic<int> ZFilter::activeCompressors = 0;
+
+ZFilter::ZFilter() : maxLevel(SETTING(MAX_COMPRESSION)) {
 	memset(&zs, 0, sizeof(zs));
 
-	if(deflateInit(&zs, SETTING(MAX_COMPRESSION)) != Z_OK) {
+	targetLevel = getAdaptiveLevel();
+	if(deflateInit(&zs, targetLevel) != Z_OK) {
 		throw Exception(STRING(COMPRESSION_ERROR));
 	}
+
+	level = targetLevel;
+	if (level > 0) {
+		activeCompressors++;
+	}
 }
 
 ZFilter::~ZFilter() {
-	dcdebug("ZFilter end, %ld/%ld = %.04f\n", zs.total_out, zs.total_in, (float)zs.total_out / max((float)zs.total_in, (float)1));
+	dcdebug("ZFilter end, %ld/%ld = %.04f (%lld ms)\n", zs.total_out, zs.total_in, (float)zs.total_out / max((float)zs.total_in, (float)1), static_cast<long long>(compressionTime / 1000));
+	if (level > 0) {
+		activeCompressors--;
+	}
+
 	deflateEnd(&zs);
 }
 
+int ZFilter::getAdaptiveLevel() const noexcept {
+	if (maxLevel <= 1) {
+		return maxLevel;
+	}
+
+	// Use lighter levels when other streams are already keeping the cores busy
+	auto cores = static_cast<int>(max(thread::hardware_concurrency(), 1U));
+	auto others = activeCompressors - (level > 0 ? 1 : 0);
+	if (others < cores) {
+		return maxLevel;
+	} else if (others < cores * 2) {
+		return min(maxLevel, 3);
+	}
+
+	return 1;
+}
+
+void ZFilter::setTargetLevel(int aLevel) noexcept {
+	if (aLevel != targetLevel) {
+		dcdebug("ZFilter: changing compression level from %d to %d (%lld bytes compressed)\n", targetLevel, aLevel, static_cast<long long>(totalIn));
+		targetLevel = aLevel;
+	}
+}
+
+void ZFilter::onSampleCompleted() noexcept {
+	auto sampleIn = totalIn - sampleStartIn;
+	auto sampleOut = totalOut - sampleStartOut;
+
+	sampleStartIn = totalIn;
+	sampleStartOut = totalOut;
+
+	if (targetLevel > 0) {
+		// Check if there's any use compressing; if not, save some cpu...
+		if ((static_cast<double>(sampleOut) / sampleIn) > MIN_COMPRESSION_LEVEL) {
+			setTargetLevel(0);
+
+			// Probe less often with data that doesn't compress
+			nextProbe = totalIn + probeInterval;
+			probeInterval = min(probeInterval * 2, MAX_PROBE_INTERVAL);
+		} else {
+			probeInterval = MIN_PROBE_INTERVAL;
+			setTargetLevel(getAdaptiveLevel());
+		}
+	} else if (maxLevel > 0 && totalIn >= nextProbe) {
+		// Compress the next sample to see whether the content has changed
+		setTargetLevel(getAdaptiveLevel());
+	}
+}
+
 bool ZFilter::operator()(const void* in, size_t& insize, void* out, size_t& outsize) {
 	if(outsize == 0)
 		return false;
 
 	zs.next_in = (Bytef*)in;
 	zs.next_out = (Bytef*)out;
+	zs.avail_in = 0;
+	zs.avail_out = outsize;
 
-	// Check if there's any use compressing; if not, save some cpu...
-	if(compressing && insize > 0 && outsize > 16 && (totalIn > (64*1024)) && ((static_cast<double>(totalOut) / totalIn) > 0.95)) {
-		zs.avail_in = 0;
-		zs.avail_out = outsize;
-		auto err = ::deflateParams(&zs, 0, Z_DEFAULT_STRATEGY);
-		if (err == Z_STREAM_ERROR) {
-			throw Exception(STRING(COMPRESSION_ERROR));
+	if (insize > 0) {
+		if (totalIn - sampleStartIn >= SAMPLE_SIZE) {
+			onSampleCompleted();
 		}
-		zs.avail_in = insize;
-		compressing = false;
-		dcdebug("Dynamically disabled compression\n");
-
-		// Check if we ate all space already...
-		if (zs.avail_out == 0) {
-			outsize = outsize - zs.avail_out;
-			insize = insize - zs.avail_in;
-			totalOut += outsize;
-			totalIn += insize;
-			return true;
+
+		if (level != targetLevel) {
+			// The pending data is flushed with the old parameters, which may not fit in the buffer
+			// (Z_BUF_ERROR, the level won't be changed before there is more space)
+			auto err = ::deflateParams(&zs, targetLevel, Z_DEFAULT_STRATEGY);
+			if (err == Z_OK) {
+				if ((level > 0) != (targetLevel > 0)) {
+					activeCompressors += targetLevel > 0 ? 1 : -1;
+				}
+
+				level = targetLevel;
+
+				// Don't count the flushed data in the new sample
+				sampleStartIn = totalIn;
+				sampleStartOut = totalOut + static_cast<int64_t>(outsize - zs.avail_out);
+			} else if (err != Z_BUF_ERROR) {
+				throw Exception(STRING(COMPRESSION_ERROR));
+			}
+
+			// Check if we ate all space already...
+			if (zs.avail_out == 0) {
+				insize = 0;
+				totalOut += outsize;
+				return true;
+			}
 		}
-	} else {
-		zs.avail_in = insize;
-		zs.avail_out = outsize;
 	}
 
-	if(insize == 0) {
-		int err = ::deflate(&zs, Z_FINISH);
-		if(err != Z_OK && err != Z_STREAM_END)
-			throw Exception(STRING(COMPRESSION_ERROR));
-
-		outsize = outsize - zs.avail_out;
-		insize = insize - zs.avail_in;
-		totalOut += outsize;
-		totalIn += insize;
-		return err == Z_OK;
-	} else {
-		int err = ::deflate(&zs, Z_NO_FLUSH);
-		if(err != Z_OK)
-			throw Exception(STRING(COMPRESSION_ERROR));
-
-		outsize = outsize - zs.avail_out;
-		insize = insize - zs.avail_in;
-		totalOut += outsize;
-		totalIn += insize;
-		return true;
-	}
+	auto finishing = insize == 0;
+	zs.avail_in = insize;
+
+	auto start = chrono::steady_clock::now();
+	int err = ::deflate(&zs, finishing ? Z_FINISH : Z_NO_FLUSH);
+	compressionTime += chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+
+	if (finishing ? (err != Z_OK && err != Z_STREAM_END) : err != Z_OK)
+		throw Exception(STRING(COMPRESSION_ERROR));
+
+	outsize = outsize - zs.avail_out;
+	insize = insize - zs.avail_in;
+	totalOut += outsize;
+	totalIn += insize;
+	return finishing ? err == Z_OK : true;
 }
 
 UnZFilter::UnZFilter() {
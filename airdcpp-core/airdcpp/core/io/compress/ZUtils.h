@@ -19,6 +19,7 @@
 #ifndef DCPLUSPLUS_DCPP_Z_UTILS_H
 #define DCPLUSPLUS_DCPP_Z_UTILS_H
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <string>
@@ -29,9 +30,16 @@ namespace dcpp {
 
 using std::string;
 
+/**
+ * Compressibility is sampled for each SAMPLE_SIZE block of input. Compression is turned off for 
+ * blocks that don't compress well and probed again later (the level is changed with deflateParams 
+ * so the stream stays valid for UnZFilter).
+ * 
+ * The compression level depends on the number of concurrently compressing streams.
+ */
 class ZFilter {
 public:
-	/** Compression will automatically be turned off if below this... */
+	/** Compression will automatically be turned off if the ratio of a sampled block is above this... */
 	static const double MIN_COMPRESSION_LEVEL;
 
 	ZFilter();
@@ -45,11 +53,41 @@ public:
 	 * @return True if there's more processing to be done
 	 */
 	bool operator()(const void* in, size_t& insize, void* out, size_t& outsize);
+
+	// Statistics, safe to call from other threads
+	int64_t getTotalIn() const noexcept { return totalIn; }
+	int64_t getTotalOut() const noexcept { return totalOut; }
+
+	// Time spent compressing (microseconds)
+	int64_t getCompressionTime() const noexcept { return compressionTime; }
+	int getLevel() const noexcept { return level; }
 private:
+	// deflate buffers data internally so the samples must be large enough to get a reliable ratio
+	static constexpr int64_t SAMPLE_SIZE = 1024 * 1024;
+	static constexpr int64_t MIN_PROBE_INTERVAL = 4 * 1024 * 1024;
+	static constexpr int64_t MAX_PROBE_INTERVAL = 16 * 1024 * 1024;
+
+	// Number of streams that are currently compressing
+	static std::atomic<int> activeCompressors;
+	int getAdaptiveLevel() const noexcept;
+
+	void onSampleCompleted() noexcept;
+	void setTargetLevel(int aLevel) noexcept;
+
 	z_stream zs;
-	int64_t totalIn;
-	int64_t totalOut;
-	bool compressing;
+	std::atomic<int64_t> totalIn = 0;
+	std::atomic<int64_t> totalOut = 0;
+	std::atomic<int64_t> compressionTime = 0;
+	std::atomic<int> level = 0;
+
+	const int maxLevel;
+	int targetLevel;
+
+	int64_t sampleStartIn = 0;
+	int64_t sampleStartOut = 0;
+
+	int64_t nextProbe = 0;
+	int64_t probeInterval = MIN_PROBE_INTERVAL;
 };
 
 class UnZFilter {
@@ -34,6 +34,8 @@ class DbSnapshot {
 
 };
 
+using DbEntryList = std::vector<std::pair<string, string>>;
+
 // Most methods throw DbException in case of errors
 class DbHandler : boost::noncopyable {
 public:
@@ -46,12 +48,23 @@ public:
 	virtual bool get(void* key, size_t keyLen, size_t initialValueLen, std::function<bool(void* aValue, size_t aValueLen)> loadF, DbSnapshot* aSnapshot = nullptr) = 0;
 	virtual void remove(void* aKey, size_t keyLen, DbSnapshot* aSnapshot = nullptr) = 0;
 
+	// Write multiple entries at once (handlers that support it will commit them atomically with a single sync)
+	virtual void putBatch(const DbEntryList& aEntries) {
+		for (const auto& [key, value] : aEntries) {
+			put((void*)key.data(), key.size(), (void*)value.data(), value.size());
+		}
+	}
+
 	virtual bool hasKey(void* key, size_t keyLen, DbSnapshot* aSnapshot = nullptr) = 0;
 
 	virtual size_t size(bool thorough, DbSnapshot* aSnapshot = nullptr) = 0;
 	virtual int64_t getSizeOnDisk() = 0;
 
 	virtual void remove_if(std::function<bool(void* aKey, size_t keyLen, void* aValue, size_t valueLen)> f, DbSnapshot* aSnapshot = nullptr) = 0;
+
+	// Call the function for each entry with a key starting with aPrefix (in key order)
+	// Keys having aSeparator after the prefix are skipped (the handler should jump over those ranges instead of reading them)
+	virtual void forEachPrefixed(const string& aPrefix, char aSeparator, std::function<void(void* aKey, size_t keyLen, void* aValue, size_t valueLen)> f) = 0;
 	virtual void compact() {}
 
 	virtual string getStats() { return "Not supported"; }
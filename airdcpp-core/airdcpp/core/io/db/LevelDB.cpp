@@ -129,6 +129,8 @@ LevelDB::~LevelDB() {
 
 void LevelDB::put(void* aKey, size_t keyLen, void* aValue, size_t valueLen, DbSnapshot* /*aSnapshot*/ /*nullptr*/) {
 	totalWrites++;
+	syncedWrites++;
+	userBytesWritten += keyLen + valueLen;
 	leveldb::Slice key((const char*)aKey, keyLen);
 	leveldb::Slice value((const char*)aValue, valueLen);
 
@@ -136,6 +138,24 @@ void LevelDB::put(void* aKey, size_t keyLen, void* aValue, size_t valueLen, DbSn
 	DBACTION(db->Put(writeoptions, key, value));
 }
 
+void LevelDB::putBatch(const DbEntryList& aEntries) {
+	if (aEntries.empty()) {
+		return;
+	}
+
+	leveldb::WriteBatch wb;
+	for (const auto& [key, value] : aEntries) {
+		wb.Put(key, value);
+		userBytesWritten += key.size() + value.size();
+	}
+
+	totalWrites += aEntries.size();
+	syncedWrites++;
+
+	// All entries are committed with a single log write and sync
+	DBACTION(db->Write(writeoptions, &wb));
+}
+
 bool LevelDB::get(void* aKey, size_t keyLen, size_t /*initialValueLen*/, std::function<bool(void* aValue, size_t aValueLen)> loadF, DbSnapshot* /*aSnapshot*/ /*nullptr*/) {
 	totalReads++;
 	string value;
@@ -158,6 +178,14 @@ string LevelDB::getStats() {
 	ret += "\r\n\r\nTotal entries: " + Util::toString(size(true, nullptr));
 	ret += "\r\nTotal reads: " + Util::toString(totalReads);
 	ret += "\r\nTotal Writes: " + Util::toString(totalWrites);
+	ret += "\r\nSynced writes: " + Util::toString(syncedWrites);
+	if (syncedWrites > 0) {
+		ret += " (" + Util::toString(static_cast<double>(totalWrites) / static_cast<double>(syncedWrites)) + " entries per sync)";
+	}
+
+	// Compaction writes are listed in the leveldb.stats table above
+	ret += "\r\nData written: " + Util::formatBytes(static_cast<int64_t>(userBytesWritten));
+
 	ret += "\r\nI/O errors: " + Util::toString(ioErrors);
 	ret += "\r\nCurrent block size: " + Util::formatBytes(defaultOptions.block_size);
 	ret += "\r\nCurrent size on disk: " + Util::formatBytes(getSizeOnDisk());
@@ -228,6 +256,36 @@ void LevelDB::remove_if(std::function<bool(void* aKey, size_t key_len, void* aVa
 	DBACTION(db->Write(writeoptions, &wb));
 }
 
+void LevelDB::forEachPrefixed(const string& aPrefix, char aSeparator, std::function<void(void* aKey, size_t keyLen, void* aValue, size_t valueLen)> f) {
+	totalReads++;
+
+	auto it = unique_ptr<leveldb::Iterator>(db->NewIterator(readoptions));
+	for (it->Seek(aPrefix); it->Valid();) {
+		checkDbError(it->status());
+
+		auto key = it->key();
+		if (key.size() < aPrefix.size() || memcmp(key.data(), aPrefix.data(), aPrefix.size()) != 0) {
+			break;
+		}
+
+		string_view suffix(key.data() + aPrefix.size(), key.size() - aPrefix.size());
+		auto separatorPos = suffix.find(aSeparator);
+		if (separatorPos != string_view::npos) {
+			// Keys are sorted bytewise, jump past everything starting with "prefix + suffix + separator"
+			string next = aPrefix;
+			next.append(suffix.data(), separatorPos);
+			next += static_cast<char>(aSeparator + 1);
+			it->Seek(next);
+			continue;
+		}
+
+		f((void*)key.data(), key.size(), (void*)it->value().data(), it->value().size());
+		it->Next();
+	}
+
+	checkDbError(it->status());
+}
+
 // free up some space, https://code.google.com/p/leveldb/issues/detail?id=158
 // LevelDB will perform some kind of compaction on every startup but it's not as comprehensive as manual one
 // The issue has been "fixed" in version 1.13 but it still won't match the manual one (possibly because only ranges that are iterated
@@ -39,6 +39,7 @@ public:
 	void put(void* aKey, size_t keyLen, void* aValue, size_t valueLen, DbSnapshot* aSnapshot /*nullptr*/);
 	bool get(void* aKey, size_t keyLen, size_t /*initialValueLen*/, std::function<bool(void* aValue, size_t aValueLen)> loadF, DbSnapshot* aSnapshot /*nullptr*/);
 	void remove(void* aKey, size_t keyLen, DbSnapshot* aSnapshot /*nullptr*/);
+	void putBatch(const DbEntryList& aEntries) override;
 	bool hasKey(void* aKey, size_t keyLen, DbSnapshot* aSnapshot /*nullptr*/);
 
 	string getStats();
@@ -47,6 +48,7 @@ public:
 	int64_t getSizeOnDisk();
 
 	void remove_if(std::function<bool(void* aKey, size_t key_len, void* aValue, size_t valueLen)> f, DbSnapshot* aSnapshot /*nullptr*/);
+	void forEachPrefixed(const string& aPrefix, char aSeparator, std::function<void(void* aKey, size_t keyLen, void* aValue, size_t valueLen)> f) override;
 	void compact();
 	void repair(StepFunction stepF, MessageFunction messageF);
 	void open(StepFunction stepF, MessageFunction messageF);
@@ -85,6 +87,8 @@ private:
 
 	uint64_t totalReads = 0;
 	uint64_t totalWrites = 0;
+	uint64_t syncedWrites = 0;
+	uint64_t userBytesWritten = 0;
 	uint64_t ioErrors = 0;
 	size_t lastSize = 0;
 };
@@ -0,0 +1,193 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "stdinc.h"
+
+#include <airdcpp/core/io/stream/AsyncOutputStream.h>
+
+// Maximum number of buffers to write before giving other streams a chance to run
+#define MAX_WRITE_BATCH 16
+
+namespace dcpp {
+
+StreamWriterPool::StreamWriterPool(size_t aThreads) {
+	for (size_t i = 0; i < aThreads; ++i) {
+		auto& worker = workers.emplace_back(make_unique<Worker>(*this));
+		worker->start();
+	}
+}
+
+StreamWriterPool::~StreamWriterPool() {
+	{
+		std::lock_guard<std::mutex> l(mtx);
+		stopping = true;
+	}
+
+	cond.notify_all();
+	for (const auto& worker: workers) {
+		worker->join();
+	}
+}
+
+void StreamWriterPool::schedule(AsyncOutputStream* aStream) noexcept {
+	{
+		std::lock_guard<std::mutex> l(mtx);
+		if (!stopping) {
+			streams.push_back(aStream);
+			cond.notify_one();
+			return;
+		}
+	}
+
+	// Shutting down
+	aStream->processQueue();
+}
+
+AsyncOutputStream* StreamWriterPool::getNextStream() noexcept {
+	std::unique_lock<std::mutex> l(mtx);
+	cond.wait(l, [this] { return stopping || !streams.empty(); });
+
+	// Finish the pending writes before exiting
+	if (streams.empty()) {
+		return nullptr;
+	}
+
+	auto stream = streams.front();
+	streams.pop_front();
+	return stream;
+}
+
+int StreamWriterPool::Worker::run() {
+	while (auto stream = pool.getNextStream()) {
+		stream->processQueue();
+	}
+
+	return 0;
+}
+
+
+AsyncOutputStream::AsyncOutputStream(OutputStream* aStream, StreamWriterPool& aPool, size_t aMaxQueuedBytes) : s(aStream), pool(aPool), maxQueuedBytes(aMaxQueuedBytes) {
+
+}
+
+AsyncOutputStream::~AsyncOutputStream() {
+	// The pool may not access the stream after this
+	std::unique_lock<std::mutex> l(mtx);
+	waitIdle(l);
+}
+
+size_t AsyncOutputStream::write(const void* aBuf, size_t aLen) {
+	std::unique_lock<std::mutex> l(mtx);
+
+	// Backpressure (allow a single buffer that exceeds the limit)
+	cond.wait(l, [&] { return error || queuedBytes == 0 || queuedBytes + aLen <= maxQueuedBytes; });
+	checkError();
+
+	auto buf = static_cast<const uint8_t*>(aBuf);
+	queue.emplace_back(buf, buf + aLen);
+	queuedBytes += aLen;
+
+	if (!scheduled) {
+		scheduled = true;
+		l.unlock();
+		pool.schedule(this);
+	}
+
+	return aLen;
+}
+
+void AsyncOutputStream::processQueue() noexcept {
+	for (auto i = 0; i < MAX_WRITE_BATCH; ++i) {
+		ByteVector buf;
+
+		{
+			std::lock_guard<std::mutex> l(mtx);
+			if (queue.empty()) {
+				scheduled = false;
+				cond.notify_all();
+				return;
+			}
+
+			buf = std::move(queue.front());
+			queue.pop_front();
+		}
+
+		try {
+			s->write(buf.data(), buf.size());
+		} catch (const Exception& e) {
+			std::lock_guard<std::mutex> l(mtx);
+
+			// Discard the remaining data
+			error = make_unique<Exception>(e.getError(), e.getErrorCode());
+			queue.clear();
+			queuedBytes = 0;
+			scheduled = false;
+			cond.notify_all();
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> l(mtx);
+			queuedBytes -= buf.size();
+			writtenBytes += buf.size();
+		}
+
+		cond.notify_all();
+	}
+
+	// Continue after the other streams
+	pool.schedule(this);
+}
+
+void AsyncOutputStream::waitIdle(std::unique_lock<std::mutex>& aLock) noexcept {
+	cond.wait(aLock, [this] { return !scheduled; });
+}
+
+void AsyncOutputStream::checkError() const {
+	if (error) {
+		throw Exception(error->getError(), error->getErrorCode());
+	}
+}
+
+void AsyncOutputStream::waitPending() {
+	std::unique_lock<std::mutex> l(mtx);
+	waitIdle(l);
+	checkError();
+}
+
+int64_t AsyncOutputStream::getWrittenBytes() const noexcept {
+	std::lock_guard<std::mutex> l(mtx);
+	return writtenBytes;
+}
+
+size_t AsyncOutputStream::flushBuffers(bool aForce) {
+	waitPending();
+	return s->flushBuffers(aForce);
+}
+
+OutputStream* AsyncOutputStream::releaseRootStream() {
+	{
+		std::unique_lock<std::mutex> l(mtx);
+		waitIdle(l);
+	}
+
+	auto as = s.release();
+	return as->releaseRootStream();
+}
+
+} // namespace dcpp
@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef DCPLUSPLUS_DCPP_ASYNC_OUTPUT_STREAM_H
+#define DCPLUSPLUS_DCPP_ASYNC_OUTPUT_STREAM_H
+
+#include <airdcpp/core/classes/Exception.h>
+#include <airdcpp/core/io/stream/StreamBase.h>
+#include <airdcpp/core/thread/Thread.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+namespace dcpp {
+
+class AsyncOutputStream;
+
+// Worker threads that perform the queued writes of asynchronous output streams
+class StreamWriterPool {
+public:
+	explicit StreamWriterPool(size_t aThreads);
+	~StreamWriterPool();
+
+	void schedule(AsyncOutputStream* aStream) noexcept;
+
+	StreamWriterPool(const StreamWriterPool&) = delete;
+	StreamWriterPool& operator=(const StreamWriterPool&) = delete;
+private:
+	class Worker : public Thread {
+	public:
+		explicit Worker(StreamWriterPool& aPool) : pool(aPool) { }
+	protected:
+		int run() override;
+	private:
+		StreamWriterPool& pool;
+	};
+
+	AsyncOutputStream* getNextStream() noexcept;
+
+	std::mutex mtx;
+	std::condition_variable cond;
+	std::deque<AsyncOutputStream*> streams;
+	bool stopping = false;
+
+	vector<unique_ptr<Worker>> workers;
+};
+
+/**
+ * Passes the written data to the worker pool so that the caller won't be blocked by
+ * the processing of the wrapped stream (e.g. hashing and disk writes)
+ *
+ * Data is written in order. The caller is blocked when the amount of queued data exceeds the limit.
+ * Errors from the wrapped stream are thrown from the next call of write, flushBuffers or waitPending.
+ */
+class AsyncOutputStream : public OutputStream {
+public:
+	AsyncOutputStream(OutputStream* aStream, StreamWriterPool& aPool, size_t aMaxQueuedBytes);
+	~AsyncOutputStream() override;
+
+	size_t write(const void* aBuf, size_t aLen) override;
+	size_t flushBuffers(bool aForce) override;
+
+	// Wait until all queued data has been written
+	void waitPending();
+
+	// Bytes successfully passed to the wrapped stream
+	int64_t getWrittenBytes() const noexcept;
+
+	OutputStream* releaseRootStream() override;
+private:
+	friend class StreamWriterPool;
+
+	// Called from the worker pool
+	void processQueue() noexcept;
+
+	void waitIdle(std::unique_lock<std::mutex>& aLock) noexcept;
+	void checkError() const;
+
+	unique_ptr<OutputStream> s;
+	StreamWriterPool& pool;
+	const size_t maxQueuedBytes;
+
+	mutable std::mutex mtx;
+	std::condition_variable cond;
+
+	std::deque<ByteVector> queue;
+	size_t queuedBytes = 0;
+	int64_t writtenBytes = 0;
+
+	// Set while the stream is queued or being processed by the pool
+	bool scheduled = false;
+
+	unique_ptr<Exception> error;
+};
+
+} // namespace dcpp
+
+#endif // !defined(DCPLUSPLUS_DCPP_ASYNC_OUTPUT_STREAM_H)
@@ -221,6 +221,10 @@ public:
 	int64_t getSize() const noexcept override {
 		return f->getSize();
 	}
+
+	const Filter& getFilter() const noexcept {
+		return filter;
+	}
 private:
 	static const size_t BUF_SIZE = 128*1024; //increase buffer from 64
 
@@ -32,7 +32,7 @@ SharedFileStream::SharedFileHandleMap SharedFileStream::readpool;
 SharedFileStream::SharedFileHandleMap SharedFileStream::writepool;
 
 SharedFileHandle::SharedFileHandle(const string& aPath, int aAccess, int aMode) : 
-	File(aPath, aAccess, aMode), ref_cnt(1), path(aPath), mode(aMode)
+	File(aPath, aAccess, aMode), ref_cnt(1), path(aPath), access(aAccess)
 { }
 
 SharedFileStream::SharedFileStream(const string& aFileName, int aAccess, int aMode) {
@@ -53,43 +53,35 @@ SharedFileStream::~SharedFileStream() {
 
 	sfh->ref_cnt--;
 	if(sfh->ref_cnt == 0) {
-		auto& pool = sfh->mode == File::READ ? readpool : writepool;
+		auto& pool = sfh->access == File::READ ? readpool : writepool;
 		pool.erase(sfh->path);
     }
 }
 
 size_t SharedFileStream::write(const void* buf, size_t len) {
-	Lock l(sfh->cs);
-
-	sfh->setPos(pos);
-	sfh->write(buf, len);
+	sfh->writeAt(buf, len, pos);
 
-    pos += len;
+	pos += len;
 	return len;
 }
 
 size_t SharedFileStream::read(void* buf, size_t& len) {
-	Lock l(sfh->cs);
+	len = sfh->readAt(buf, len, pos);
 
-	sfh->setPos(pos);
-	len = sfh->read(buf, len);
-
-    pos += len;
+	pos += len;
 	return len;
 }
 
 int64_t SharedFileStream::getSize() const noexcept {
-	Lock l(sfh->cs);
 	return sfh->getSize();
 }
 
 void SharedFileStream::setSize(int64_t newSize) {
 	Lock l(sfh->cs);
-	sfh->setSize(newSize);
+	sfh->allocate(newSize);
 }
 
 size_t SharedFileStream::flushBuffers(bool aForce) {
-	Lock l(sfh->cs);
 	return sfh->flushBuffers(aForce);
 }
 
@@ -30,10 +30,11 @@ struct SharedFileHandle : File {
 	SharedFileHandle(const string& aPath, int access, int mode);
 	~SharedFileHandle() noexcept = default;
 
+	// Reads and writes use positional I/O, this is only needed when changing the file size
 	CriticalSection cs;
 	int	ref_cnt;
 	string path;
-	int mode;
+	int access;
 };
 
 class SharedFileStream : public IOStream
@@ -45,10 +46,13 @@ public:
     SharedFileStream(const string& aFileName, int access, int mode);
     ~SharedFileStream() override;
 
+	// Each stream has its own position so segments can be read/written concurrently without locking
 	size_t write(const void* buf, size_t len) override;
 	size_t read(void* buf, size_t& len) override;
 
 	int64_t getSize() const noexcept override;
+
+	// Disk space is reserved for the whole file when supported by the file system
 	void setSize(int64_t newSize);
 
 	size_t flushBuffers(bool aForce) override;
@@ -60,7 +64,7 @@ public:
 	void setPos(int64_t aPos) noexcept override;
 private:
 	SharedFileHandle* sfh;
-	int64_t pos;
+	int64_t pos = 0;
 };
 
 }
@@ -24,6 +24,13 @@
 #include <airdcpp/util/text/Text.h>
 #include <airdcpp/core/io/stream/Streams.h>
 
+#include <bit>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define DCPP_XML_SSE2
+#endif
+
 namespace dcpp {
 
 static bool isSpace(int c) {
@@ -34,7 +41,7 @@ static bool inRange(int c, int a, int b) {
 	return c >= a && c <= b;
 }
 
-static bool isNameStartChar(int c) {
+static bool isNameStartCharImpl(int c) {
 	return 	c == ':'
 		|| inRange(c, 'A', 'Z')
 		|| c == '_'
@@ -55,8 +62,8 @@ static bool isNameStartChar(int c) {
 		;
 }
 
-static bool isNameChar(int c) {
-	return isNameStartChar(c)
+static bool isNameCharImpl(int c) {
+	return isNameStartCharImpl(c)
 		|| c == '-'
 		|| c == '.'
 		|| inRange(c, '0', '9')
@@ -67,6 +74,59 @@ static bool isNameChar(int c) {
 		;
 }
 
+enum NameCharType : uint8_t {
+	NAME_START_CHAR = 0x01,
+	NAME_CHAR = 0x02,
+};
+
+// Name characters are checked for each byte of element and attribute names
+static const auto nameCharTable = [] {
+	array<uint8_t, 256> ret{};
+	for (int c = 0; c < 0x80; ++c) {
+		ret[c] = (isNameStartCharImpl(c) ? NAME_START_CHAR : 0) | (isNameCharImpl(c) ? NAME_CHAR : 0);
+	}
+
+	return ret;
+}();
+
+static bool isNameStartChar(int c) {
+	return (nameCharTable[static_cast<uint8_t>(c)] & NAME_START_CHAR) != 0;
+}
+
+static bool isNameChar(int c) {
+	return (nameCharTable[static_cast<uint8_t>(c)] & NAME_CHAR) != 0;
+}
+
+// Returns the position of the first a or b character (or aLen if neither one was found)
+static size_t findFirstOf(const char* aData, size_t aLen, char a, char b) {
+	size_t i = 0;
+#ifdef DCPP_XML_SSE2
+	const auto va = _mm_set1_epi8(a);
+	const auto vb = _mm_set1_epi8(b);
+	for (; i + 16 <= aLen; i += 16) {
+		auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(aData + i));
+		auto mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, va), _mm_cmpeq_epi8(chunk, vb))));
+		if (mask != 0) {
+			return i + std::countr_zero(mask);
+		}
+	}
+#endif
+
+	for (; i < aLen; ++i) {
+		if (aData[i] == a || aData[i] == b) {
+			return i;
+		}
+	}
+
+	return aLen;
+}
+
+// Returns the position of the first character c (or aLen if it wasn't found)
+static size_t findChar(const char* aData, size_t aLen, char c) {
+	auto p = static_cast<const char*>(memchr(aData, c, aLen));
+	return p ? static_cast<size_t>(p - aData) : aLen;
+}
+
 SimpleXMLReader::ThreadedCallBack::ThreadedCallBack(const string& aPath) : xmlPath(aPath) {
 	file.reset(new File(aPath, dcpp::File::READ, dcpp::File::OPEN, File::BUFFER_SEQUENTIAL, false));
 	size = file->getSize();
@@ -91,6 +151,27 @@ SimpleXMLReader::SimpleXMLReader(SimpleXMLReader::CallBack* callback, int aFlags
 	attribs.reserve(16);
 }
 
+StringPair& SimpleXMLReader::addAttrib() {
+	if (spareAttribs.empty()) {
+		return attribs.emplace_back();
+	}
+
+	attribs.push_back(std::move(spareAttribs.back()));
+	spareAttribs.pop_back();
+	return attribs.back();
+}
+
+void SimpleXMLReader::clearAttribs() {
+	// Keep the allocated strings for the following tags
+	for (auto& attrib: attribs) {
+		attrib.first.clear();
+		attrib.second.clear();
+		spareAttribs.push_back(std::move(attrib));
+	}
+
+	attribs.clear();
+}
+
 void SimpleXMLReader::append(std::string& str, size_t maxLen, int c) const {
 	if(str.size() > maxLen) {
 		error("Buffer overflow");
@@ -105,6 +186,16 @@ void SimpleXMLReader::append(std::string& str, size_t maxLen, std::string::const
 	str.append(begin, end);
 }
 
+void SimpleXMLReader::appendChars(std::string& str, size_t maxLen, std::string::const_iterator begin, std::string::const_iterator end) const {
+	// The last character may still be appended when the size is at maxLen
+	if(begin != end && str.size() + (end - begin) - 1 > maxLen) {
+		// Report the position of the first character that didn't fit
+		auto overflowPos = pos + (str.size() > maxLen ? 0 : maxLen + 1 - str.size());
+		throw SimpleXMLException(Util::toString(overflowPos) + ": Buffer overflow");
+	}
+	str.append(begin, end);
+}
+
 /// @todo This is cheating - we should be converting from the encoding, but since we simplify a few things
 /// this is ok
 int SimpleXMLReader::charAt(size_t n) const { return buf[bufPos + n]; }
@@ -196,7 +287,7 @@ bool SimpleXMLReader::elementName() {
 			append(elements.back(), MAX_NAME_SIZE, buf.begin() + bufPos, buf.begin() + bufPos + i);
 
 			cb->startTag(elements.back(), attribs, false);
-			attribs.clear();
+			clearAttribs();
 
 			state = STATE_CONTENT;
 			advancePos(i + 1);
@@ -219,8 +310,7 @@ bool SimpleXMLReader::elementAttr() {
 
 	int c = charAt(0);
 	if(isNameStartChar(c)) {
-		attribs.emplace_back();
-		append(attribs.back().first, MAX_NAME_SIZE, c);
+		append(addAttrib().first, MAX_NAME_SIZE, c);
 
 		state = STATE_ELEMENT_ATTR_NAME;
 		advancePos(1);
@@ -259,28 +349,24 @@ bool SimpleXMLReader::elementAttrName() {
 }
 
 bool SimpleXMLReader::elementAttrValue() {
-	size_t i = 0;
-	for(size_t iend = bufSize(); i < iend; ++i) {
-		int c = charAt(i);
+	const char quote = state == STATE_ELEMENT_ATTR_VALUE_APOS ? '\'' : '"';
+	auto i = findFirstOf(&buf[bufPos], bufSize(), quote, '&');
 
-		if((state == STATE_ELEMENT_ATTR_VALUE_APOS && c == '\'') || (state == STATE_ELEMENT_ATTR_VALUE_QUOT && c == '"')) {
-			append(attribs.back().second, MAX_VALUE_SIZE, buf.begin() + bufPos, buf.begin() + bufPos + i);
-
-			decodeString(attribs.back().second);
+	append(attribs.back().second, MAX_VALUE_SIZE, buf.begin() + bufPos, buf.begin() + bufPos + i);
+	if (i == bufSize()) {
+		advancePos(i);
+		return true;
+	}
 
-			state = STATE_ELEMENT_ATTR;
-			advancePos(i + 1);
-			return true;
-		} else if(c == '&') {
-			append(attribs.back().second, MAX_VALUE_SIZE, buf.begin() + bufPos, buf.begin() + bufPos + i);
-			advancePos(i);
-			return entref(attribs.back().second);
-		}
+	if (charAt(i) == '&') {
+		advancePos(i);
+		return entref(attribs.back().second);
 	}
 
-	append(attribs.back().second, MAX_VALUE_SIZE, buf.begin() + bufPos, buf.begin() + bufPos + i);
-	advancePos(i);
+	decodeString(attribs.back().second);
 
+	state = STATE_ELEMENT_ATTR;
+	advancePos(i + 1);
 	return true;
 }
 
@@ -292,7 +378,7 @@ bool SimpleXMLReader::elementEndSimple() {
 	if(charAt(0) == '>') {
 		cb->startTag(elements.back(), attribs, true);
 		elements.pop_back();
-		attribs.clear();
+		clearAttribs();
 
 		state = STATE_CONTENT;
 		advancePos(1);
@@ -309,7 +395,7 @@ bool SimpleXMLReader::elementEndComplex() {
 
 	if(charAt(0) == '>') {
 		cb->startTag(elements.back(), attribs, false);
-		attribs.clear();
+		clearAttribs();
 
 		state = STATE_CONTENT;
 		advancePos(1);
@@ -390,18 +476,17 @@ bool SimpleXMLReader::declEncodingValue() {
 
 bool SimpleXMLReader::comment() {
 	while(bufSize() > 0) {
-		int c = charAt(0);
+		// Skip until the next possible comment end
+		advancePos(findChar(&buf[bufPos], bufSize(), '-'));
+		if(!needChars(3)) {
+			return true;
+		}
 
 		// TODO We shouldn't allow ---> to end a comment
-		if(c == '-') {
-			if(!needChars(3)) {
-				return true;
-			}
-			if(charAt(1) == '-' && charAt(2) == '>') {
-				state = STATE_CONTENT;
-				advancePos(3);
-				return true;
-			}
+		if(charAt(1) == '-' && charAt(2) == '>') {
+			state = STATE_CONTENT;
+			advancePos(3);
+			return true;
 		}
 
 		advancePos(1);
@@ -412,20 +497,22 @@ bool SimpleXMLReader::comment() {
 
 bool SimpleXMLReader::cdata() {
 	while (bufSize() > 0) {
-		int c = charAt(0);
+		// Everything until the next possible CDATA end is data
+		auto len = findChar(&buf[bufPos], bufSize(), ']');
+		appendChars(value, MAX_VALUE_SIZE, buf.begin() + bufPos, buf.begin() + bufPos + len);
+		advancePos(len);
 
-		if (c == ']') {
-			if (!needChars(3)) {
-				return true;
-			}
-			if (charAt(1) == ']' && charAt(2) == '>') {
-				state = STATE_CONTENT;
-				advancePos(3);
-				return true;
-			}
+		if (!needChars(3)) {
+			return true;
+		}
+
+		if (charAt(1) == ']' && charAt(2) == '>') {
+			state = STATE_CONTENT;
+			advancePos(3);
+			return true;
 		}
 
-		append(value, MAX_VALUE_SIZE, c);
+		append(value, MAX_VALUE_SIZE, ']');
 		advancePos(1);
 	}
 
@@ -507,9 +594,12 @@ bool SimpleXMLReader::content() {
 		return entref(value);
 	}
 
-	append(value, MAX_VALUE_SIZE, c);
+	// Everything until the next markup or entity reference is character data
+	// (the first character may be a lone '<' that didn't start any markup)
+	auto len = 1 + findFirstOf(&buf[bufPos + 1], bufSize() - 1, '<', '&');
+	appendChars(value, MAX_VALUE_SIZE, buf.begin() + bufPos, buf.begin() + bufPos + len);
 
-	advancePos(1);
+	advancePos(len);
 
 	return true;
 }
@@ -83,11 +83,10 @@ public:
 	bool parse(const char* data, size_t len);
 	bool parse(const string& str);
 
-private:
-
 	static const size_t MAX_NAME_SIZE = 1024; 
 	static const size_t MAX_VALUE_SIZE = 96*1024;
 	static const size_t MAX_NESTING = 32;
+private:
 
 	enum ParseState {
 		/// Start of document
@@ -168,6 +167,9 @@ private:
 	uint64_t pos = 0;
 
 	StringPairList attribs;
+
+	// Cleared attributes whose allocated strings can be reused
+	StringPairList spareAttribs;
 	std::string value;
 
 	CallBack* cb;
@@ -177,9 +179,15 @@ private:
 
 	StringList elements;
 
+	StringPair& addAttrib();
+	void clearAttribs();
+
 	void append(std::string& str, size_t maxLen, int c) const;
 	void append(std::string& str, size_t maxLen, std::string::const_iterator begin, std::string::const_iterator end) const;
 
+	// Append a range with the same limit as when appending the characters one by one
+	void appendChars(std::string& str, size_t maxLen, std::string::const_iterator begin, std::string::const_iterator end) const;
+
 	bool needChars(size_t n) const;
 	int charAt(size_t n) const;
 	bool skipSpace(bool store = false);
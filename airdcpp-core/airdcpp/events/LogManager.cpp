@@ -28,6 +28,12 @@
 
 namespace dcpp {
 
+// Maximum number of log files that are kept open at the same time
+constexpr size_t MAX_OPEN_FILES = 16;
+
+// Open log files that haven't been written to during this period are closed
+constexpr uint64_t OPEN_FILE_IDLE_TIMEOUT = 60 * 1000;
+
 LogManager::LogManager() : cache(SettingsManager::LOG_MESSAGE_CACHE), tasks(true, Thread::IDLE) {
 
 	options[UPLOAD][FILE] = SettingsManager::LOG_FILE_UPLOAD;
@@ -42,9 +48,23 @@ LogManager::LogManager() : cache(SettingsManager::LOG_MESSAGE_CACHE), tasks(true
 	options[SYSTEM][FORMAT] = SettingsManager::LOG_FORMAT_SYSTEM;
 	options[STATUS][FILE] = SettingsManager::LOG_FILE_STATUS;
 	options[STATUS][FORMAT] = SettingsManager::LOG_FORMAT_STATUS;
+
+	TimerManager::getInstance()->addListener(this);
 }
 
 LogManager::~LogManager() {
+	TimerManager::getInstance()->removeListener(this);
+
+	// Write the remaining lines
+	tasks.stop();
+	tasks.join();
+	flushPendingWrites();
+}
+
+void LogManager::on(TimerManagerListener::Minute, uint64_t aTick) noexcept {
+	tasks.addTask([aTick, this] {
+		closeIdleFiles(aTick);
+	});
 }
 
 void LogManager::log(Area area, ParamMap& params) noexcept {
@@ -188,17 +208,76 @@ string LogManager::readFromEnd(const string& aPath, int aMaxLines, int64_t aBuff
 }
 
 void LogManager::log(const string& area, const string& msg) noexcept {
-	tasks.addTask([msg, area, this] {
-		auto aArea = PathUtil::validatePath(area);
-		try {
-			File::ensureDirectory(aArea);
-			File f(aArea, File::WRITE, File::OPEN | File::CREATE);
-			f.setEndPos(0);
-			f.write(msg + "\r\n");
-		} catch (const FileException& e) {
-			// Just don't try to write the error into a file...
-			message(STRING_F(WRITE_FAILED_X, aArea % e.what()), LogMessage::SEV_NOTIFY, STRING(APPLICATION));
+	{
+		Lock l(pendingCS);
+		auto& data = pendingWrites[area];
+		data += msg;
+		data += "\r\n";
+
+		if (flushQueued) {
+			// Lines written before the queued task gets executed will be coalesced
+			return;
 		}
+
+		flushQueued = true;
+	}
+
+	tasks.addTask([this] {
+		flushPendingWrites();
+	});
+}
+
+void LogManager::flushPendingWrites() noexcept {
+	unordered_map<string, string> writes;
+
+	{
+		Lock l(pendingCS);
+		writes.swap(pendingWrites);
+		flushQueued = false;
+	}
+
+	for (const auto& [path, data]: writes) {
+		writeFile(path, data);
+	}
+}
+
+void LogManager::writeFile(const string& aPath, const string& aData) noexcept {
+	auto path = PathUtil::validatePath(aPath);
+	try {
+		auto& f = getLogFile(path, GET_TICK());
+
+		// The file may have been modified by someone else
+		f.setEndPos(0);
+		f.write(aData);
+	} catch (const FileException& e) {
+		openFiles.erase(path);
+
+		// Just don't try to write the error into a file...
+		message(STRING_F(WRITE_FAILED_X, path % e.what()), LogMessage::SEV_NOTIFY, STRING(APPLICATION));
+	}
+}
+
+File& LogManager::getLogFile(const string& aPath, uint64_t aTick) {
+	auto i = openFiles.find(aPath);
+	if (i == openFiles.end()) {
+		if (openFiles.size() >= MAX_OPEN_FILES) {
+			// Close the least recently used file
+			auto lru = ranges::min_element(openFiles, {}, [](const auto& aItem) { return aItem.second.lastWrite; });
+			openFiles.erase(lru);
+		}
+
+		File::ensureDirectory(aPath);
+		auto file = make_unique<File>(aPath, File::WRITE, File::OPEN | File::CREATE);
+		i = openFiles.emplace(aPath, LogFile({ std::move(file), aTick })).first;
+	}
+
+	i->second.lastWrite = aTick;
+	return *i->second.file;
+}
+
+void LogManager::closeIdleFiles(uint64_t aTick) noexcept {
+	std::erase_if(openFiles, [aTick](const auto& aItem) {
+		return aItem.second.lastWrite + OPEN_FILE_IDLE_TIMEOUT < aTick;
 	});
 }
 
@@ -31,10 +31,12 @@
 #include <airdcpp/message/MessageCache.h>
 #include <airdcpp/core/Singleton.h>
 #include <airdcpp/core/Speaker.h>
+#include <airdcpp/core/thread/CriticalSection.h>
+#include <airdcpp/core/timer/TimerManagerListener.h>
 
 namespace dcpp {
 
-class LogManager : public Singleton<LogManager>, public Speaker<LogManagerListener>
+class LogManager : public Singleton<LogManager>, public Speaker<LogManagerListener>, private TimerManagerListener
 {
 public:
 	enum Area: uint8_t { CHAT, PM, DOWNLOAD, UPLOAD, SYSTEM, STATUS, LAST };
@@ -67,6 +69,26 @@ private:
 
 	void log(const string& area, const string& msg) noexcept;
 
+	// Lines waiting to be written by the task thread, grouped by path
+	unordered_map<string, string> pendingWrites;
+	bool flushQueued = false;
+	CriticalSection pendingCS;
+
+	struct LogFile {
+		unique_ptr<File> file;
+		uint64_t lastWrite;
+	};
+
+	// Log files kept open for appending (accessed only from the task thread)
+	unordered_map<string, LogFile> openFiles;
+
+	void flushPendingWrites() noexcept;
+	void writeFile(const string& aPath, const string& aData) noexcept;
+	File& getLogFile(const string& aPath, uint64_t aTick);
+	void closeIdleFiles(uint64_t aTick) noexcept;
+
+	void on(TimerManagerListener::Minute, uint64_t aTick) noexcept override;
+
 	friend class Singleton<LogManager>;
 
 	int options[LAST][2];
@@ -21,6 +21,7 @@
 #include <airdcpp/filelist/DirectoryListing.h>
 #include <airdcpp/filelist/DirectoryListingDirectory.h>
 #include <airdcpp/filelist/ListLoader.h>
+#include <airdcpp/filelist/ListSnapshot.h>
 
 #include <airdcpp/core/io/compress/BZUtils.h>
 #include <airdcpp/hub/ClientManager.h>
@@ -239,12 +240,32 @@ void DirectoryListing::loadFile() {
 		string ext = PathUtil::getFileExt(fileName);
 
 		dcpp::File ff(fileName, dcpp::File::READ, dcpp::File::OPEN, dcpp::File::BUFFER_AUTO);
-		root->setLastUpdateDate(ff.getLastModified());
+		auto listDate = ff.getLastModified();
+		auto listSize = ff.getSize();
+		root->setLastUpdateDate(listDate);
+
+		// Snapshots contain the unfiltered content so they can't be used when there are load hooks
+		auto useSnapshot = (!loadHooks || !loadHooks->hasSubscribers()) && listSize >= ListSnapshot::MIN_LIST_SIZE;
+		if (useSnapshot && ListSnapshot::load(*this, fileName, listSize, listDate)) {
+			return;
+		}
+
 		if(Util::stricmp(ext, ".bz2") == 0) {
 			FilteredInputStream<UnBZFilter, false> f(&ff);
-			loadXML(f, false, ADC_ROOT_STR, ff.getLastModified());
+			loadXML(f, false, ADC_ROOT_STR, listDate);
 		} else if(Util::stricmp(ext, ".xml") == 0) {
-			loadXML(ff, false, ADC_ROOT_STR, ff.getLastModified());
+			loadXML(ff, false, ADC_ROOT_STR, listDate);
+		} else {
+			return;
+		}
+
+		if (useSnapshot) {
+			// Write the snapshot only after the list has been opened
+			addAsyncTask([this, listSize, listDate] {
+				if (!closing) {
+					ListSnapshot::save(*this, fileName, listSize, listDate);
+				}
+			});
 		}
 	}
 }
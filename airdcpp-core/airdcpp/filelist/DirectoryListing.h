@@ -55,6 +55,8 @@ public:
 
 	class File;
 	using FilePtr = std::shared_ptr<File>;
+	class FileArray;
+	class NamePool;
 	class VirtualDirectory;
 
 	enum class DirectoryLoadType;
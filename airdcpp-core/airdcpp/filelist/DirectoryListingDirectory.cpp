@@ -43,28 +43,77 @@ bool DirectoryListing::Directory::Sort::operator()(const Ptr& a, const Ptr& b) c
 }
 
 bool DirectoryListing::File::Sort::operator()(const Ptr& a, const Ptr& b) const {
-	return compare(a->getName(), b->getName()) < 0;
+	return compare(string_view(a->name, a->nameLength), string_view(b->name, b->nameLength)) < 0;
+}
+
+string_view DirectoryListing::NamePool::add(string_view aName) noexcept {
+	auto len = aName.size() + 1;
+	if (static_cast<size_t>(end - pos) < len) {
+		// Leave the current block if the name doesn't fit in it
+		auto blockSize = max(nextBlockSize, len);
+		blocks.push_back(make_unique<char[]>(blockSize));
+		allocatedBytes += blockSize;
+
+		pos = blocks.back().get();
+		end = pos + blockSize;
+		nextBlockSize = min(nextBlockSize * 2, MAX_BLOCK_SIZE);
+	}
+
+	auto ret = pos;
+	memcpy(ret, aName.data(), aName.size());
+	ret[aName.size()] = '\0';
+	pos += len;
+	return { ret, aName.size() };
 }
 
-DirectoryListing::File::File(Directory* aDir, const string& aName, int64_t aSize, const TTHValue& aTTH, time_t aRemoteDate) noexcept :
-	name(aName), size(aSize), parent(aDir), tthRoot(aTTH), remoteDate(aRemoteDate), token(itemIdCounter++) {
+DirectoryListing::File::File(string_view aName, int64_t aSize, const TTHValue& aTTH, time_t aRemoteDate, uint32_t aIndex) noexcept :
+	name(aName.data()), nameLength(static_cast<uint32_t>(aName.size())), index(aIndex), size(aSize), tthRoot(aTTH), remoteDate(aRemoteDate) {
 
 	if (size > 0) {
 		dupe = DupeUtil::checkFileDupe(tthRoot);
 	}
+}
 
-	//dcdebug("DirectoryListing::File (copy) %s was created\n", aName.c_str());
+DirectoryListing::File::Ptr DirectoryListing::File::copy(const File& aFile, Owner aOwner) noexcept {
+	const auto& source = aFile.getArray();
+	auto array = FileArray::create(source.getParent(), aOwner, source.getNames(), { { string_view(aFile.name, aFile.nameLength), aFile.size, aFile.tthRoot, aFile.remoteDate } });
+
+	auto f = array->begin();
+	f->setDupe(aFile.dupe);
+
+	dcdebug("DirectoryListing::File (copy) %s was created\n", aFile.getName().c_str());
+	return File::Ptr(array, f);
 }
 
 string DirectoryListing::File::getAdcPathUnsafe() const noexcept {
-	return parent->getAdcPathUnsafe() + name;
+	return getParent()->getAdcPathUnsafe() + getName();
 }
 
-DirectoryListing::File::File(const File& rhs, File::Owner aOwner) noexcept : 
-	name(rhs.name), size(rhs.size), parent(rhs.parent), tthRoot(rhs.tthRoot), 
-	dupe(rhs.dupe), remoteDate(rhs.remoteDate), owner(aOwner), token(itemIdCounter++)
-{
-	dcdebug("DirectoryListing::File (copy) %s was created\n", rhs.getName().c_str());
+DirectoryListing::FileArray::FileArray(Directory* aParent, File::Owner aOwner, const NamePool::Ptr& aNames, uint32_t aCount) noexcept :
+	parent(aParent), owner(aOwner), names(aNames), firstToken(itemIdCounter.fetch_add(aCount)), count(aCount) {
+
+}
+
+DirectoryListing::FileArray::Ptr DirectoryListing::FileArray::create(Directory* aParent, File::Owner aOwner, const NamePool::Ptr& aNames, const ItemList& aItems) noexcept {
+	auto count = static_cast<uint32_t>(aItems.size());
+	auto array = new (::operator new(sizeof(FileArray) + count * sizeof(File))) FileArray(aParent, aOwner, aNames, count);
+	for (uint32_t i = 0; i < count; ++i) {
+		const auto& item = aItems[i];
+		new (array->begin() + i) File(item.name, item.size, item.tth, item.remoteDate, i);
+	}
+
+	return Ptr(array, [](FileArray* aArray) {
+		// The files are trivially destructible
+		aArray->~FileArray();
+		::operator delete(aArray);
+	});
+}
+
+void DirectoryListing::FileArray::toList(const Ptr& aArray, File::List& files_) noexcept {
+	files_.reserve(files_.size() + aArray->size());
+	for (auto f = aArray->begin(); f != aArray->begin() + aArray->size(); ++f) {
+		files_.emplace_back(aArray, f);
+	}
 }
 
 DirectoryListing::Directory::Ptr DirectoryListing::Directory::create(Directory* aParent, const string& aName, DirType aType, time_t aUpdateDate, const DirectoryContentInfo& aContentInfo, const string& aSize, time_t aRemoteDate) {
@@ -112,6 +161,14 @@ DirectoryListing::VirtualDirectory::VirtualDirectory(const string& aFullAdcPath,
 
 }
 
+void DirectoryListing::Directory::addFiles(const NamePool::Ptr& aNames, const FileArray::ItemList& aItems) noexcept {
+	if (aItems.empty()) {
+		return;
+	}
+
+	FileArray::toList(FileArray::create(this, nullptr, aNames, aItems), files);
+}
+
 DirectoryListing::Directory::Directory(Directory* aParent, const string& aName, Directory::DirType aType, time_t aUpdateDate, const DirectoryContentInfo& aContentInfo, const string& aSize, time_t aRemoteDate /*0*/)
 	: parent(aParent), type(aType), remoteDate(aRemoteDate), lastUpdateDate(aUpdateDate), contentInfo(aContentInfo), name(aName), token(itemIdCounter++) {
 
@@ -238,6 +295,8 @@ void DirectoryListing::Directory::getHashList(DirectoryListing::Directory::TTHSe
 
 void DirectoryListing::File::getLocalPathsUnsafe(StringList& ret, const OptionalProfileToken& aShareProfileToken) const {
 	if (aShareProfileToken) {
+		auto parent = getParent();
+
 		string path;
 		if (parent->isVirtual()) {
 			auto virtualDir = static_cast<VirtualDirectory*>(parent);
@@ -246,7 +305,7 @@ void DirectoryListing::File::getLocalPathsUnsafe(StringList& ret, const Optional
 			path = parent->getAdcPathUnsafe();
 		}
 
-		ShareManager::getInstance()->getRealPaths(path + name, ret, aShareProfileToken);
+		ShareManager::getInstance()->getRealPaths(path + getName(), ret, aShareProfileToken);
 	} else {
 		ret = DupeUtil::getFileDupePaths(dupe, tthRoot);
 	}
@@ -33,6 +33,30 @@ namespace dcpp {
 
 class SearchQuery;
 
+// Append-only storage for the file names of a list
+// Each list load uses a pool of its own and the file arrays keep it alive
+class DirectoryListing::NamePool : public boost::noncopyable {
+public:
+	using Ptr = std::shared_ptr<NamePool>;
+
+	// Returns a NUL-terminated copy of the name that stays valid for the lifetime of the pool
+	string_view add(string_view aName) noexcept;
+
+	size_t getAllocatedBytes() const noexcept {
+		return allocatedBytes;
+	}
+private:
+	static constexpr size_t MIN_BLOCK_SIZE = 1024;
+	static constexpr size_t MAX_BLOCK_SIZE = 1024 * 1024;
+
+	vector<unique_ptr<char[]>> blocks;
+	char* pos = nullptr;
+	char* end = nullptr;
+
+	size_t nextBlockSize = MIN_BLOCK_SIZE;
+	size_t allocatedBytes = 0;
+};
+
 class DirectoryListing::File: public boost::noncopyable {
 
 public:
@@ -43,35 +67,132 @@ public:
 
 	using List = std::vector<Ptr>;
 	using Iter = List::const_iterator;
-		
-	File(Directory* aDir, const string& aName, int64_t aSize, const TTHValue& aTTH, time_t aRemoteDate) noexcept;
-	File(const File& rhs, Owner aOwner) noexcept;
+
+	// Creates a copy of the file that is stored in an array of its own
+	static Ptr copy(const File& aFile, Owner aOwner) noexcept;
 
 	~File() = default;
 
 	string getAdcPathUnsafe() const noexcept;
 
-	GETSET(string, name, Name);
-	GETSET(int64_t, size, Size);
-	GETSET(Directory*, parent, Parent);
-	GETSET(TTHValue, tthRoot, TTH);
+	string getName() const noexcept {
+		return string(name, nameLength);
+	}
+
+	int64_t getSize() const noexcept {
+		return size;
+	}
+
+	const TTHValue& getTTH() const noexcept {
+		return tthRoot;
+	}
+
+	time_t getRemoteDate() const noexcept {
+		return remoteDate;
+	}
+
 	IGETSET(DupeType, dupe, Dupe, DUPE_NONE);
-	IGETSET(time_t, remoteDate, RemoteDate, 0);
+
+	inline Directory* getParent() const noexcept;
 
 	bool isInQueue() const noexcept;
 
-	Owner getOwner() const noexcept {
+	inline Owner getOwner() const noexcept;
+	inline DirectoryListingItemToken getToken() const noexcept;
+
+	void getLocalPathsUnsafe(StringList& ret, const OptionalProfileToken& aShareProfileToken) const;
+private:
+	friend class FileArray;
+
+	File(string_view aName, int64_t aSize, const TTHValue& aTTH, time_t aRemoteDate, uint32_t aIndex) noexcept;
+
+	inline const FileArray& getArray() const noexcept;
+
+	// Stored in the name pool of the list
+	const char* const name;
+	const uint32_t nameLength;
+
+	// Position in the file array of the parent directory
+	const uint32_t index;
+
+	const int64_t size;
+	const TTHValue tthRoot;
+	const time_t remoteDate;
+};
+
+// Files of a directory, stored in a single allocation after the array header
+// The file pointers handed out share the ownership of the whole array
+class DirectoryListing::FileArray : public boost::noncopyable {
+public:
+	using Ptr = std::shared_ptr<FileArray>;
+
+	struct Item {
+		// Must be stored in the name pool of the array
+		string_view name;
+		int64_t size;
+		TTHValue tth;
+		time_t remoteDate;
+	};
+
+	using ItemList = vector<Item>;
+
+	static Ptr create(Directory* aParent, File::Owner aOwner, const NamePool::Ptr& aNames, const ItemList& aItems) noexcept;
+
+	// Appends pointers to all files in the array
+	static void toList(const Ptr& aArray, File::List& files_) noexcept;
+
+	Directory* getParent() const noexcept {
+		return parent;
+	}
+
+	File::Owner getOwner() const noexcept {
 		return owner;
 	}
-	DirectoryListingItemToken getToken() const noexcept {
-		return token;
+
+	const NamePool::Ptr& getNames() const noexcept {
+		return names;
+	}
+
+	DirectoryListingItemToken getFirstToken() const noexcept {
+		return firstToken;
+	}
+
+	uint32_t size() const noexcept {
+		return count;
+	}
+
+	File* begin() noexcept {
+		return reinterpret_cast<File*>(this + 1);
 	}
-	void getLocalPathsUnsafe(StringList& ret, const OptionalProfileToken& aShareProfileToken) const;
 private:
-	Owner owner = nullptr;
-	const DirectoryListingItemToken token;
+	FileArray(Directory* aParent, File::Owner aOwner, const NamePool::Ptr& aNames, uint32_t aCount) noexcept;
+	~FileArray() = default;
+
+	Directory* const parent;
+	const File::Owner owner;
+	const NamePool::Ptr names;
+	const DirectoryListingItemToken firstToken;
+	const uint32_t count;
 };
 
+static_assert(sizeof(DirectoryListing::FileArray) % alignof(DirectoryListing::File) == 0, "Invalid file array header size");
+
+inline const DirectoryListing::FileArray& DirectoryListing::File::getArray() const noexcept {
+	return *(reinterpret_cast<const FileArray*>(this - index) - 1);
+}
+
+inline DirectoryListing::Directory* DirectoryListing::File::getParent() const noexcept {
+	return getArray().getParent();
+}
+
+inline DirectoryListing::File::Owner DirectoryListing::File::getOwner() const noexcept {
+	return getArray().getOwner();
+}
+
+inline DirectoryListingItemToken DirectoryListing::File::getToken() const noexcept {
+	return getArray().getFirstToken() + index;
+}
+
 enum class DirectoryListing::DirectoryLoadType {
 	CHANGE_NORMAL,
 	CHANGE_RELOAD,
@@ -99,6 +220,9 @@ public:
 	Map directories;
 	File::List files;
 
+	// Stores the files in a new array and adds them in the file list
+	void addFiles(const NamePool::Ptr& aNames, const FileArray::ItemList& aItems) noexcept;
+
 	static Ptr create(Directory* aParent, const string& aName, DirType aType, time_t aUpdateDate, 
 		const DirectoryContentInfo& aContentInfo = DirectoryContentInfo::uninitialized(),
 		const string& aSize = Util::emptyString, time_t aRemoteDate = 0);
@@ -33,7 +33,7 @@ using ranges::find_if;
 
 ListLoader::ListLoader(DirectoryListing* aList, const string& aBase,
 	bool aUpdating, time_t aListDownloadDate) :
-	list(aList), cur(aList->getRoot().get()), base(aBase), updating(aUpdating),
+	list(aList), cur(aList->getRoot().get()), names(make_shared<DirectoryListing::NamePool>()), base(aBase), updating(aUpdating),
 	partialList(aList->getPartialList()), listDownloadDate(aListDownloadDate) {
 }
 
@@ -81,8 +81,12 @@ void ListLoader::loadFile(StringPairList& attribs, bool) {
 
 	TTHValue tth(h); /// @todo verify validity?
 
-	auto f = make_shared<DirectoryListing::File>(cur, n, size, tth, Util::parseRemoteFileItemDate(getAttrib(attribs, sDate, 3)));
-	cur->files.push_back(f);
+	pendingFiles.push_back({ names->add(n), size, tth, Util::parseRemoteFileItemDate(getAttrib(attribs, sDate, 3)) });
+}
+
+void ListLoader::flushFiles() noexcept {
+	cur->addFiles(names, pendingFiles);
+	pendingFiles.clear();
 }
 
 DirectoryListing::Directory::DirType ListLoader::parseDirectoryType(bool aIncomplete, const DirectoryContentInfo& aContentInfo) noexcept {
@@ -112,6 +116,9 @@ void ListLoader::loadDirectory(StringPairList& attribs, bool) {
 	const string& size = getAttrib(attribs, sSize, 2);
 	const string& date = getAttrib(attribs, sDate, 3);
 
+	// Files of the parent are stored before entering the child
+	flushFiles();
+
 	DirectoryListing::DirectoryPtr d = nullptr;
 	if (updating) {
 		dirsLoaded++;
@@ -189,9 +196,11 @@ void ListLoader::startTag(const string& aName, StringPairList& attribs, bool aSi
 void ListLoader::endTag(const string& aName) {
 	if(inListing) {
 		if(aName == sDirectory) {
+			flushFiles();
 			cur = cur->getParent();
 		} else if (aName == sFileListing) {
 			// Cur should be the loaded base path now
+			flushFiles();
 
 			cur->setComplete();
 
@@ -44,12 +44,18 @@ public:
 private:
 	void runHooksRecursive(const DirectoryListing::DirectoryPtr& aDir) noexcept;
 
+	// Stores the pending files of the current directory
+	void flushFiles() noexcept;
+
 	static DirectoryListing::Directory::DirType parseDirectoryType(bool aIncomplete, const DirectoryContentInfo& aContentInfo) noexcept;
 	static void validateName(const string_view& aName);
 
 	DirectoryListing* list;
 	DirectoryListing::Directory* cur;
 
+	const DirectoryListing::NamePool::Ptr names;
+	DirectoryListing::FileArray::ItemList pendingFiles;
+
 	bool inListing = false;
 	int dirsLoaded = 0;
 
@@ -0,0 +1,316 @@
+/*
+* Copyright (C) 2011-2024 AirDC++ Project
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+*/
+
+#include "stdinc.h"
+
+#include <airdcpp/filelist/ListSnapshot.h>
+#include <airdcpp/filelist/DirectoryListingDirectory.h>
+
+#include <airdcpp/core/classes/Exception.h>
+#include <airdcpp/core/io/File.h>
+#include <airdcpp/core/io/stream/Streams.h>
+#include <airdcpp/util/AppUtil.h>
+#include <airdcpp/util/PathUtil.h>
+
+namespace dcpp {
+
+#define SNAPSHOT_MAGIC 0x534C4441 // "ADLS"
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_EXTENSION ".snapshot"
+
+// Total size of stored snapshots
+constexpr int64_t MAX_SNAPSHOTS_SIZE = 512 * 1024 * 1024;
+
+// Sanity limit for names
+constexpr uint32_t MAX_STRING_LENGTH = 64 * 1024;
+
+constexpr size_t READ_BUFFER_SIZE = 256 * 1024;
+
+// Smallest possible size of the stored items (empty names and no content)
+constexpr int64_t MIN_FILE_SIZE = sizeof(uint32_t) + sizeof(int64_t) + TTHValue::BYTES + sizeof(int64_t);
+constexpr int64_t MIN_DIRECTORY_SIZE = sizeof(uint32_t) + sizeof(uint8_t) + sizeof(int64_t) * 2 + sizeof(int32_t) * 2 + sizeof(uint32_t) * 2;
+
+namespace {
+
+class SnapshotReader {
+public:
+	explicit SnapshotReader(const string& aPath) : f(aPath, File::READ, File::OPEN, File::BUFFER_SEQUENTIAL), buf(READ_BUFFER_SIZE), remaining(f.getSize()) { }
+
+	void read(void* aData, size_t aLen) {
+		auto out = static_cast<uint8_t*>(aData);
+		while (aLen > 0) {
+			if (pos == len) {
+				len = buf.size();
+				f.read(&buf[0], len);
+				pos = 0;
+				if (len == 0) {
+					throw Exception("Unexpected end of snapshot");
+				}
+			}
+
+			auto n = min(aLen, len - pos);
+			memcpy(out, &buf[pos], n);
+			pos += n;
+			remaining -= n;
+			out += n;
+			aLen -= n;
+		}
+	}
+
+	template<typename T>
+	T read() {
+		T value;
+		read(&value, sizeof(T));
+		return value;
+	}
+
+	string readString() {
+		auto strLen = read<uint32_t>();
+		if (strLen > MAX_STRING_LENGTH) {
+			throw Exception("Invalid string length");
+		}
+
+		string ret(strLen, '\0');
+		read(ret.data(), strLen);
+		return ret;
+	}
+
+	// Validates an item count read from the snapshot so that corrupted counts won't cause huge allocations
+	uint32_t readCount(int64_t aMinItemSize) {
+		auto count = read<uint32_t>();
+		if (count > remaining / aMinItemSize) {
+			throw Exception("Invalid item count");
+		}
+
+		return count;
+	}
+private:
+	File f;
+	ByteVector buf;
+	size_t pos = 0;
+	size_t len = 0;
+
+	// Bytes left in the file
+	int64_t remaining;
+};
+
+class SnapshotWriter {
+public:
+	explicit SnapshotWriter(const string& aPath) : os(new File(aPath, File::WRITE, File::CREATE | File::TRUNCATE)) { }
+
+	template<typename T>
+	void write(T aValue) {
+		os.write(&aValue, sizeof(T));
+	}
+
+	void writeString(const string& aStr) {
+		write<uint32_t>(static_cast<uint32_t>(aStr.size()));
+		os.write(aStr.data(), aStr.size());
+	}
+
+	void writeData(const void* aData, size_t aLen) {
+		os.write(aData, aLen);
+	}
+
+	void flush() {
+		os.flushBuffers(true);
+	}
+private:
+	BufferedOutputStream<true> os;
+};
+
+void writeDirectoryContent(SnapshotWriter& aWriter, const DirectoryListing::Directory& aDir) {
+	aWriter.write<uint32_t>(static_cast<uint32_t>(aDir.files.size()));
+	for (const auto& f : aDir.files) {
+		aWriter.writeString(f->getName());
+		aWriter.write<int64_t>(f->getSize());
+		aWriter.writeData(f->getTTH().data, TTHValue::BYTES);
+		aWriter.write<int64_t>(f->getRemoteDate());
+	}
+
+	auto directories = aDir.directories | views::values | views::filter(DirectoryListing::Directory::NotVirtual);
+	aWriter.write<uint32_t>(static_cast<uint32_t>(ranges::distance(directories)));
+	for (const auto& d : directories) {
+		aWriter.writeString(d->getName());
+		aWriter.write<uint8_t>(static_cast<uint8_t>(d->getType()));
+		aWriter.write<int64_t>(d->getRemoteDate());
+		aWriter.write<int64_t>(d->getPartialSize());
+		aWriter.write<int32_t>(d->getContentInfo().directories);
+		aWriter.write<int32_t>(d->getContentInfo().files);
+
+		writeDirectoryContent(aWriter, *d);
+	}
+}
+
+void readDirectoryContent(SnapshotReader& aReader, const DirectoryListing& aList, DirectoryListing::Directory* aDir, time_t aListDate, 
+	const DirectoryListing::NamePool::Ptr& aNames, DirectoryListing::FileArray::ItemList& files_) {
+
+	if (aList.getClosing()) {
+		throw AbortException();
+	}
+
+	auto files = aReader.readCount(MIN_FILE_SIZE);
+	files_.clear();
+	files_.reserve(files);
+	for (uint32_t i = 0; i < files; ++i) {
+		auto name = aReader.readString();
+		auto size = aReader.read<int64_t>();
+
+		uint8_t tth[TTHValue::BYTES];
+		aReader.read(tth, TTHValue::BYTES);
+
+		auto remoteDate = aReader.read<int64_t>();
+		files_.push_back({ aNames->add(name), size, TTHValue(tth), static_cast<time_t>(remoteDate) });
+	}
+
+	aDir->addFiles(aNames, files_);
+
+	auto directories = aReader.readCount(MIN_DIRECTORY_SIZE);
+	for (uint32_t i = 0; i < directories; ++i) {
+		auto name = aReader.readString();
+		auto type = static_cast<DirectoryListing::Directory::DirType>(aReader.read<uint8_t>());
+		if (type == DirectoryListing::Directory::TYPE_VIRTUAL || type > DirectoryListing::Directory::TYPE_VIRTUAL) {
+			throw Exception("Invalid directory type");
+		}
+
+		auto remoteDate = aReader.read<int64_t>();
+		auto partialSize = aReader.read<int64_t>();
+		auto contentDirectories = aReader.read<int32_t>();
+		auto contentFiles = aReader.read<int32_t>();
+
+		auto d = DirectoryListing::Directory::create(aDir, name, type, aListDate, DirectoryContentInfo(contentDirectories, contentFiles), Util::emptyString, static_cast<time_t>(remoteDate));
+		d->setPartialSize(partialSize);
+
+		readDirectoryContent(aReader, aList, d.get(), aListDate, aNames, files_);
+	}
+}
+
+}
+
+string ListSnapshot::getSnapshotDirectory() noexcept {
+	return AppUtil::getListPath() + "Snapshots" + PATH_SEPARATOR_STR;
+}
+
+string ListSnapshot::getSnapshotPath(const string& aListPath) noexcept {
+	return getSnapshotDirectory() + PathUtil::getFileName(aListPath) + SNAPSHOT_EXTENSION;
+}
+
+bool ListSnapshot::load(DirectoryListing& aList, const string& aListPath, int64_t aListSize, time_t aListDate) {
+	auto path = getSnapshotPath(aListPath);
+	if (!PathUtil::fileExists(path)) {
+		return false;
+	}
+
+	auto root = aList.getRoot();
+	try {
+		SnapshotReader reader(path);
+		if (reader.read<uint32_t>() != SNAPSHOT_MAGIC || reader.read<uint32_t>() != SNAPSHOT_VERSION) {
+			return false;
+		}
+
+		if (reader.readString() != aListPath || reader.read<int64_t>() != aListSize || reader.read<int64_t>() != static_cast<int64_t>(aListDate)) {
+			// Snapshot of an older list
+			return false;
+		}
+
+		DirectoryListing::FileArray::ItemList files;
+		readDirectoryContent(reader, aList, root.get(), aListDate, make_shared<DirectoryListing::NamePool>(), files);
+	} catch (const AbortException&) {
+		throw;
+	} catch (const std::exception& e) {
+		// Discard corrupted snapshots (including ones that would cause excessive allocations)
+		dcdebug("ListSnapshot: failed to load snapshot %s (%s)\n", path.c_str(), e.what());
+		root->clearAll();
+		File::deleteFile(path);
+		return false;
+	}
+
+	// Same as when the loading of a XML list has finished
+	root->setComplete();
+	root->setContentInfo(root->getContentInfoRecursive(false));
+	return true;
+}
+
+void ListSnapshot::save(const DirectoryListing& aList, const string& aListPath, int64_t aListSize, time_t aListDate) noexcept {
+	auto path = getSnapshotPath(aListPath);
+	auto tmpPath = path + ".tmp";
+
+	try {
+		File::ensureDirectory(path);
+
+		{
+			SnapshotWriter writer(tmpPath);
+			writer.write<uint32_t>(SNAPSHOT_MAGIC);
+			writer.write<uint32_t>(SNAPSHOT_VERSION);
+			writer.writeString(aListPath);
+			writer.write<int64_t>(aListSize);
+			writer.write<int64_t>(static_cast<int64_t>(aListDate));
+
+			writeDirectoryContent(writer, *aList.getRoot());
+			writer.flush();
+		}
+
+		File::renameFile(tmpPath, path);
+	} catch (const Exception& e) {
+		dcdebug("ListSnapshot: failed to save snapshot %s (%s)\n", path.c_str(), e.what());
+		File::deleteFile(tmpPath);
+		return;
+	}
+
+	removeOldSnapshots();
+}
+
+void ListSnapshot::removeOldSnapshots() noexcept {
+	struct SnapshotInfo {
+		string path;
+		int64_t size;
+		time_t date;
+	};
+
+	vector<SnapshotInfo> snapshots;
+	int64_t totalSize = 0;
+
+	auto directory = getSnapshotDirectory();
+	try {
+		File::forEachFile(directory, "*" SNAPSHOT_EXTENSION, [&](const FilesystemItem& aInfo) {
+			auto path = aInfo.getPath(directory);
+			snapshots.emplace_back(path, aInfo.size, File::getLastModified(path));
+			totalSize += aInfo.size;
+		});
+	} catch (const FileException&) {
+		return;
+	}
+
+	if (totalSize <= MAX_SNAPSHOTS_SIZE) {
+		return;
+	}
+
+	// Remove the oldest ones first
+	ranges::sort(snapshots, {}, &SnapshotInfo::date);
+	for (const auto& s : snapshots) {
+		if (totalSize <= MAX_SNAPSHOTS_SIZE) {
+			break;
+		}
+
+		if (File::deleteFile(s.path)) {
+			totalSize -= s.size;
+		}
+	}
+}
+
+} // namespace dcpp
@@ -0,0 +1,52 @@
+/*
+* Copyright (C) 2011-2024 AirDC++ Project
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+*/
+
+#ifndef DCPLUSPLUS_DCPP_LIST_SNAPSHOT_H
+#define DCPLUSPLUS_DCPP_LIST_SNAPSHOT_H
+
+#include <airdcpp/core/header/typedefs.h>
+
+#include <airdcpp/filelist/DirectoryListing.h>
+
+namespace dcpp {
+
+// Binary snapshots of parsed file lists so that reopening a list doesn't require decompressing and parsing the XML again
+// Snapshots contain the list content before the load hooks have been run
+class ListSnapshot {
+public:
+	// Lists smaller than this (compressed size) are parsed directly
+	static const int64_t MIN_LIST_SIZE = 1024 * 1024;
+
+	// Load the list content from a snapshot matching the list file
+	// Returns false if no valid snapshot exists for the list
+	// Throws AbortException if the list was closed while loading
+	static bool load(DirectoryListing& aList, const string& aListPath, int64_t aListSize, time_t aListDate);
+
+	// Store the content of a fully loaded list
+	// The oldest snapshots are removed if the total size of the snapshots exceeds the limit
+	static void save(const DirectoryListing& aList, const string& aListPath, int64_t aListSize, time_t aListDate) noexcept;
+
+	static string getSnapshotDirectory() noexcept;
+	static string getSnapshotPath(const string& aListPath) noexcept;
+private:
+	static void removeOldSnapshots() noexcept;
+};
+
+} // namespace dcpp
+
+#endif // !defined(DCPLUSPLUS_DCPP_LIST_SNAPSHOT_H)
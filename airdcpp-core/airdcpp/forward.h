@@ -154,6 +154,8 @@ using OnlineUserList = std::vector<OnlineUserPtr>;
 using SID = uint32_t;
 
 class OutputStream;
+class AsyncOutputStream;
+class StreamWriterPool;
 
 class PrivateChat;
 using PrivateChatPtr = std::shared_ptr<PrivateChat>;
@@ -238,6 +240,8 @@ class ViewFile;
 using ViewFilePtr = shared_ptr<ViewFile>;
 using ViewFileList = vector<ViewFilePtr>;
 
+class ZFilter;
+
 // Generic callbacks
 using Callback = function<void ()>;
 using MessageCallback = function<void (const string &)>;
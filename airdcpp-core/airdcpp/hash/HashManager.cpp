@@ -34,6 +34,8 @@ namespace dcpp {
 
 using ranges::find_if;
 
+#define MAX_QUEUED_SMALL_FILES 500
+
 HashManager::HashManager() {
 	store = make_unique<HashStore>();
 }
@@ -56,17 +58,26 @@ void HashManager::onFileHashed(const string& aPath, HashedFile& aFile, const Tig
 
 	HashManager::getInstance()->fire(HashManagerListener::FileHashed(), aPath, aFile, aHasherId);
 	try {
-		store->addHashedFile(Text::toLower(aPath), aTree, aFile);
+		store->addHashedFileBatched(Text::toLower(aPath), aTree, aFile);
 	} catch (const Exception& e) {
 		logHasher(STRING_F(HASHING_FAILED_X, e.getError()), aHasherId, LogMessage::SEV_ERROR, true);
 	}
 }
 
+void HashManager::flushHashedFiles(int aHasherId) noexcept {
+	try {
+		store->flushPending();
+	} catch (const Exception& e) {
+		logHasher(STRING_F(HASHING_FAILED_X, e.getError()), aHasherId, LogMessage::SEV_ERROR, false);
+	}
+}
+
 void HashManager::onFileFailed(const string& aPath, const string& aErrorId, const string& aMessage, int aHasherId) noexcept {
 	fire(HashManagerListener::FileFailed(), aPath, aErrorId, aMessage, aHasherId);
 }
 
 void HashManager::onDirectoryHashed(const string& aPath, const HasherStats& aStats, int aHasherId) noexcept {
+	// The files are written by the hasher after releasing the lock but the lookups will find them from the pending entries already
 	fire(HashManagerListener::DirectoryHashed(), aPath, aStats, aHasherId);
 }
 
@@ -79,6 +90,44 @@ void HashManager::removeHasher(int aHasherId) noexcept {
 	std::erase_if(hashers, [aHasherId](const Hasher* aHasher) { return aHasher->hasherID == aHasherId; });
 }
 
+bool HashManager::stealWork(Hasher& aHasher) noexcept {
+	// Try the most loaded hashers first
+	HasherList victims;
+	ranges::copy_if(hashers, back_inserter(victims), [&aHasher](const Hasher* h) { return h != &aHasher && h->getQueuedFiles() > 0; });
+	ranges::sort(victims, [](const Hasher* h1, const Hasher* h2) { return h1->getBytesLeft() > h2->getBytesLeft(); });
+
+	for (auto victim: victims) {
+		auto stolen = aHasher.stealFiles(*victim, [this](int64_t aDeviceId) {
+			return getDeviceHashers(aDeviceId) < getMaxDeviceHashers(aDeviceId);
+		});
+
+		if (stolen > 0) {
+			dcdebug("Hash: hasher #%d took %d files from hasher #%d\n", aHasher.hasherID, static_cast<int>(stolen), victim->hasherID);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+int HashManager::getMaxDeviceHashers(int64_t aDeviceId) noexcept {
+	auto i = solidStateDevices.find(aDeviceId);
+	if (i == solidStateDevices.end()) {
+		i = solidStateDevices.emplace(aDeviceId, File::isSolidStateDevice(aDeviceId)).first;
+	}
+
+	// Parallel reads only cause seeking with rotational disks
+	if (!i->second && SETTING(HASHERS_PER_VOLUME) > 0) {
+		return SETTING(HASHERS_PER_VOLUME);
+	}
+
+	return max(SETTING(MAX_HASHING_THREADS), 1);
+}
+
+int HashManager::getDeviceHashers(int64_t aDeviceId) const noexcept {
+	return static_cast<int>(ranges::count_if(hashers, [aDeviceId](const Hasher* aHasher) { return aHasher->hasDevice(aDeviceId); }));
+}
+
 void HashManager::logHasher(const string& aMessage, int aHasherID, LogMessage::Severity aSeverity, bool aLock) const noexcept {
 	ConditionalRLock l(Hasher::hcs, aLock);
 	log((hashers.size() > 1 ? "[" + STRING_F(HASHER_X, aHasherID) + "] " + ": " : Util::emptyString) + aMessage, aSeverity);
@@ -123,6 +172,21 @@ bool HashManager::checkTTH(const string& aFileLower, const string& aFileName, Ha
 	return true;
 }
 
+bool HashManager::checkTTH(const HashedFileMap& aDirectoryFiles, const string& aFileNameLower, const string& aFileName, const string& aFileLower, HashedFile& fi_) {
+	dcassert(Text::isLower(aFileLower));
+	if (!HashStore::checkTTH(aDirectoryFiles, aFileNameLower, fi_)) {
+		hashFile(aFileName, aFileLower, fi_.getSize());
+		return false;
+	}
+
+	return true;
+}
+
+HashedFileMap HashManager::getDirectoryFiles(const string& aDirectoryLower) noexcept {
+	dcassert(Text::isLower(aDirectoryLower));
+	return store->getDirectoryFiles(aDirectoryLower);
+}
+
 void HashManager::getFileInfo(const string& aFileLower, const string& aFileName, HashedFile& fi_) {
 	dcassert(Text::isLower(aFileLower));
 	auto found = store->getFileInfo(aFileLower, fi_);
@@ -177,7 +241,7 @@ Hasher* HashManager::createHasher() noexcept {
 	return h;
 }
 
-Hasher* HashManager::getFileHasher(int64_t aDeviceId, int64_t aSize) const noexcept {
+Hasher* HashManager::getFileHasher(int64_t aDeviceId, int64_t aSize, int aMaxDeviceHashers) const noexcept {
 	Hasher* h = nullptr;
 	auto getLeastLoaded = [](const HasherList& hl) {
 		return ranges::min_element(hl, [](const Hasher* h1, const Hasher* h2) { return h1->getBytesLeft() < h2->getBytesLeft(); });
@@ -196,8 +260,11 @@ Hasher* HashManager::getFileHasher(int64_t aDeviceId, int64_t aSize) const noexc
 	} else if (!volHashers.empty()) {
 		auto minLoaded = getLeastLoaded(volHashers);
 
-		auto volumeHashersExceeded = static_cast<int>(volHashers.size()) >= SETTING(HASHERS_PER_VOLUME) && SETTING(HASHERS_PER_VOLUME) > 0;
-		auto reuseExisting = aSize <= Util::convertSize(10, Util::MB) && !volHashers.empty() && (*minLoaded)->getBytesLeft() <= Util::convertSize(200, Util::MB);
+		auto volumeHashersExceeded = static_cast<int>(volHashers.size()) >= aMaxDeviceHashers;
+
+		// Spread long lists of small files as well if the device allows it
+		auto reuseExisting = aSize <= Hasher::SMALL_FILE_SIZE && !volHashers.empty() && (*minLoaded)->getBytesLeft() <= Util::convertSize(200, Util::MB) &&
+			(*minLoaded)->getQueuedFiles() < MAX_QUEUED_SMALL_FILES;
 		if (totalHashersExceeded || volumeHashersExceeded || reuseExisting) {
 
 			// Use the least loaded hasher that already has this volume
@@ -227,7 +294,7 @@ bool HashManager::hashFile(const string& aPath, const string& aPathLower, int64_
 		h = hashers.front();
 		// dcdebug("Using empty main hasher for file %s\n", aPath.c_str());
 	} else {
-		h = getFileHasher(deviceId, aSize);
+		h = getFileHasher(deviceId, aSize, getMaxDeviceHashers(deviceId));
 		if (!h) {
 			// Create new one
 			h = createHasher();
@@ -23,6 +23,7 @@
 #include <airdcpp/core/header/typedefs.h>
 
 #include <airdcpp/core/io/db/DbHandler.h>
+#include <airdcpp/hash/HashedFile.h>
 #include <airdcpp/hash/HasherManager.h>
 #include <airdcpp/hash/HasherStats.h>
 #include <airdcpp/hash/HashManagerListener.h>
@@ -37,7 +38,6 @@ namespace dcpp {
 class Hasher;
 class HashStore;
 class HasherStats;
-class HashedFile;
 
 class HashManager : public Singleton<HashManager>, public Speaker<HashManagerListener>, public HasherManager {
 
@@ -50,6 +50,15 @@ public:
 	 */
 	bool checkTTH(const string& aFileLower, const string& aFileName, HashedFile& fi_);
 
+	/**
+	 * Same as above but the database entry is taken from the directory listing returned by getDirectoryFiles
+	 */
+	bool checkTTH(const HashedFileMap& aDirectoryFiles, const string& aFileNameLower, const string& aFileName, const string& aFileLower, HashedFile& fi_);
+
+	// Get the database entries of all files directly inside the directory with a single database seek
+	// The directory path must be lowercase and end with a separator
+	HashedFileMap getDirectoryFiles(const string& aDirectoryLower) noexcept;
+
 	void stopHashing(const string& aBaseDir) noexcept;
 	void setPriority(Thread::Priority p) noexcept;
 
@@ -141,12 +150,21 @@ private:
 	void onDirectoryHashed(const string& aPath, const HasherStats&, int aHasherId) noexcept override;
 	void onHasherFinished(int aDirectoriesHashed, const HasherStats&, int aHasherId) noexcept override;
 	void removeHasher(int aHasherId) noexcept override;
+	bool stealWork(Hasher& aHasher) noexcept override;
 	void logHasher(const string& aMessage, int aHasherID, LogMessage::Severity aSeverity, bool aLock) const noexcept override;
+	void flushHashedFiles(int aHasherId) noexcept override;
 
 	static void log(const string& aMsg, LogMessage::Severity aSeverity) noexcept;
 
 	Hasher* createHasher() noexcept;
-	Hasher* getFileHasher(int64_t aDeviceId, int64_t aSize) const noexcept;
+	Hasher* getFileHasher(int64_t aDeviceId, int64_t aSize, int aMaxDeviceHashers) const noexcept;
+
+	// Number of hashers that may read from the same device concurrently
+	int getMaxDeviceHashers(int64_t aDeviceId) noexcept;
+	int getDeviceHashers(int64_t aDeviceId) const noexcept;
+
+	// Device ID -> solid state, accessed with the hasher lock
+	map<int64_t, bool> solidStateDevices;
 	bool isPathQueued(const string& aPathLower) const noexcept;
 
 	bool hashFile(const string& filePath, const string& pathLower, int64_t size);
@@ -20,8 +20,8 @@
 
 #include <airdcpp/hash/HashStore.h>
 #include <airdcpp/DCPlusPlus.h>
+#include <airdcpp/core/classes/ScopedFunctor.h>
 #include <airdcpp/core/io/File.h>
-#include <airdcpp/hash/HashedFile.h>
 #include <airdcpp/core/io/db/LevelDB.h>
 #include <airdcpp/events/LogManager.h>
 #include <airdcpp/util/PathUtil.h>
@@ -78,9 +78,26 @@ void HashStore::openDb(StartupLoader& aLoader) {
 		// Can't continue without hash database, abort startup
 		throw AbortException(e.getError());
 	}
+
+	// Decoded trees take more memory than the raw blocks so this is cached separately from the database block cache
+	treeCache.setMaxSize(cacheSize);
 }
 
 void HashStore::closeDb() noexcept {
+	if (hashDb && fileDb) {
+		// Failed entries are dropped after the last attempt
+		for (int i = 0; i < MAX_FLUSH_ATTEMPTS; i++) {
+			try {
+				flushPending();
+				break;
+			} catch (const HashException& e) {
+				log(e.getError(), LogMessage::SEV_ERROR);
+			}
+		}
+	}
+
+	treeCache.clear();
+
 	hashDb.reset(nullptr);
 	fileDb.reset(nullptr);
 }
@@ -94,7 +111,154 @@ void HashStore::addHashedFile(const string& aFileLower, const TigerTree& tt, con
 	addFile(aFileLower, fi_);
 }
 
+void HashStore::addHashedFileBatched(const string& aFileLower, const TigerTree& tt, const HashedFile& fi_) {
+	auto treeData = serializeTree(tt);
+
+	bool flush = false;
+	{
+		Lock l(pendingCS);
+		auto [tree, added] = pending.trees.try_emplace(tt.getRoot(), std::move(treeData));
+		if (added) {
+			pending.treeBytes += tree->second.size();
+		}
+
+		pending.files.insert_or_assign(aFileLower, fi_);
+		flush = pending.files.size() >= MAX_PENDING_FILES || pending.treeBytes >= MAX_PENDING_TREE_BYTES;
+	}
+
+	if (flush) {
+		flushPending();
+	}
+}
+
+void HashStore::flushPending() {
+	Lock fl(flushCS);
+
+	DbEntryList treeEntries, fileEntries;
+
+	{
+		Lock l(pendingCS);
+		if (pending.empty()) {
+			return;
+		}
+
+		// Keep the entries readable until they have been written
+		flushing = std::move(pending);
+		pending = PendingEntries();
+
+		treeEntries.reserve(flushing.trees.size());
+		for (const auto& [root, data] : flushing.trees) {
+			treeEntries.emplace_back(string(reinterpret_cast<const char*>(root.data), sizeof(TTHValue)), data);
+		}
+
+		fileEntries.reserve(flushing.files.size());
+		string fileData(getFileInfoSize(HashedFile()), 0);
+		for (const auto& [path, fi] : flushing.files) {
+			saveFileInfo(fileData.data(), fi);
+			fileEntries.emplace_back(path, fileData);
+		}
+	}
+
+	ScopedFunctor([this] {
+		Lock l(pendingCS);
+		flushing = PendingEntries();
+	});
+
+	auto handleFailure = [this](const DbHandler& aDb, const DbException& e, bool aTreesWritten) {
+		auto error = STRING_F(WRITE_FAILED_X, aDb.getNameLower() % e.getError());
+		auto lost = requeueFailedUnsafe(aTreesWritten);
+		if (lost > 0) {
+			// The files will be hashed again during the next refresh
+			error += " (" + STRING_F(X_FILES_FAILED_HASHING, lost) + ")";
+		}
+
+		return HashException(error);
+	};
+
+	// Write the trees first so that there won't be any file entries without a tree
+	try {
+		hashDb->putBatch(treeEntries);
+	} catch (const DbException& e) {
+		throw handleFailure(*hashDb, e, false);
+	}
+
+	try {
+		fileDb->putBatch(fileEntries);
+	} catch (const DbException& e) {
+		throw handleFailure(*fileDb, e, true);
+	}
+
+	failedFlushes = 0;
+	flushedBatches++;
+	flushedFiles += fileEntries.size();
+	for (const auto& entries: { &treeEntries, &fileEntries }) {
+		for (const auto& [key, value] : *entries) {
+			flushedBytes += key.size() + value.size();
+		}
+	}
+}
+
+size_t HashStore::requeueFailedUnsafe(bool aTreesWritten) noexcept {
+	Lock l(pendingCS);
+	failedFlushes++;
+	if (failedFlushes >= MAX_FLUSH_ATTEMPTS) {
+		failedFlushes = 0;
+		return flushing.files.size();
+	}
+
+	// Entries queued after the failed batch are newer and must not be overwritten
+	if (!aTreesWritten) {
+		for (auto& [root, data] : flushing.trees) {
+			auto [tree, added] = pending.trees.try_emplace(root, std::move(data));
+			if (added) {
+				pending.treeBytes += tree->second.size();
+			}
+		}
+	}
+
+	for (const auto& [path, fi] : flushing.files) {
+		pending.files.try_emplace(path, fi);
+	}
+
+	return 0;
+}
+
+bool HashStore::getPendingTree(const TTHValue& aRoot, string& data_) const noexcept {
+	Lock l(pendingCS);
+	for (const auto entries: { &pending, &flushing }) {
+		auto i = entries->trees.find(aRoot);
+		if (i != entries->trees.end()) {
+			data_ = i->second;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool HashStore::getPendingFile(const string& aFileLower, HashedFile& fi_) const noexcept {
+	Lock l(pendingCS);
+	for (const auto entries: { &pending, &flushing }) {
+		auto i = entries->files.find(aFileLower);
+		if (i != entries->files.end()) {
+			fi_ = i->second;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void HashStore::removePendingFile(const string& aFileLower) noexcept {
+	// The caller must hold flushCS (there are no entries being flushed)
+	Lock l(pendingCS);
+	pending.files.erase(aFileLower);
+}
+
 void HashStore::addFile(const string& aFileLower, const HashedFile& fi_) {
+	Lock fl(flushCS);
+	removePendingFile(aFileLower);
+
 	auto sz = getFileInfoSize(fi_);
 	void* buf = malloc(sz);
 	saveFileInfo(buf, fi_);
@@ -109,6 +273,9 @@ void HashStore::addFile(const string& aFileLower, const HashedFile& fi_) {
 }
 
 void HashStore::removeFile(const string& aFilePathLower) {
+	Lock fl(flushCS);
+	removePendingFile(aFilePathLower);
+
 	try {
 		fileDb->remove((void*)aFilePathLower.c_str(), aFilePathLower.length());
 	} catch (const DbException& e) {
@@ -146,16 +313,14 @@ void HashStore::renameFileThrow(const string& aOldPath, const string& aNewPath)
 	addFile(newPathLower, hashedFile);
 }
 
-void HashStore::addTree(const TigerTree& tt) {
+string HashStore::serializeTree(const TigerTree& tt) {
 	size_t treelen = tt.getLeaves().size() == 1 ? 0 : tt.getLeaves().size() * TTHValue::BYTES;
 	auto sz = sizeof(uint8_t) + sizeof(int64_t) + sizeof(int64_t) + treelen;
 
-	//allocate the memory
-	void* buf = malloc(sz);
-
+	string ret(sz, 0);
 
 	//set the data
-	char* p = (char*)buf;
+	char* p = ret.data();
 
 	uint8_t version = HASHDATA_VERSION;
 	memcpy(p, &version, sizeof(uint8_t));
@@ -172,22 +337,40 @@ void HashStore::addTree(const TigerTree& tt) {
 	if (treelen > 0)
 		memcpy(p, tt.getLeaves()[0].data, treelen);
 
+	return ret;
+}
+
+void HashStore::addTree(const TigerTree& tt) {
+	auto data = serializeTree(tt);
+
 	//throw HashException(STRING_F(WRITE_FAILED_X, hashDb->getNameLower() % "TEST"));
 	try {
-		hashDb->put((void*)tt.getRoot().data, sizeof(TTHValue), buf, sz);
+		hashDb->put((void*)tt.getRoot().data, sizeof(TTHValue), data.data(), data.size());
 	} catch (const DbException& e) {
-		free(buf);
 		throw HashException(STRING_F(WRITE_FAILED_X, hashDb->getNameLower() % e.getError()));
 	}
-
-	free(buf);
 }
 
 bool HashStore::getTree(const TTHValue& aRoot, TigerTree& tt_) {
+	if (treeCache.get(aRoot, tt_)) {
+		return true;
+	}
+
+	string pendingData;
+	if (getPendingTree(aRoot, pendingData)) {
+		return loadTree(pendingData.data(), pendingData.size(), aRoot, tt_, true);
+	}
+
 	try {
-		return hashDb->get((void*)aRoot.data, sizeof(TTHValue), 100 * 1024, [&](void* aValue, size_t valueLen) {
+		auto found = hashDb->get((void*)aRoot.data, sizeof(TTHValue), 100 * 1024, [&](void* aValue, size_t valueLen) {
 			return loadTree(aValue, valueLen, aRoot, tt_, true);
 		});
+
+		if (found) {
+			treeCache.put(tt_);
+		}
+
+		return found;
 	} catch (const DbException& e) {
 		log(STRING_F(READ_FAILED_X, hashDb->getNameLower() % e.getError()), LogMessage::SEV_ERROR);
 	}
@@ -196,6 +379,11 @@ bool HashStore::getTree(const TTHValue& aRoot, TigerTree& tt_) {
 }
 
 bool HashStore::hasTree(const TTHValue& aRoot) {
+	string pendingData;
+	if (getPendingTree(aRoot, pendingData)) {
+		return true;
+	}
+
 	bool ret = false;
 	try {
 		ret = hashDb->hasKey((void*)aRoot.data, sizeof(TTHValue));
@@ -300,24 +488,38 @@ uint32_t HashStore::getFileInfoSize(const HashedFile& /*aTree*/) {
 	return sizeof(uint8_t) + sizeof(uint64_t) + sizeof(TTHValue) + sizeof(int64_t);
 }
 
-int64_t HashStore::getRootInfo(const TTHValue& root, InfoType aType) noexcept {
-	int64_t ret = 0;
-	try {
-		hashDb->get((void*)root.data, sizeof(TTHValue), 100 * 1024, [&](void* aValue, size_t /*valueLen*/) {
-			char* p = (char*)aValue;
+bool HashStore::loadRootInfo(const void* src, size_t len, InfoType aType, int64_t& value_) {
+	if (len < sizeof(uint8_t) + sizeof(int64_t) + sizeof(int64_t))
+		return false;
 
-			uint8_t version;
-			memcpy(&version, p, sizeof(uint8_t));
-			p += sizeof(uint8_t);
+	char* p = (char*)src;
 
-			if (version > FILEINDEX_VERSION) {
-				return false;
-			}
+	uint8_t version;
+	memcpy(&version, p, sizeof(uint8_t));
+	p += sizeof(uint8_t);
 
-			p += (aType == TYPE_FILESIZE ? 0 : sizeof(int64_t));
+	if (version > HASHDATA_VERSION) {
+		return false;
+	}
 
-			memcpy(&ret, p, sizeof(ret));
-			return true;
+	p += (aType == TYPE_FILESIZE ? 0 : sizeof(int64_t));
+
+	memcpy(&value_, p, sizeof(value_));
+	return true;
+}
+
+int64_t HashStore::getRootInfo(const TTHValue& root, InfoType aType) noexcept {
+	int64_t ret = 0;
+
+	string pendingData;
+	if (getPendingTree(root, pendingData)) {
+		loadRootInfo(pendingData.data(), pendingData.size(), aType, ret);
+		return ret;
+	}
+
+	try {
+		hashDb->get((void*)root.data, sizeof(TTHValue), 100 * 1024, [&](void* aValue, size_t valueLen) {
+			return loadRootInfo(aValue, valueLen, aType, ret);
 		});
 	} catch (const DbException& e) {
 		log(STRING_F(READ_FAILED_X, hashDb->getNameLower() % e.getError()), LogMessage::SEV_ERROR);
@@ -338,7 +540,56 @@ bool HashStore::checkTTH(const string& aFileLower, HashedFile& fi_) noexcept {
 	return false;
 }
 
+bool HashStore::checkTTH(const HashedFileMap& aDirectoryFiles, const string& aFileNameLower, HashedFile& fi_) noexcept {
+	auto i = aDirectoryFiles.find(aFileNameLower);
+	if (i == aDirectoryFiles.end()) {
+		return false;
+	}
+
+	if (i->second.getTimeStamp() != fi_.getTimeStamp() || i->second.getSize() != fi_.getSize()) {
+		return false;
+	}
+
+	fi_ = i->second;
+	return true;
+}
+
+HashedFileMap HashStore::getDirectoryFiles(const string& aDirectoryLower) noexcept {
+	dcassert(!aDirectoryLower.empty() && aDirectoryLower.back() == PATH_SEPARATOR);
+
+	HashedFileMap ret;
+
+	// Check the queued entries first (they may get written while the database is being read)
+	{
+		Lock l(pendingCS);
+		for (const auto entries: { &pending, &flushing }) {
+			for (const auto& [path, fi]: entries->files) {
+				if (path.size() > aDirectoryLower.size() && path.compare(0, aDirectoryLower.size(), aDirectoryLower) == 0 && path.find(PATH_SEPARATOR, aDirectoryLower.size()) == string::npos) {
+					ret.try_emplace(path.substr(aDirectoryLower.size()), fi);
+				}
+			}
+		}
+	}
+
+	try {
+		HashedFile fi;
+		fileDb->forEachPrefixed(aDirectoryLower, PATH_SEPARATOR, [&](void* aKey, size_t keyLen, void* aValue, size_t valueLen) {
+			if (loadFileInfo(aValue, valueLen, fi)) {
+				ret.try_emplace(string((const char*)aKey + aDirectoryLower.size(), keyLen - aDirectoryLower.size()), fi);
+			}
+		});
+	} catch (const DbException& e) {
+		log(STRING_F(READ_FAILED_X, fileDb->getNameLower() % e.getError()), LogMessage::SEV_ERROR);
+	}
+
+	return ret;
+}
+
 bool HashStore::getFileInfo(const string& aFileLower, HashedFile& fi_) noexcept {
+	if (getPendingFile(aFileLower, fi_)) {
+		return true;
+	}
+
 	try {
 		return fileDb->get((void*)aFileLower.c_str(), aFileLower.length(), sizeof(HashedFile), [&](void* aValue, size_t valueLen) {
 			return loadFileInfo(aValue, valueLen, fi_);
@@ -363,6 +614,13 @@ void HashStore::optimize(bool doVerify) noexcept {
 
 	log(STRING(HASHDB_MAINTENANCE_STARTED), LogMessage::SEV_INFO);
 
+	// The snapshots must contain everything that has been hashed so far
+	try {
+		flushPending();
+	} catch (const HashException& e) {
+		log(e.getError(), LogMessage::SEV_ERROR);
+	}
+
 	{
 		unordered_set<TTHValue> usedRoots;
 
@@ -406,6 +664,7 @@ void HashStore::optimize(bool doVerify) noexcept {
 				if (i == usedRoots.end() && !QueueManager::getInstance()->isFileQueued(curRoot)) {
 					//not needed
 					unusedTrees++;
+					treeCache.remove(curRoot);
 					return true;
 				}
 
@@ -419,6 +678,7 @@ void HashStore::optimize(bool doVerify) noexcept {
 
 				//failed to load it
 				failedTrees++;
+				treeCache.remove(curRoot);
 				return true;
 			}, hashSnapshot.get());
 		} catch (const DbException& e) {
@@ -504,6 +764,31 @@ string HashStore::getDbStats() noexcept {
 	statMsg += "Deleted entries since last compaction: " + Util::toString(SETTING(CUR_REMOVED_TREES)) + " (" + Util::toString(((double)SETTING(CUR_REMOVED_TREES) / (double)hashDb->size(false)) * 100) + "%)";
 	statMsg += "\r\n\r\n";
 	statMsg += "\n\nDisk block size: " + Util::formatBytes(File::getBlockSize(hashDb->getPath())) + "\n\n";
+
+	auto cacheStats = treeCache.getStats();
+	auto cacheLookups = cacheStats.hits + cacheStats.misses;
+	statMsg += "-=[ Tree cache ]=-\n\n";
+	statMsg += "Cached trees: " + Util::toString(cacheStats.entries) + " (" + Util::formatBytes(cacheStats.size) + " of " + Util::formatBytes(cacheStats.maxSize) + ")";
+	statMsg += "\r\nHits: " + Util::toString(cacheStats.hits) + ", misses: " + Util::toString(cacheStats.misses);
+	if (cacheLookups > 0) {
+		statMsg += " (hit ratio " + Util::toString((static_cast<double>(cacheStats.hits) / static_cast<double>(cacheLookups)) * 100) + "%)";
+	}
+
+	statMsg += "\r\n\r\n-=[ Batched writes ]=-\n\n";
+	{
+		Lock l(flushCS);
+		statMsg += "Written batches: " + Util::toString(flushedBatches) + " (" + Util::toString(flushedFiles) + " files, " + Util::formatBytes(static_cast<int64_t>(flushedBytes)) + ")";
+		if (flushedBatches > 0) {
+			statMsg += "\r\nAverage files per batch: " + Util::toString(static_cast<double>(flushedFiles) / static_cast<double>(flushedBatches));
+		}
+	}
+
+	{
+		Lock l(pendingCS);
+		statMsg += "\r\nQueued files: " + Util::toString(pending.files.size()) + " (" + Util::formatBytes(pending.treeBytes) + " of tree data)";
+	}
+
+	statMsg += "\n\n";
 	return statMsg;
 }
 
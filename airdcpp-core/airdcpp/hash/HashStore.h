@@ -23,19 +23,30 @@
 #include <airdcpp/core/header/typedefs.h>
 
 #include <airdcpp/core/io/db/DbHandler.h>
+#include <airdcpp/core/thread/CriticalSection.h>
+#include <airdcpp/hash/HashedFile.h>
+#include <airdcpp/hash/TreeCache.h>
 #include <airdcpp/hash/value/MerkleTree.h>
 #include <airdcpp/message/Message.h>
 
 namespace dcpp {
 
-class HashedFile;
-
 class HashStore {
 public:
 	HashStore();
 	~HashStore();
 
 	void addHashedFile(const string& aFilePathLower, const TigerTree& tt, const HashedFile& fi_);
+
+	// Queue a hashed file to be written with the next batch (used by the hashers)
+	// The batch is written automatically when it grows large enough
+	// Throws HashException if the batch write fails
+	void addHashedFileBatched(const string& aFilePathLower, const TigerTree& tt, const HashedFile& fi_);
+
+	// Write all queued entries to the databases
+	// Throws HashException
+	void flushPending();
+
 	void addFile(const string& aFilePathLower, const HashedFile& fi_);
 	void removeFile(const string& aFilePathLower);
 
@@ -49,6 +60,12 @@ public:
 
 	bool checkTTH(const string& aFileNameLower, HashedFile& fi_) noexcept;
 
+	// Same as above but the file is looked up from a map returned by getDirectoryFiles
+	static bool checkTTH(const HashedFileMap& aDirectoryFiles, const string& aFileNameLower, HashedFile& fi_) noexcept;
+
+	// Get all files directly inside the directory (the path must end with a separator)
+	HashedFileMap getDirectoryFiles(const string& aDirectoryLower) noexcept;
+
 	void addTree(const TigerTree& tt);
 	bool getFileInfo(const string& aFileLower, HashedFile& aFile) noexcept;
 	bool getTree(const TTHValue& root, TigerTree& tth);
@@ -76,6 +93,49 @@ private:
 	std::unique_ptr<DbHandler> fileDb;
 	std::unique_ptr<DbHandler> hashDb;
 
+	TreeCache treeCache;
+
+	// Entries that have been queued but not written in the databases yet
+	// Trees are stored in serialized form
+	struct PendingEntries {
+		unordered_map<TTHValue, string> trees;
+		unordered_map<string, HashedFile> files;
+		int64_t treeBytes = 0;
+
+		bool empty() const noexcept { return files.empty() && trees.empty(); }
+	};
+
+	static const size_t MAX_PENDING_FILES = 256;
+	static const int64_t MAX_PENDING_TREE_BYTES = 8 * 1024 * 1024;
+
+	// Failed batches are queued again until this many consecutive writes have failed
+	static const int MAX_FLUSH_ATTEMPTS = 3;
+
+	// Accessed with pendingCS
+	PendingEntries pending;
+	PendingEntries flushing;
+	mutable CriticalSection pendingCS;
+
+	// Held while writing the batch (and when writing file entries directly so that they won't be overwritten with older queued data)
+	CriticalSection flushCS;
+
+	// Accessed with flushCS
+	int failedFlushes = 0;
+	uint64_t flushedBatches = 0;
+	uint64_t flushedFiles = 0;
+	uint64_t flushedBytes = 0;
+
+	// Move the unwritten entries back to the queue (or drop them if the maximum number of attempts has been reached)
+	// Returns the number of dropped files
+	size_t requeueFailedUnsafe(bool aTreesWritten) noexcept;
+
+	bool getPendingTree(const TTHValue& aRoot, string& data_) const noexcept;
+	bool getPendingFile(const string& aFileLower, HashedFile& fi_) const noexcept;
+	void removePendingFile(const string& aFileLower) noexcept;
+
+	static string serializeTree(const TigerTree& tt);
+	static bool loadRootInfo(const void* src, size_t len, InfoType aType, int64_t& value_);
+
 	static bool loadTree(const void* src, size_t len, const TTHValue& aRoot, TigerTree& aTree, bool aReportCorruption);
 
 	static bool loadFileInfo(const void* src, size_t len, HashedFile& aFile);
@@ -40,6 +40,9 @@ public:
 
 using RenameList = std::vector<pair<std::string, HashedFile>>;
 
+// Lowercase file name -> file
+using HashedFileMap = std::unordered_map<std::string, HashedFile>;
+
 }
 
 #endif // !defined(DCPLUSPLUS_DCPP_HASHEDFILEINFO_H)
\ No newline at end of file
@@ -40,6 +40,10 @@ namespace dcpp {
 
 SharedMutex Hasher::hcs;
 const int64_t Hasher::MIN_BLOCK_SIZE = 64 * 1024;
+const int64_t Hasher::SMALL_FILE_SIZE = 10 * 1024 * 1024;
+
+#define MAX_STOLEN_FILES 100
+#define MAX_STOLEN_BYTES (100 * 1024 * 1024)
 
 
 Hasher::Hasher(bool aIsPaused, int aHasherID, HasherManager* aManager) : hasherID(aHasherID), manager(aManager), paused(aIsPaused) {
@@ -146,6 +150,58 @@ bool Hasher::hashFile(const string& fileName, const string& filePathLower, int64
 	return false;
 }
 
+size_t Hasher::stealFiles(Hasher& aVictim, const DeviceFilter& aCanHashDevice) noexcept {
+	// always locked
+	auto maxFiles = min<size_t>((aVictim.w.size() + 1) / 2, MAX_STOLEN_FILES);
+
+	vector<WorkItem> stolen;
+	int64_t stolenBytes = 0;
+	while (stolen.size() < maxFiles) {
+		auto& item = aVictim.w.back();
+		if (!hasDevice(item.deviceId) && !aCanHashDevice(item.deviceId)) {
+			break;
+		}
+
+		auto isSmall = item.fileSize <= SMALL_FILE_SIZE;
+		if (!stolen.empty() && (!isSmall || stolenBytes + item.fileSize > MAX_STOLEN_BYTES)) {
+			break;
+		}
+
+		stolenBytes += item.fileSize;
+		devices[item.deviceId]++;
+		aVictim.removeDevice(item.deviceId);
+
+		stolen.push_back(std::move(item));
+		aVictim.w.pop_back();
+
+		if (!isSmall) {
+			// Large files are CPU bound already
+			break;
+		}
+	}
+
+	if (stolen.empty()) {
+		return 0;
+	}
+
+	// Keep the progress of both hashers consistent
+	auto stolenFiles = static_cast<int64_t>(stolen.size());
+	aVictim.totalBytesLeft -= stolenBytes;
+	aVictim.totalBytesAdded -= stolenBytes;
+	aVictim.totalFilesAdded -= stolenFiles;
+
+	totalBytesLeft += stolenBytes;
+	totalBytesAdded += stolenBytes;
+	totalFilesAdded += stolenFiles;
+
+	// The items were taken from the end of the queue
+	for (auto i = stolen.rbegin(); i != stolen.rend(); ++i) {
+		w.emplace_sorted(i->filePathLower, i->filePath, i->fileSize, i->deviceId);
+	}
+
+	return stolen.size();
+}
+
 void Hasher::stopHashing(const string& aBaseDir) noexcept {
 	for (auto i = w.begin(); i != w.end();) {
 		if (PathUtil::isParentOrExact(aBaseDir, i->filePath, PATH_SEPARATOR)) {
@@ -356,7 +412,10 @@ void Hasher::processQueue() noexcept {
 
 		auto fi = hashFile(wi, dirStats, sfv);
 
+		// Written in the database after releasing the lock
+		auto flushFiles = false;
 		auto onDirHashed = [&]() {
+			flushFiles = true;
 			manager->onDirectoryHashed(initialDir, dirStats, hasherID);
 			logHashedDirectory(initialDir, wi.filePath, dirStats);
 
@@ -370,6 +429,11 @@ void Hasher::processQueue() noexcept {
 			WLock l(hcs);
 			removeDevice(wi.deviceId);
 
+			if (w.empty()) {
+				// Help the other hashers before finishing
+				manager->stealWork(*this);
+			}
+
 			if (w.empty()) {
 				// Finished hashing
 				running = false;
@@ -395,6 +459,7 @@ void Hasher::processQueue() noexcept {
 				}
 
 				clearStats();
+				flushFiles = true;
 				manager->onHasherFinished(totalDirsHashed, totalStats, hasherID);
 			} else if (!PathUtil::isParentOrExactLocal(initialDir, w.front().filePath)) {
 				onDirHashed();
@@ -402,6 +467,10 @@ void Hasher::processQueue() noexcept {
 
 			currentFile.clear();
 		}
+
+		if (flushFiles) {
+			manager->flushHashedFiles(hasherID);
+		}
 	}
 }
 
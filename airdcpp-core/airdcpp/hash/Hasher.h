@@ -38,6 +38,11 @@ namespace dcpp {
 		/** We don't keep leaves for blocks smaller than this... */
 		static const int64_t MIN_BLOCK_SIZE;
 
+		/** Files up to this size are dominated by open/close overhead and are moved between hashers in batches */
+		static const int64_t SMALL_FILE_SIZE;
+
+		using DeviceFilter = std::function<bool(devid)>;
+
 		Hasher(bool isPaused, int aHasherID, HasherManager* aManager);
 
 		bool hashFile(const string& filePath, const string& filePathLower, int64_t size, devid aDeviceId) noexcept;
@@ -62,6 +67,12 @@ namespace dcpp {
 		int64_t getTimeLeft() const noexcept;
 
 		int64_t getBytesLeft() const noexcept { return totalBytesLeft; }
+		size_t getQueuedFiles() const noexcept { return w.size(); }
+
+		// Move files from the end of another hasher's queue to this one (hasher lock must be held)
+		// Multiple small files or a single large one are taken at once and at least half of the queue is left for the other hasher
+		// aCanHashDevice is called for each device that this hasher isn't hashing yet
+		size_t stealFiles(Hasher& aVictim, const DeviceFilter& aCanHashDevice) noexcept;
 
 		const int hasherID;
 		static SharedMutex hcs;
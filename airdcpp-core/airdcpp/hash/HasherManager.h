@@ -25,6 +25,7 @@
 #include <airdcpp/message/Message.h>
 
 namespace dcpp {
+	class Hasher;
 	class HasherStats;
 	struct HasherManager {
 		virtual void onFileHashed(const string& aPath, HashedFile& aFile, const TigerTree& aTree, int aHasherId) noexcept = 0;
@@ -33,6 +34,14 @@ namespace dcpp {
 		virtual void onHasherFinished(int aDirectoriesHashed, const HasherStats&, int aHasherId) noexcept = 0;
 		virtual void logHasher(const string& aMessage, int aHasherID, LogMessage::Severity aSeverity, bool aLock) const noexcept = 0;
 		virtual void removeHasher(int aHasherId) noexcept = 0;
+
+		// Writes the files hashed so far in the database
+		// Called without the hasher lock as the write may take a while
+		virtual void flushHashedFiles(int aHasherId) noexcept = 0;
+
+		// Called with the hasher lock held when the hasher has run out of files
+		// Returns true if files were moved to the hasher from other hashers
+		virtual bool stealWork(Hasher& aHasher) noexcept = 0;
 	};
 } // namespace dcpp
 
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "stdinc.h"
+
+#include <airdcpp/hash/TreeCache.h>
+
+namespace dcpp {
+
+bool TreeCache::get(const TTHValue& aRoot, TigerTree& tt_) noexcept {
+	Lock l(cs);
+	auto i = index.find(aRoot);
+	if (i == index.end()) {
+		misses++;
+		return false;
+	}
+
+	hits++;
+	entries.splice(entries.begin(), entries, i->second);
+	tt_ = *i->second;
+	return true;
+}
+
+void TreeCache::put(const TigerTree& aTree) noexcept {
+	auto treeSize = getTreeSize(aTree);
+
+	Lock l(cs);
+	if (treeSize > maxSize) {
+		return;
+	}
+
+	auto i = index.find(aTree.getRoot());
+	if (i != index.end()) {
+		// Trees with the same root are identical
+		entries.splice(entries.begin(), entries, i->second);
+		return;
+	}
+
+	entries.push_front(aTree);
+	index.emplace(aTree.getRoot(), entries.begin());
+	size += treeSize;
+
+	evict();
+}
+
+void TreeCache::remove(const TTHValue& aRoot) noexcept {
+	Lock l(cs);
+	auto i = index.find(aRoot);
+	if (i == index.end()) {
+		return;
+	}
+
+	size -= getTreeSize(*i->second);
+	entries.erase(i->second);
+	index.erase(i);
+}
+
+void TreeCache::clear() noexcept {
+	Lock l(cs);
+	entries.clear();
+	index.clear();
+	size = 0;
+}
+
+void TreeCache::setMaxSize(int64_t aMaxSize) noexcept {
+	Lock l(cs);
+	maxSize = aMaxSize;
+	evict();
+}
+
+void TreeCache::evict() noexcept {
+	while (size > maxSize && !entries.empty()) {
+		const auto& tree = entries.back();
+		size -= getTreeSize(tree);
+		index.erase(tree.getRoot());
+		entries.pop_back();
+	}
+}
+
+int64_t TreeCache::getTreeSize(const TigerTree& aTree) noexcept {
+	return static_cast<int64_t>(sizeof(TigerTree) + aTree.getLeaves().size() * TTHValue::BYTES);
+}
+
+TreeCache::Stats TreeCache::getStats() const noexcept {
+	Lock l(cs);
+
+	Stats stats;
+	stats.hits = hits;
+	stats.misses = misses;
+	stats.entries = entries.size();
+	stats.size = size;
+	stats.maxSize = maxSize;
+	return stats;
+}
+
+} // namespace dcpp
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef DCPLUSPLUS_DCPP_TREE_CACHE_H
+#define DCPLUSPLUS_DCPP_TREE_CACHE_H
+
+#include <airdcpp/core/header/typedefs.h>
+#include <airdcpp/core/thread/CriticalSection.h>
+#include <airdcpp/hash/value/MerkleTree.h>
+
+#include <list>
+
+namespace dcpp {
+
+// LRU cache for decoded trees that are requested repeatedly (e.g. by uploads of popular files)
+class TreeCache {
+public:
+	explicit TreeCache(int64_t aMaxSize = 0) noexcept : maxSize(aMaxSize) {}
+
+	bool get(const TTHValue& aRoot, TigerTree& tt_) noexcept;
+	void put(const TigerTree& aTree) noexcept;
+	void remove(const TTHValue& aRoot) noexcept;
+	void clear() noexcept;
+
+	void setMaxSize(int64_t aMaxSize) noexcept;
+
+	struct Stats {
+		uint64_t hits = 0;
+		uint64_t misses = 0;
+		size_t entries = 0;
+		int64_t size = 0;
+		int64_t maxSize = 0;
+	};
+
+	Stats getStats() const noexcept;
+private:
+	using EntryList = std::list<TigerTree>;
+
+	static int64_t getTreeSize(const TigerTree& aTree) noexcept;
+	void evict() noexcept;
+
+	mutable CriticalSection cs;
+
+	// Most recently used trees first
+	EntryList entries;
+	unordered_map<TTHValue, EntryList::iterator> index;
+
+	int64_t size = 0;
+	int64_t maxSize;
+
+	uint64_t hits = 0;
+	uint64_t misses = 0;
+};
+
+} // namespace dcpp
+
+#endif // !defined(DCPLUSPLUS_DCPP_TREE_CACHE_H)
@@ -212,9 +212,14 @@ UserPtr ClientManager::getUser(const CID& aCID) noexcept {
 	}
 
 	UserPtr p(new User(aCID));
+	return addUser(p);
+}
+
+UserPtr ClientManager::addUser(const UserPtr& aUser) noexcept {
+	auto& shard = getUserShard(aUser->getCID());
 
-	WLock l(cs);
-	auto [userPair, _] = users.emplace(const_cast<CID*>(&p->getCID()), p);
+	WLock l(shard.cs);
+	auto [userPair, _] = shard.users.emplace(const_cast<CID*>(&aUser->getCID()), aUser);
 	return userPair->second;
 }
 
@@ -230,8 +235,10 @@ UserPtr ClientManager::loadUser(const string& aCID, const string& aUrl, const st
 }
 
 UserPtr ClientManager::findUser(const CID& aCID) const noexcept {
-	RLock l(cs);
-	if(auto ui = users.find(const_cast<CID*>(&aCID)); ui != users.end()) {
+	const auto& shard = getUserShard(aCID);
+
+	RLock l(shard.cs);
+	if (auto ui = shard.users.find(const_cast<CID*>(&aCID)); ui != shard.users.end()) {
 		return ui->second;
 	}
 	return nullptr;
@@ -240,8 +247,10 @@ UserPtr ClientManager::findUser(const CID& aCID) const noexcept {
 StringList ClientManager::getHubUrls(const CID& aCID) const noexcept {
 	StringList lst;
 
-	RLock l(cs);
-	auto op = onlineUsers.equal_range(const_cast<CID*>(&aCID));
+	const auto& shard = getUserShard(aCID);
+
+	RLock l(shard.cs);
+	auto op = shard.onlineUsers.equal_range(const_cast<CID*>(&aCID));
 	for (const auto& ou : op | pair_to_range | views::values) {
 		lst.push_back(ou->getClient()->getHubUrl());
 	}
@@ -256,8 +265,10 @@ OrderedStringSet ClientManager::getHubSet(const CID& aCID) const noexcept {
 StringList ClientManager::getHubNames(const CID& aCID) const noexcept {
 	StringList lst;
 
-	RLock l(cs);
-	auto op = onlineUsers.equal_range(const_cast<CID*>(&aCID));
+	const auto& shard = getUserShard(aCID);
+
+	RLock l(shard.cs);
+	auto op = shard.onlineUsers.equal_range(const_cast<CID*>(&aCID));
 	for (const auto& ou : op | pair_to_range | views::values) {
 		lst.push_back(ou->getClient()->getHubName());
 	}
@@ -267,9 +278,11 @@ StringList ClientManager::getHubNames(const CID& aCID) const noexcept {
 }
 
 void ClientManager::putOnline(const OnlineUserPtr& ou) noexcept {
+	auto& shard = getUserShard(ou->getUser()->getCID());
+
 	{
-		WLock l(cs);
-		onlineUsers.emplace(const_cast<CID*>(&ou->getUser()->getCID()), ou.get());
+		WLock l(shard.cs);
+		shard.onlineUsers.emplace(const_cast<CID*>(&ou->getUser()->getCID()), ou.get());
 	}
 	
 	if (!ou->getUser()->isOnline()) {
@@ -277,10 +290,10 @@ void ClientManager::putOnline(const OnlineUserPtr& ou) noexcept {
 		ou->getUser()->setFlag(User::ONLINE);
 
 		{
-			WLock l(cs);
-			auto i = offlineUsers.find(const_cast<CID*>(&ou->getUser()->getCID()));
-			if (i != offlineUsers.end())
-				offlineUsers.erase(i);
+			WLock l(shard.cs);
+			auto i = shard.offlineUsers.find(const_cast<CID*>(&ou->getUser()->getCID()));
+			if (i != shard.offlineUsers.end())
+				shard.offlineUsers.erase(i);
 		}
 
 		fire(ClientManagerListener::UserConnected(), *ou, true);
@@ -292,8 +305,10 @@ void ClientManager::putOnline(const OnlineUserPtr& ou) noexcept {
 void ClientManager::putOffline(const OnlineUserPtr& ou, bool aDisconnectTransfers) noexcept {
 	OnlineIter::difference_type diff = 0;
 	{
-		WLock l(cs);
-		auto [begin, end] = onlineUsers.equal_range(const_cast<CID*>(&ou->getUser()->getCID()));
+		auto& shard = getUserShard(ou->getUser()->getCID());
+
+		WLock l(shard.cs);
+		auto [begin, end] = shard.onlineUsers.equal_range(const_cast<CID*>(&ou->getUser()->getCID()));
 		dcassert(begin != end);
 		for(auto i = begin; i != end; ++i) {
 			auto ou2 = i->second;
@@ -306,10 +321,10 @@ void ClientManager::putOffline(const OnlineUserPtr& ou, bool aDisconnectTransfer
 				so we ensure that we should always find the user in atleast one of the lists.
 				*/
 				if (diff == 1) {
-					offlineUsers.try_emplace(const_cast<CID*>(&ou->getUser()->getCID()), ou->getIdentity().getNick(), ou->getHubUrl(), GET_TIME());
+					shard.offlineUsers.try_emplace(const_cast<CID*>(&ou->getUser()->getCID()), ou->getIdentity().getNick(), ou->getHubUrl(), GET_TIME());
 				}
 
-				onlineUsers.erase(i);
+				shard.onlineUsers.erase(i);
 				break;
 			}
 		}
@@ -330,8 +345,10 @@ void ClientManager::putOffline(const OnlineUserPtr& ou, bool aDisconnectTransfer
 }
 
 optional<OfflineUser> ClientManager::getOfflineUser(const CID& cid) {
-	RLock l(cs);
-	if (auto i = offlineUsers.find(const_cast<CID*>(&cid)); i != offlineUsers.end()) {
+	const auto& shard = getUserShard(cid);
+
+	RLock l(shard.cs);
+	if (auto i = shard.offlineUsers.find(const_cast<CID*>(&cid)); i != shard.offlineUsers.end()) {
 		return i->second;
 	}
 	return nullopt;
@@ -341,8 +358,10 @@ void ClientManager::addOfflineUser(const UserPtr& user, const string& aNick, con
 	if (!user || aNick.empty() || aUrl.empty())
 		return;
 
-	WLock l(cs);
-	auto [offlineUserPair, added] = offlineUsers.try_emplace(const_cast<CID*>(&user->getCID()), aNick, aUrl, lastSeen);
+	auto& shard = getUserShard(user->getCID());
+
+	WLock l(shard.cs);
+	auto [offlineUserPair, added] = shard.offlineUsers.try_emplace(const_cast<CID*>(&user->getCID()), aNick, aUrl, lastSeen);
 	if (!added && lastSeen > 0) {
 		offlineUserPair->second.setLastSeen(lastSeen);
 	}
@@ -365,16 +384,18 @@ StringList ClientManager::getNicks(const CID& aCID, bool aAllowCID /*true*/) con
 	OrderedStringSet ret;
 
 	{
-		RLock l(cs);
-		auto op = onlineUsers.equal_range(const_cast<CID*>(&aCID));
+		const auto& shard = getUserShard(aCID);
+
+		RLock l(shard.cs);
+		auto op = shard.onlineUsers.equal_range(const_cast<CID*>(&aCID));
 		for (const auto& ou: op | pair_to_range | views::values) {
 			ret.insert(ou->getIdentity().getNick());
 		}
 
 		if(ret.empty()) {
 			// offline
-			auto i = offlineUsers.find(const_cast<CID*>(&aCID));
-			if (i != offlineUsers.end()) {
+			auto i = shard.offlineUsers.find(const_cast<CID*>(&aCID));
+			if (i != shard.offlineUsers.end()) {
 				ret.insert(i->second.getNick());
 			} else if (aAllowCID) {
 				ret.insert('{' + aCID.toBase32() + '}');
@@ -389,10 +410,12 @@ string ClientManager::getFormattedNicks(const HintedUser& aUser) const noexcept
 	auto ret = formatUserProperty<OnlineUser::Nick>(aUser, true);
 	if (ret.empty()) {
 		// offline
-		RLock l(cs);
-		auto i = offlineUsers.find(const_cast<CID*>(&aUser.user->getCID()));
-		//dcassert(i != offlineUsers.end());
-		if (i != offlineUsers.end()) {
+		const auto& shard = getUserShard(aUser.user->getCID());
+
+		RLock l(shard.cs);
+		auto i = shard.offlineUsers.find(const_cast<CID*>(&aUser.user->getCID()));
+		//dcassert(i != shard.offlineUsers.end());
+		if (i != shard.offlineUsers.end()) {
 			return i->second.getNick();
 		}
 	}
@@ -401,9 +424,11 @@ string ClientManager::getFormattedNicks(const HintedUser& aUser) const noexcept
 
 string ClientManager::getNick(const UserPtr& aUser, const string& aHubUrl, bool aAllowFallback /*true*/) const noexcept {
 	{
-		RLock l(cs);
+		const auto& shard = getUserShard(aUser->getCID());
+
+		RLock l(shard.cs);
 		OnlinePairC p;
-		if (auto ou = findOnlineUserHintUnsafe(aUser->getCID(), aHubUrl, p)) {
+		if (auto ou = findOnlineUserHintUnsafe(shard, aUser->getCID(), aHubUrl, p)) {
 			return ou->getIdentity().getNick();
 		}
 
@@ -412,8 +437,8 @@ string ClientManager::getNick(const UserPtr& aUser, const string& aHubUrl, bool
 				return p.first->second->getIdentity().getNick();
 			} else {
 				// offline
-				auto i = offlineUsers.find(const_cast<CID*>(&aUser->getCID()));
-				if (i != offlineUsers.end()) {
+				auto i = shard.offlineUsers.find(const_cast<CID*>(&aUser->getCID()));
+				if (i != shard.offlineUsers.end()) {
 					return i->second.getNick();
 				}
 			}
@@ -434,9 +459,11 @@ string ClientManager::getFormattedHubNames(const HintedUser& aUser) const noexce
 }
 
 string ClientManager::getField(const CID& aCID, const string& aHint, const char* aField) const noexcept {
-	RLock l(cs);
+	const auto& shard = getUserShard(aCID);
+
+	RLock l(shard.cs);
 	OnlinePairC p;
-	if (auto u = findOnlineUserHintUnsafe(aCID, aHint, p)) {
+	if (auto u = findOnlineUserHintUnsafe(shard, aCID, aHint, p)) {
 		auto value = u->getIdentity().get(aField);
 		if (!value.empty()) {
 			return value;
@@ -457,8 +484,10 @@ string ClientManager::getField(const CID& aCID, const string& aHint, const char*
 OnlineUserList ClientManager::getOnlineUsers(const UserPtr& aUser) const noexcept {
 	OnlineUserList ouList;
 
-	RLock l(cs);
-	auto p = onlineUsers.equal_range(const_cast<CID*>(&aUser->getCID()));
+	const auto& shard = getUserShard(aUser->getCID());
+
+	RLock l(shard.cs);
+	auto p = shard.onlineUsers.equal_range(const_cast<CID*>(&aUser->getCID()));
 	ranges::copy(p | pair_to_range | views::values, back_inserter(ouList));
 	return ouList;
 }
@@ -477,8 +506,8 @@ OnlineUserPtr ClientManager::getOnlineUsers(const HintedUser& aUser, OnlineUserL
 	return nullptr;
 }
 
-OnlineUser* ClientManager::findOnlineUserHintUnsafe(const CID& aCID, const string_view& aHintUrl, OnlinePairC& p) const noexcept {
-	p = onlineUsers.equal_range(const_cast<CID*>(&aCID));
+OnlineUser* ClientManager::findOnlineUserHintUnsafe(const UserShard& aShard, const CID& aCID, const string_view& aHintUrl, OnlinePairC& p) noexcept {
+	p = aShard.onlineUsers.equal_range(const_cast<CID*>(&aCID));
 	if (p.first == p.second) // no user found with the given CID.
 		return nullptr;
 
@@ -498,10 +527,12 @@ OnlineUserPtr ClientManager::findOnlineUser(const HintedUser& aUser, bool aAllow
 }
 
 OnlineUserPtr ClientManager::findOnlineUser(const CID& cid, const string& hintUrl, bool aAllowFallback) const noexcept {
-	RLock l(cs);
+	const auto& shard = getUserShard(cid);
+
+	RLock l(shard.cs);
 
 	OnlinePairC p;
-	auto u = findOnlineUserHintUnsafe(cid, hintUrl, p);
+	auto u = findOnlineUserHintUnsafe(shard, cid, hintUrl, p);
 	if (u) // found an exact match (CID + hint).
 		return u;
 
@@ -513,8 +544,10 @@ OnlineUserPtr ClientManager::findOnlineUser(const CID& cid, const string& hintUr
 }
 
 void ClientManager::userUpdated(const UserPtr& aUser) const noexcept {
-	RLock l(cs);
-	auto op = onlineUsers.equal_range(const_cast<CID*>(&aUser->getCID()));
+	const auto& shard = getUserShard(aUser->getCID());
+
+	RLock l(shard.cs);
+	auto op = shard.onlineUsers.equal_range(const_cast<CID*>(&aUser->getCID()));
 	for (const auto& ou : op | pair_to_range | views::values) {
 		ou->getClient()->callAsync([ou] {
 			ou->getClient()->updated(ou);
@@ -532,13 +565,15 @@ optional<ClientManager::ShareInfo> ClientManager::getShareInfo(const HintedUser&
 }
 
 void ClientManager::forEachOnlineUser(const OnlineUserCallback& aCallback, bool aIgnoreBots) const noexcept {
-	RLock l(cs);
-	for (const auto& u : onlineUsers | views::values) {
-		if (aIgnoreBots && u->getUser()->isSet(User::BOT)) {
-			continue;
-		}
+	for (const auto& shard: userShards) {
+		RLock l(shard.cs);
+		for (const auto& u : shard.onlineUsers | views::values) {
+			if (aIgnoreBots && u->getUser()->isSet(User::BOT)) {
+				continue;
+			}
 
-		aCallback(u);
+			aCallback(u);
+		}
 	}
 }
 
@@ -546,8 +581,10 @@ User::UserInfoList ClientManager::getUserInfoList(const UserPtr& aUser) const no
 	User::UserInfoList ret;
 
 	{
-		RLock l(cs);
-		auto op = onlineUsers.equal_range(const_cast<CID*>(&aUser->getCID()));
+		const auto& shard = getUserShard(aUser->getCID());
+
+		RLock l(shard.cs);
+		auto op = shard.onlineUsers.equal_range(const_cast<CID*>(&aUser->getCID()));
 		for (const auto& ou : op | pair_to_range | views::values) {
 			ret.emplace_back(ou->getHubUrl(), ou->getClient()->getHubName(), Util::toInt64(ou->getIdentity().getShareSize()));
 		}
@@ -854,14 +891,16 @@ bool ClientManager::connectADCSearchHubUnsafe(string& token_, string& hubUrl_) c
 }
 
 bool ClientManager::connectADCSearchResult(const CID& aCID, string& token_, string& hubUrl_, string& connection_, uint8_t& slots_) const noexcept {
-	RLock l(cs);
 	if (!connectADCSearchHubUnsafe(token_, hubUrl_)) {
 		return false;
 	}
 
 	// get the connection and total slots
+	const auto& shard = getUserShard(aCID);
+
+	RLock l(shard.cs);
 	OnlinePairC p;
-	auto ou = findOnlineUserHintUnsafe(aCID, hubUrl_, p);
+	auto ou = findOnlineUserHintUnsafe(shard, aCID, hubUrl_, p);
 	if (ou) {
 		slots_ = ou->getIdentity().getSlots();
 		connection_ = ou->getIdentity().getConnectionString();
@@ -949,18 +988,16 @@ optional<ClientManager::ClientStats> ClientManager::getClientStats() const noexc
 	ClientStats stats;
 
 	map<string, int> clientNames;
-	{
-		RLock l(cs);
+	for (const auto& shard: userShards) {
+		// Users with the same CID are always in the same shard
+		RLock l(shard.cs);
 		map<CID, OnlineUser*> uniqueUserMap;
-		for (const auto& ou : onlineUsers | views::values) {
+		for (const auto& ou : shard.onlineUsers | views::values) {
 			uniqueUserMap.try_emplace(ou->getUser()->getCID(), ou);
 		}
 
-		stats.totalUsers = static_cast<int>(onlineUsers.size());
-		stats.uniqueUsers = static_cast<int>(uniqueUserMap.size());
-		if (stats.uniqueUsers == 0) {
-			return nullopt;
-		}
+		stats.totalUsers += static_cast<int>(shard.onlineUsers.size());
+		stats.uniqueUsers += static_cast<int>(uniqueUserMap.size());
 
 		// User counts
 		for (const auto& ou : uniqueUserMap | views::values) {
@@ -980,6 +1017,10 @@ optional<ClientManager::ClientStats> ClientManager::getClientStats() const noexc
 		}
 	}
 
+	if (stats.uniqueUsers == 0) {
+		return nullopt;
+	}
+
 	auto countCompare = [](const pair<string, int>& i, const pair<string, int>& j) -> bool {
 		return (i.second > j.second);
 	};
@@ -1009,11 +1050,8 @@ UserPtr& ClientManager::getMe() noexcept {
 		TigerHash tiger;
 		tiger.update(getMyPID().data(), CID::SIZE);
 
-		auto newMe = new User(CID(tiger.finalize()));
-
-		WLock l(cs);
-		auto [user, _] = users.emplace(const_cast<CID*>(&newMe->getCID()), newMe);
-		me = user->second;
+		UserPtr newMe(new User(CID(tiger.finalize())));
+		me = addUser(newMe);
 	}
 	return me;
 }
@@ -1036,8 +1074,10 @@ void ClientManager::setNmdcIPUser(const UserPtr& user, const string& IP, const s
 	if (IP.empty())
 		return;
 
-	RLock l(cs);
-	auto op = onlineUsers.equal_range(const_cast<CID*>(&user->getCID()));
+	const auto& shard = getUserShard(user->getCID());
+
+	RLock l(shard.cs);
+	auto op = shard.onlineUsers.equal_range(const_cast<CID*>(&user->getCID()));
 	for (const auto& ou : op | pair_to_range | views::values) {
 		ou->getIdentity().setIp4(IP);
 		if (!aUdpPort.empty()) {
@@ -1132,9 +1172,11 @@ UserPtr ClientManager::getNmdcUser(const string& aNick, const string& aHubUrl) n
 	auto cid = makeNmdcCID(aNick, aHubUrl);
 
 	{
-		RLock l(cs);
-		auto ui = users.find(&cid);
-		if(ui != users.end()) {
+		const auto& shard = getUserShard(cid);
+
+		RLock l(shard.cs);
+		auto ui = shard.users.find(&cid);
+		if(ui != shard.users.end()) {
 			dcassert(ui->second->getCID() == cid);
 			ui->second->setFlag(User::NMDC);
 			return ui->second;
@@ -1147,10 +1189,7 @@ UserPtr ClientManager::getNmdcUser(const string& aNick, const string& aHubUrl) n
 
 	UserPtr p(new User(cid));
 	p->setFlag(User::NMDC);
-
-	WLock l(cs);
-	auto [userPair,_] = users.emplace(const_cast<CID*>(&p->getCID()), p);
-	return userPair->second;
+	return addUser(p);
 }
 
 CID ClientManager::makeNmdcCID(const string& aNick, const string& aHubUrl) const noexcept {
@@ -1194,18 +1233,20 @@ void ClientManager::on(TimerManagerListener::Minute, uint64_t aTick) noexcept {
 }
 
 void ClientManager::cleanUserMap() noexcept {
-	WLock l(cs);
-
-	// Collect some garbage...
-	auto i = users.begin();
-	while (i != users.end()) {
-		dcassert(i->second->getCID() == *i->first);
-		if (i->second.use_count() == 1) {
-			if (auto n = offlineUsers.find(const_cast<CID*>(&i->second->getCID())); n != offlineUsers.end())
-				offlineUsers.erase(n);
-			users.erase(i++);
-		} else {
-			++i;
+	for (auto& shard: userShards) {
+		WLock l(shard.cs);
+
+		// Collect some garbage...
+		auto i = shard.users.begin();
+		while (i != shard.users.end()) {
+			dcassert(i->second->getCID() == *i->first);
+			if (i->second.use_count() == 1) {
+				if (auto n = shard.offlineUsers.find(const_cast<CID*>(&i->second->getCID())); n != shard.offlineUsers.end())
+					shard.offlineUsers.erase(n);
+				shard.users.erase(i++);
+			} else {
+				++i;
+			}
 		}
 	}
 }
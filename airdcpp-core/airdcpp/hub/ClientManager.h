@@ -34,6 +34,8 @@
 #include <airdcpp/core/Singleton.h>
 #include <airdcpp/core/timer/TimerManager.h>
 
+#include <array>
+
 
 namespace dcpp {
 
@@ -161,9 +163,6 @@ public:
 	UserPtr getUser(const CID& cid) noexcept;
 	UserPtr loadUser(const string& aCID, const string& aUrl, const string& aNick, time_t aLastSeen = GET_TIME()) noexcept;
 
-	// usage needs to be locked!
-	const UserMap& getUsersUnsafe() const { return users; }
-
 	// Return OnlineUser found by CID and hint
 	// aAllowFallback: return OnlineUserPtr from any hub if the hinted one is not found
 	OnlineUserPtr findOnlineUser(const HintedUser& aUser, bool aAllowFallback = true) const noexcept;
@@ -314,14 +313,28 @@ private:
 	using OnlinePair = pair<OnlineIter, OnlineIter>;
 	using OnlinePairC = pair<OnlineIterC, OnlineIterC>;
 	
+	// Guards clients only, users are stored in the shards
 	Client::UrlMap clients;
 	Client::IdMap clientsById;
 	mutable SharedMutex cs;
-	
-	UserMap users;
-	OnlineMap onlineUsers;
 
-	OfflineUserMap offlineUsers;
+	// All entries of a CID are always stored in the same shard so that single-user lookups 
+	// and the online/offline transitions only need to lock that shard
+	// (user join/quit floods in large hubs won't block lookups for users in other shards)
+	struct alignas(64) UserShard {
+		mutable SharedMutex cs;
+
+		UserMap users;
+		OnlineMap onlineUsers;
+		OfflineUserMap offlineUsers;
+	};
+
+	static const size_t USER_SHARD_COUNT = 16;
+	array<UserShard, USER_SHARD_COUNT> userShards;
+
+	// The maps hash the first bytes of the CID, use the last one for selecting the shard
+	UserShard& getUserShard(const CID& aCID) noexcept { return userShards[aCID.data()[CID::SIZE - 1] % USER_SHARD_COUNT]; }
+	const UserShard& getUserShard(const CID& aCID) const noexcept { return userShards[aCID.data()[CID::SIZE - 1] % USER_SHARD_COUNT]; }
 
 	UserPtr me;
 
@@ -336,16 +349,14 @@ private:
 
 	~ClientManager() override;
 
-	/// @return OnlineUser* found by CID and hint; discard any user that doesn't match the hint.
-	OnlineUser* findOnlineUserHintUnsafe(const CID& aCID, const string& aHubUrl) const noexcept {
-		OnlinePairC p;
-		return findOnlineUserHintUnsafe(aCID, aHubUrl, p);
-	}
 	/**
+	* The shard of the CID must be locked
 	* @param p OnlinePair of all the users found by CID, even those who don't match the hint.
 	* @return OnlineUser* found by CID and hint; discard any user that doesn't match the hint.
 	*/
-	OnlineUser* findOnlineUserHintUnsafe(const CID& aCID, const string_view& aHubUrl, OnlinePairC& p) const noexcept;
+	static OnlineUser* findOnlineUserHintUnsafe(const UserShard& aShard, const CID& aCID, const string_view& aHubUrl, OnlinePairC& p) noexcept;
+
+	UserPtr addUser(const UserPtr& aUser) noexcept;
 
 	// ClientListener
 	void on(ClientListener::Connected, const Client* c) noexcept override;
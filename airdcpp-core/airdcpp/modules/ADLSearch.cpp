@@ -433,7 +433,7 @@ void ADLSearchManager::MatchesFile(DestDirList& destDirVector, const DirectoryLi
 	// Add to any substructure being stored
 	for(auto& id: destDirVector) {
 		if(id.subdir) {
-			auto copyFile = make_shared<DirectoryListing::File>(*currentFile, this);
+			auto copyFile = DirectoryListing::File::copy(*currentFile, this);
 			dcassert(id.subdir->isVirtual());
 
 			id.subdir->files.push_back(copyFile);
@@ -457,7 +457,7 @@ void ADLSearchManager::MatchesFile(DestDirList& destDirVector, const DirectoryLi
 			continue;
 		}
 		if(is.matchesFile(currentFile->getName(), nmdcPath, currentFile->getSize())) {
-			auto copyFile = make_shared<DirectoryListing::File>(*currentFile, this);
+			auto copyFile = DirectoryListing::File::copy(*currentFile, this);
 			destDirVector[is.ddIndex].dir->files.push_back(copyFile);
 			destDirVector[is.ddIndex].fileAdded = true;
 
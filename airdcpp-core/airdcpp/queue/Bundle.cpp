@@ -50,7 +50,7 @@ Bundle::Bundle(const QueueItemPtr& qi, time_t aFileDate, QueueToken aToken /*0*/
 }
 
 Bundle::Bundle(const string& aTarget, time_t aAdded, Priority aPriority, time_t aBundleDate /*0*/, QueueToken aToken /*0*/, bool aDirty /*true*/, bool aIsFileBundle /*false*/) noexcept :
-	QueueItemBase(PathUtil::validatePath(aTarget, !aIsFileBundle), 0, aPriority, aAdded, aToken, 0), bundleDate(aBundleDate), fileBundle(aIsFileBundle), dirty(aDirty) {
+	QueueItemBase(0, aPriority, aAdded, aToken, 0), bundleDate(aBundleDate), target(PathUtil::validatePath(aTarget, !aIsFileBundle)), fileBundle(aIsFileBundle), dirty(aDirty) {
 
 	if (aToken == 0) {
 		token = Util::toUInt32(ConnectionManager::getInstance()->tokens.createToken(CONNECTION_TYPE_DOWNLOAD));
@@ -210,7 +210,7 @@ bool Bundle::getDirty() const noexcept {
 }
 
 QueueItemPtr Bundle::findQI(const string& aTarget) const noexcept {
-	auto p = ranges::find_if(queueItems, [&aTarget](const QueueItemPtr& q) { return q->getTarget() == aTarget; });
+	auto p = ranges::find_if(queueItems, [&aTarget](const QueueItemPtr& q) { return q->getQueueTarget() == aTarget; });
 	return p != queueItems.end() ? *p : nullptr;
 }
 
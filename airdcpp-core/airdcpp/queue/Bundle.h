@@ -228,6 +228,7 @@ public:
 	void rotateUserQueue(const QueueItemPtr& qi, const UserPtr& aUser) noexcept;
 	bool isEmpty() const noexcept { return queueItems.empty() && finishedFiles.empty(); }
 private:
+	const string target;
 	ActionHookRejectionPtr hookError = nullptr;
 
 	int64_t finishedSegments = 0;
@@ -39,7 +39,7 @@ pair<QueueItemPtr, bool> FileQueue::add(const string& aTarget, int64_t aSize, Fl
 }
 
 pair<QueueItem::StringMap::const_iterator, bool> FileQueue::add(QueueItemPtr& qi) noexcept {
-	auto ret = pathQueue.try_emplace(const_cast<string*>(&qi->getTarget()), qi);
+	auto ret = pathQueue.try_emplace(QueueTarget::Key(qi->getQueueTarget()), qi);
 	if (ret.second) {
 		qi->setStatus(QueueItem::STATUS_QUEUED);
 		tthIndex.emplace(const_cast<TTHValue*>(&qi->getTTH()), qi);
@@ -50,7 +50,7 @@ pair<QueueItem::StringMap::const_iterator, bool> FileQueue::add(QueueItemPtr& qi
 
 void FileQueue::remove(const QueueItemPtr& qi) noexcept {
 	//TargetMap
-	if (auto f = pathQueue.find(const_cast<string*>(&qi->getTarget())); f != pathQueue.end()) {
+	if (auto f = pathQueue.find(QueueTarget::Key(qi->getQueueTarget())); f != pathQueue.end()) {
 		pathQueue.erase(f);
 	}
 
@@ -68,7 +68,7 @@ void FileQueue::remove(const QueueItemPtr& qi) noexcept {
 }
 
 QueueItemPtr FileQueue::findFile(const string& target) const noexcept {
-	auto i = pathQueue.find(const_cast<string*>(&target));
+	auto i = pathQueue.find(QueueTarget::Key(target));
 	return (i == pathQueue.end()) ? nullptr : i->second;
 }
 
@@ -81,25 +81,55 @@ void FileQueue::findFiles(const TTHValue& tth, QueueItemList& ql_) const noexcep
 	ranges::copy(tthIndex.equal_range(const_cast<TTHValue*>(&tth)) | pair_to_range | views::values, back_inserter(ql_));
 }
 
-void FileQueue::matchListing(const DirectoryListing& dl, QueueItemList& ql_) const noexcept {
-	matchDir(dl.getRoot(), ql_);
+FileQueue::ListingFileList FileQueue::getListingFiles(const DirectoryListing& aList) noexcept {
+	ListingFileList ret;
+	getListingFiles(aList.getRoot(), ret);
+
+	// Each queued file can match only a single entry after this
+	sort(ret.begin(), ret.end());
+	ret.erase(unique(ret.begin(), ret.end()), ret.end());
+	return ret;
 }
 
-void FileQueue::matchDir(const DirectoryListing::Directory::Ptr& aDir, QueueItemList& ql_) const noexcept {
+void FileQueue::getListingFiles(const DirectoryListing::Directory::Ptr& aDir, ListingFileList& files_) noexcept {
 	for (const auto& d : aDir->directories | views::values) {
 		if (!d->isVirtual()) {
-			matchDir(d, ql_);
+			getListingFiles(d, files_);
 		}
 	}
 
 	for (const auto& f : aDir->files) {
-		auto tthRange = tthIndex.equal_range(const_cast<TTHValue*>(&f->getTTH()));
+		files_.emplace_back(f->getTTH(), f->getSize());
+	}
+}
 
-		ranges::for_each(tthRange | pair_to_range, [&](const pair<TTHValue*, QueueItemPtr>& tqp) {
-			if (!tqp.second->isDownloaded() && tqp.second->getSize() == f->getSize() && ranges::find(ql_, tqp.second) == ql_.end()) {
-				ql_.push_back(tqp.second);
+void FileQueue::matchListing(const ListingFileList& aFiles, QueueItemList& ql_) const noexcept {
+	auto addMatch = [&ql_](const QueueItemPtr& aQI, int64_t aSize) {
+		if (!aQI->isDownloaded() && aQI->getSize() == aSize) {
+			ql_.push_back(aQI);
+		}
+	};
+
+	if (aFiles.size() <= tthIndex.size()) {
+		// Small listing, look up the listing files from the queue
+		for (const auto& [tth, size] : aFiles) {
+			for (const auto& qi : tthIndex.equal_range(const_cast<TTHValue*>(&tth)) | pair_to_range | views::values) {
+				addMatch(qi, size);
+			}
+		}
+	} else {
+		// Large listing, look up the queued files from the sorted listing
+		struct TTHCompare {
+			bool operator()(const ListingFile& a, const TTHValue& b) const noexcept { return a.first < b; }
+			bool operator()(const TTHValue& a, const ListingFile& b) const noexcept { return a < b.first; }
+		};
+
+		for (const auto& [tth, qi] : tthIndex) {
+			auto listingRange = equal_range(aFiles.begin(), aFiles.end(), *tth, TTHCompare());
+			for (const auto& f : listingRange | pair_to_range) {
+				addMatch(qi, f.second);
 			}
-		});
+		}
 	}
 }
 
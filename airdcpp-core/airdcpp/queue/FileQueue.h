@@ -45,8 +45,17 @@ public:
 	QueueItemPtr findFile(QueueToken aToken) const noexcept;
 
 	void findFiles(const TTHValue& tth, QueueItemList& ql_) const noexcept;
-	void matchListing(const DirectoryListing& dl, QueueItemList& ql_) const noexcept;
-	void matchDir(const DirectoryListing::Directory::Ptr& dir, QueueItemList& ql_) const noexcept;
+
+	// TTH and size of a file in a filelist
+	using ListingFile = pair<TTHValue, int64_t>;
+	using ListingFileList = vector<ListingFile>;
+
+	// Unique files of the listing sorted by TTH
+	// Doesn't access the queue so the caller doesn't need to hold the queue lock
+	static ListingFileList getListingFiles(const DirectoryListing& aList) noexcept;
+
+	// Add unfinished queued files included in the listing files (from getListingFiles)
+	void matchListing(const ListingFileList& aFiles, QueueItemList& ql_) const noexcept;
 
 	size_t getSize() noexcept { return pathQueue.size(); }
 	QueueItem::StringMap& getPathQueue() noexcept { return pathQueue; }
@@ -58,6 +67,8 @@ public:
 	DupeType isFileQueued(const TTHValue& aTTH) const noexcept;
 	QueueItemPtr getQueuedFile(const TTHValue& aTTH) const noexcept;
 private:
+	static void getListingFiles(const DirectoryListing::Directory::Ptr& aDir, ListingFileList& files_) noexcept;
+
 	QueueItem::StringMap pathQueue;
 	QueueItem::TTHMap tthIndex;
 	QueueItem::TokenMap tokenQueue;
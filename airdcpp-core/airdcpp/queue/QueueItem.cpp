@@ -48,8 +48,8 @@ namespace {
 
 QueueItem::QueueItem(const string& aTarget, int64_t aSize, Priority aPriority, Flags::MaskType aFlag,
 		time_t aAdded, const TTHValue& tth, const string& aTempTarget) :
-		QueueItemBase(aTarget, aSize, aPriority, aAdded, idCounter.next(), aFlag),
-		tthRoot(tth), tempTarget(aTempTarget)
+		QueueItemBase(aSize, aPriority, aAdded, idCounter.next(), aFlag),
+		tthRoot(tth), target(aTarget), tempTarget(aTempTarget)
 {	
 	using enum dcpp::Priority;
 
@@ -78,6 +78,11 @@ QueueItem::QueueItem(const string& aTarget, int64_t aSize, Priority aPriority, F
 
 		maxSegments = getMaxSegments(size);
 	}
+
+	if (!isFilelist() && isDefaultTempTarget(tempTarget)) {
+		// Don't keep a second copy of the full path in memory before the item is started
+		tempTarget = string();
+	}
 }
 
 int64_t QueueItem::getBlockSize() noexcept {
@@ -90,26 +95,36 @@ int64_t QueueItem::getBlockSize() noexcept {
 }
 
 bool QueueItem::AlphaSortOrder::operator()(const QueueItemPtr& left, const QueueItemPtr& right) const noexcept {
-	auto extLeft = left->getTarget().rfind('.');
-	auto extRight = right->getTarget().rfind('.');
+	const auto& dirLeft = left->getFilePath();
+	const auto& dirRight = right->getFilePath();
+	if (&dirLeft != &dirRight) {
+		// Different directories, the extensions don't matter
+		return left->getQueueTarget().compare(right->getQueueTarget()) < 0;
+	}
+
+	const auto& nameLeft = left->getTargetFileName();
+	const auto& nameRight = right->getTargetFileName();
+
+	auto extLeft = nameLeft.rfind('.');
+	auto extRight = nameRight.rfind('.');
 	if (extLeft != string::npos && extRight != string::npos && 
-		compare(left->getTarget().substr(0, extLeft), right->getTarget().substr(0, extRight)) == 0) {
+		nameLeft.compare(0, extLeft, nameRight, 0, extRight) == 0) {
 
 		//only the extensions differs, .rar comes before .rXX
 		auto isRxx = [](const string& aPath, size_t extPos) {
 			return aPath.length() - extPos == 4 && aPath[extPos+1] == 'r' && isdigit(aPath[extPos+2]);
 		};
 
-		if (Util::stricmp(left->getTarget().substr(extLeft), ".rar") == 0 && isRxx(right->getTarget(), extRight)) {
+		if (Util::stricmp(nameLeft.c_str() + extLeft, ".rar") == 0 && isRxx(nameRight, extRight)) {
 			return true;
 		}
 
-		if (Util::stricmp(right->getTarget().substr(extRight), ".rar") == 0 && isRxx(left->getTarget(), extLeft)) {
+		if (Util::stricmp(nameRight.c_str() + extRight, ".rar") == 0 && isRxx(nameLeft, extLeft)) {
 			return false;
 		}
 	}
 
-	return compare(left->getTarget(), right->getTarget()) < 0;
+	return compare(nameLeft, nameRight) < 0;
 }
 
 /* This has a few extra checks because the size is unknown for filelists */
@@ -159,7 +174,7 @@ Priority QueueItem::calculateAutoPriority() const noexcept {
 
 bool QueueItem::hasPartialSharingTarget() noexcept {
 	// don't share when the file does not exist
-	if(!PathUtil::fileExists(isDownloaded() ? target : getTempTarget()))
+	if(!PathUtil::fileExists(isDownloaded() ? getTarget() : getTempTarget()))
 		return false;
 
 	return true;
@@ -228,11 +243,11 @@ string QueueItem::getStatusString(int64_t aDownloadedBytes, bool aIsWaiting) con
 string QueueItem::getListName() const noexcept {
 	dcassert(isSet(QueueItem::FLAG_USER_LIST));
 	if (isSet(QueueItem::FLAG_PARTIAL_LIST)) {
-		return target;
+		return getTarget();
 	} else if(isSet(QueueItem::FLAG_XML_BZLIST)) {
-		return target + ".xml.bz2";
+		return getTarget() + ".xml.bz2";
 	} else {
-		return target + ".xml";
+		return getTarget() + ".xml";
 	}
 }
 
@@ -324,9 +339,9 @@ const string& QueueItem::getTempTarget() noexcept {
 	}
 
 	if (isSet(FLAG_OPEN) || isSet(FLAG_CLIENT_VIEW)) {
-		setTempTarget(target);
+		setTempTarget(getTarget());
 	} else if (tempTarget.empty()) {
-		setTempTarget(target + TEMP_EXTENSION);
+		setTempTarget(getTarget() + TEMP_EXTENSION);
 	}
 
 	return tempTarget;
@@ -341,6 +356,13 @@ void QueueItem::setTempTarget(const string& aTempTarget) noexcept {
 	tempTarget = aTempTarget;
 }
 
+bool QueueItem::isDefaultTempTarget(const string& aTempTarget) const noexcept {
+	auto targetSize = target.size();
+	return aTempTarget.size() == targetSize + TEMP_EXTENSION.size() &&
+		target == aTempTarget.substr(0, targetSize) &&
+		aTempTarget.compare(targetSize, string::npos, TEMP_EXTENSION) == 0;
+}
+
 const string& QueueItem::getListDirectoryPath() const noexcept {
 	dcassert(isFilelist());
 	dcassert(!tempTarget.empty());
@@ -771,13 +793,7 @@ bool QueueItem::usesSmallSlot() const noexcept {
 }
 
 
-string QueueItem::getTargetFileName() const noexcept {
-	return PathUtil::getFileName(target); 
-}
 
-string QueueItem::getFilePath() const noexcept {
-	return PathUtil::getFilePath(target); 
-}
 
 QueueItemPtr QueueItem::pickSearchItem(const QueueItemList& aItems) noexcept {
 	QueueItemPtr searchItem = nullptr;
@@ -831,7 +847,7 @@ void QueueItem::save(OutputStream &f, string tmp, string b32tmp) const {
 
 	f.write(indent);
 	f.write(LIT(" Target=\""));
-	f.write(SimpleXML::escape(target, tmp, true));
+	f.write(SimpleXML::escape(getTarget(), tmp, true));
 	f.write(LIT("\" Size=\""));
 	f.write(Util::toString(size));
 	f.write(LIT("\" Added=\""));
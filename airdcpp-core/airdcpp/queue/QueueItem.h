@@ -21,6 +21,7 @@
 
 #include <airdcpp/queue/QueueItemBase.h>
 #include <airdcpp/queue/QueueDownloadInfo.h>
+#include <airdcpp/queue/QueueTarget.h>
 
 #include <airdcpp/core/classes/FastAlloc.h>
 #include <airdcpp/core/classes/IncrementingIdCounter.h>
@@ -34,8 +35,9 @@ namespace dcpp {
 class QueueItem : public QueueItemBase {
 public:
 	using TokenMap = unordered_map<QueueToken, QueueItemPtr>;
-	using StringMap = unordered_map<string *, QueueItemPtr, noCaseStringHash, noCaseStringEq>;
+	using StringMap = unordered_map<QueueTarget::Key, QueueItemPtr, QueueTarget::NoCaseHash, QueueTarget::NoCaseEq>;
 	using TTHMap = unordered_multimap<TTHValue *, QueueItemPtr>;
+	using Set = unordered_set<QueueItemPtr>;
 	using ItemBoolList = vector<pair<QueueItemPtr, bool>>;
 
 	struct HashComp {
@@ -183,8 +185,12 @@ public:
 	SourceList& getBadSources() noexcept { return badSources; }
 	const SourceList& getBadSources() const noexcept { return badSources; }
 
-	string getTargetFileName() const noexcept;
-	string getFilePath() const noexcept;
+	// The full path is constructed on each call (use the directory and file name parts when possible)
+	string getTarget() const noexcept { return target.str(); }
+	const QueueTarget& getQueueTarget() const noexcept { return target; }
+
+	const string& getTargetFileName() const noexcept { return target.getFileName(); }
+	const string& getFilePath() const noexcept { return target.getDirectory(); }
 
 	SourceIter getSource(const UserPtr& aUser) noexcept { return find(sources.begin(), sources.end(), aUser); }
 	SourceIter getBadSource(const UserPtr& aUser) noexcept { return find(badSources.begin(), badSources.end(), aUser); }
@@ -252,6 +258,7 @@ public:
 	const string& getListDirectoryPath() const noexcept;
 	string getStatusString(int64_t aDownloadedBytes, bool aIsWaiting) const noexcept;
 
+	// Temp targets with the default naming are only stored after the item has been started
 	const string& getTempTarget() noexcept;
 	void setTempTarget(const string& aTempTarget) noexcept;
 
@@ -279,10 +286,13 @@ public:
 private:
 	friend class QueueManager;
 	friend class UserQueue;
+	const QueueTarget target;
 	SourceList sources;
 	SourceList badSources;
 	string tempTarget;
 
+	bool isDefaultTempTarget(const string& aTempTarget) const noexcept;
+
 	void addSource(const HintedUser& aUser) noexcept;
 	void blockSourceHub(const HintedUser& aUser) noexcept;
 	bool validateHub(const UserPtr& aUser, const string& aUrl) const noexcept;
@@ -24,8 +24,8 @@
 
 namespace dcpp {
 
-QueueItemBase::QueueItemBase(const string& aTarget, int64_t aSize, Priority aPriority, time_t aAdded, QueueToken aToken, Flags::MaskType aFlags) :
-	Flags(aFlags), priority(aPriority), autoPriority(false), timeAdded(aAdded), size(aSize), token(aToken), target(aTarget) {
+QueueItemBase::QueueItemBase(int64_t aSize, Priority aPriority, time_t aAdded, QueueToken aToken, Flags::MaskType aFlags) :
+	Flags(aFlags), priority(aPriority), autoPriority(false), timeAdded(aAdded), size(aSize), token(aToken) {
 
 }
 
@@ -33,7 +33,7 @@ using std::string;
 
 class QueueItemBase : public Flags {
 public:
-	QueueItemBase(const string& aTarget, int64_t aSize, Priority aPriority, time_t aAdded, QueueToken aToken, Flags::MaskType aFlags);
+	QueueItemBase(int64_t aSize, Priority aPriority, time_t aAdded, QueueToken aToken, Flags::MaskType aFlags);
 	virtual ~QueueItemBase() = default;
 
 	const DownloadList& getDownloads() { return downloads; }
@@ -53,10 +53,6 @@ public:
 
 	string getStringToken() const noexcept;
 
-	const string& getTarget() const noexcept {
-		return target;
-	}
-
 	double getPercentage(int64_t aDownloadedBytes) const noexcept;
 
 	struct SourceCount {
@@ -68,7 +64,6 @@ public:
 	};
 protected:
 	QueueToken token;
-	const string target;
 };
 
 }
@@ -613,7 +613,7 @@ void QueueManager::validateBundleFileHooked(const string& aBundleDir, BundleFile
 	if (SETTING(DONT_DL_ALREADY_QUEUED)) {
 		RLock l(cs);
 		auto q = fileQueue.getQueuedFile(fileInfo_.tth);
-		if (q && q->getTarget() != aBundleDir + fileInfo_.name) {
+		if (q && q->getQueueTarget() != aBundleDir + fileInfo_.name) {
 			auto path = PathUtil::subtractCommonDirectories(aBundleDir, q->getFilePath());
 			throw DupeException(STRING_F(FILE_ALREADY_QUEUED, path));
 		}
@@ -1381,9 +1381,12 @@ QueueManager::QueueMatchResults QueueManager::matchListing(const DirectoryListin
 
 	QueueItemList matchingItems;
 
+	// Walking large listings takes time, don't keep the queue locked meanwhile
+	auto listingFiles = FileQueue::getListingFiles(dl);
+
 	{
 		RLock l(cs);
-		fileQueue.matchListing(dl, matchingItems);
+		fileQueue.matchListing(listingFiles, matchingItems);
 	}
 
 	results.matchingFiles = static_cast<int>(matchingItems.size());
@@ -1963,7 +1966,7 @@ void QueueManager::removeQI(const QueueItemPtr& q, bool aDeleteData /*false*/) n
 		if(q->isRunning()) {
 			for(const auto& d: q->getDownloads()) 
 				disconnectTokens.push_back(d->getConnectionToken());
-		} else if(!q->getTempTarget().empty() && q->getTempTarget() != q->getTarget()) {
+		} else if(!q->getTempTarget().empty() && q->getQueueTarget() != q->getTempTarget()) {
 			File::deleteFile(q->getTempTarget());
 		}
 
@@ -1972,6 +1975,7 @@ void QueueManager::removeQI(const QueueItemPtr& q, bool aDeleteData /*false*/) n
 		}
 
 		fileQueue.remove(q);
+		dcassert(!userQueue.getRunningItems().contains(q));
 	}
 
 	if (aDeleteData) {
@@ -2967,10 +2971,7 @@ void QueueManager::calculatePriorities(uint64_t aTick) noexcept {
 		}
 
 		// queueitems
-		for (const auto& q : fileQueue.getPathQueue() | views::values) {
-			if (!q->isRunning())
-				continue;
-
+		for (const auto& q : userQueue.getRunningItems()) {
 			if (SETTING(QI_AUTOPRIO) && prioType == SettingsManager::PRIO_PROGRESS && q->getAutoPriority() && q->getBundle() && !q->getBundle()->isFileBundle()) {
 				auto p1 = q->getPriority();
 				if (p1 != Priority::PAUSED && p1 != Priority::PAUSED_FORCE) {
@@ -3041,12 +3042,8 @@ void QueueManager::on(TimerManagerListener::Second, uint64_t aTick) noexcept {
 
 		{
 			RLock l(cs);
-			for (const auto& q : fileQueue.getPathQueue() | views::values) {
-				if (!q->isRunning())
-					continue;
-
-				runningItems.push_back(q);
-			}
+			const auto& running = userQueue.getRunningItems();
+			runningItems.assign(running.begin(), running.end());
 		}
 
 		for (const auto& q : runningItems) {
@@ -3663,7 +3660,7 @@ void QueueManager::removeBundle(const BundlePtr& aBundle, bool aRemoveFinishedFi
 		for (const auto& qi : queueItems) {
 			UploadManager::getInstance()->abortUpload(qi->getTarget());
 
-			if (!qi->isRunning() && !qi->getTempTarget().empty() && qi->getTempTarget() != qi->getTarget()) {
+			if (!qi->isRunning() && !qi->getTempTarget().empty() && qi->getQueueTarget() != qi->getTempTarget()) {
 				deleteFiles.push_back(qi->getTempTarget());
 			}
 
@@ -3672,6 +3669,7 @@ void QueueManager::removeBundle(const BundlePtr& aBundle, bool aRemoveFinishedFi
 			}
 
 			fileQueue.remove(qi);
+			dcassert(!userQueue.getRunningItems().contains(qi));
 			bundleQueue.removeBundleItem(qi, false);
 		}
 
@@ -3720,28 +3718,33 @@ MemoryInputStream* QueueManager::generateTTHList(QueueToken aBundleToken, bool i
 	if(!isInSharingHub)
 		throw QueueException(UserConnection::FILE_NOT_AVAILABLE);
 
-	string tths;
-	StringOutputStream tthList(tths);
+	vector<TTHValue> finishedTTHs;
 	{
 		RLock l(cs);
 		bundle_ = bundleQueue.findBundle(aBundleToken);
 		if (bundle_) {
-			//write finished items
-			string tmp2;
+			//get finished items
 			for (const auto& q: bundle_->getFinishedFiles()) {
 				if (q->isDownloaded()) {
-					tmp2.clear();
-					tthList.write(q->getTTH().toBase32(tmp2) + " ");
+					finishedTTHs.push_back(q->getTTH());
 				}
 			}
 		}
 	}
 
-	if (tths.size() == 0) {
+	if (finishedTTHs.empty()) {
 		throw QueueException(UserConnection::FILE_NOT_AVAILABLE);
-	} else {
-		return new MemoryInputStream(tths);
 	}
+
+	// Encode without holding the lock
+	string tths;
+	tths.reserve(finishedTTHs.size() * 40);
+	for (const auto& tth: finishedTTHs) {
+		tth.toBase32(tths);
+		tths += ' ';
+	}
+
+	return new MemoryInputStream(tths);
 }
 
 void QueueManager::addBundleTTHListHooked(const HintedUser& aUser, const BundlePtr& aBundle, const string& aRemoteBundleToken) {
@@ -0,0 +1,203 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "stdinc.h"
+
+#include <airdcpp/queue/QueueTarget.h>
+
+#include <airdcpp/core/header/constants.h>
+#include <airdcpp/core/thread/CriticalSection.h>
+#include <airdcpp/util/Util.h>
+#include <airdcpp/util/text/Text.h>
+
+namespace dcpp {
+
+namespace {
+	struct DirectoryHash {
+		using is_transparent = void;
+		size_t operator()(string_view aStr) const noexcept { return std::hash<string_view>()(aStr); }
+	};
+
+	// Directory path -> number of targets referring to it
+	using DirectoryMap = unordered_map<string, size_t, DirectoryHash, std::equal_to<>>;
+
+	// The directories are split in multiple maps so that adding and removing queue items from different threads won't serialize on a single lock
+	struct DirectoryShard {
+		CriticalSection cs;
+		DirectoryMap directories;
+	};
+
+	const size_t DIRECTORY_SHARDS = 16;
+	DirectoryShard shards[DIRECTORY_SHARDS];
+
+	DirectoryShard& getShard(string_view aDirectory) noexcept {
+		return shards[DirectoryHash()(aDirectory) % DIRECTORY_SHARDS];
+	}
+
+	size_t splitPos(string_view aPath) noexcept {
+		auto pos = aPath.rfind(PATH_SEPARATOR);
+		return pos == string_view::npos ? 0 : pos + 1;
+	}
+
+	// Decodes the next character in lower case (invalid sequences are handled like in noCaseStringHash)
+	wchar_t nextLowerChar(const char*& str_) noexcept {
+		wchar_t c = 0;
+		int n = Text::utf8ToWc(str_, c);
+		if (n < 0) {
+			str_ += abs(n);
+			return '_';
+		}
+
+		str_ += n;
+		return Text::toLower(c);
+	}
+
+	void hashNoCase(string_view aStr, size_t& hash_) noexcept {
+		const char* end = aStr.data() + aStr.size();
+		for (const char* str = aStr.data(); str < end; ) {
+			hash_ = hash_ * 32 - hash_ + static_cast<size_t>(nextLowerChar(str));
+		}
+	}
+
+	bool equalsNoCase(string_view a, string_view b) noexcept {
+		if (a == b) {
+			return true;
+		}
+
+		const char* endA = a.data() + a.size();
+		const char* endB = b.data() + b.size();
+		const char* strA = a.data();
+		const char* strB = b.data();
+		while (strA < endA && strB < endB) {
+			if (nextLowerChar(strA) != nextLowerChar(strB)) {
+				return false;
+			}
+		}
+
+		return strA >= endA && strB >= endB;
+	}
+}
+
+QueueTarget::QueueTarget(const string& aPath) noexcept :
+	directory(acquireDirectory(string_view(aPath).substr(0, splitPos(aPath)))), fileName(aPath.substr(splitPos(aPath))) {
+
+}
+
+QueueTarget::~QueueTarget() {
+	releaseDirectory(directory);
+}
+
+bool QueueTarget::operator==(const string& aPath) const noexcept {
+	return aPath.size() == size() && aPath.compare(0, directory->size(), *directory) == 0 && aPath.compare(directory->size(), string::npos, fileName) == 0;
+}
+
+int QueueTarget::compare(const QueueTarget& aOther) const noexcept {
+	if (directory == aOther.directory) {
+		return dcpp::compare(fileName, aOther.fileName);
+	}
+
+	// Compare the concatenated parts without constructing the full paths
+	string_view partsA[] = { *directory, fileName };
+	string_view partsB[] = { *aOther.directory, aOther.fileName };
+
+	size_t indexA = 0, indexB = 0;
+	auto a = partsA[0], b = partsB[0];
+	while (true) {
+		if (a.empty() && indexA == 0) {
+			a = partsA[++indexA];
+		}
+
+		if (b.empty() && indexB == 0) {
+			b = partsB[++indexB];
+		}
+
+		if (a.empty() || b.empty()) {
+			return a.empty() ? (b.empty() ? 0 : -1) : 1;
+		}
+
+		auto len = min(a.size(), b.size());
+		auto res = a.substr(0, len).compare(b.substr(0, len));
+		if (res != 0) {
+			return res < 0 ? -1 : 1;
+		}
+
+		a.remove_prefix(len);
+		b.remove_prefix(len);
+	}
+}
+
+int QueueTarget::pathSort(const QueueTarget& a, const QueueTarget& b) noexcept {
+	// Directories are interned, different pointers always mean different paths
+	if (a.directory != b.directory) {
+		return dcpp::compare(*a.directory, *b.directory);
+	}
+
+	return dcpp::compare(a.fileName, b.fileName);
+}
+
+QueueTarget::Key::Key(string_view aPath) noexcept : directory(aPath.substr(0, splitPos(aPath))), fileName(aPath.substr(splitPos(aPath))) {
+
+}
+
+size_t QueueTarget::NoCaseHash::operator()(const Key& aKey) const noexcept {
+	// Same as noCaseStringHash for the full path
+	size_t x = 0;
+	hashNoCase(aKey.directory, x);
+	hashNoCase(aKey.fileName, x);
+	return x;
+}
+
+bool QueueTarget::NoCaseEq::operator()(const Key& a, const Key& b) const noexcept {
+	return equalsNoCase(a.fileName, b.fileName) && equalsNoCase(a.directory, b.directory);
+}
+
+const string* QueueTarget::acquireDirectory(string_view aDirectory) noexcept {
+	auto& shard = getShard(aDirectory);
+
+	Lock l(shard.cs);
+	auto i = shard.directories.find(aDirectory);
+	if (i == shard.directories.end()) {
+		i = shard.directories.emplace(aDirectory, 0).first;
+	}
+
+	i->second++;
+	return &i->first;
+}
+
+void QueueTarget::releaseDirectory(const string* aDirectory) noexcept {
+	auto& shard = getShard(*aDirectory);
+
+	Lock l(shard.cs);
+	auto i = shard.directories.find(string_view(*aDirectory));
+	dcassert(i != shard.directories.end());
+	if (i != shard.directories.end() && --i->second == 0) {
+		shard.directories.erase(i);
+	}
+}
+
+size_t QueueTarget::getDirectoryCount() noexcept {
+	size_t ret = 0;
+	for (auto& shard: shards) {
+		Lock l(shard.cs);
+		ret += shard.directories.size();
+	}
+
+	return ret;
+}
+
+} // namespace dcpp
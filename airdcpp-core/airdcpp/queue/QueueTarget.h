@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef DCPLUSPLUS_DCPP_QUEUE_TARGET_H
+#define DCPLUSPLUS_DCPP_QUEUE_TARGET_H
+
+#include <airdcpp/core/header/typedefs.h>
+
+#include <boost/noncopyable.hpp>
+
+namespace dcpp {
+
+// Target path of a queued file stored as an interned parent directory and the file name
+// Files in the same directory (e.g. items of a bundle) share a single copy of the directory path
+class QueueTarget : boost::noncopyable {
+public:
+	explicit QueueTarget(const string& aPath) noexcept;
+	~QueueTarget();
+
+	string str() const noexcept {
+		return *directory + fileName;
+	}
+
+	// Path of the parent directory (including the trailing separator)
+	const string& getDirectory() const noexcept { return *directory; }
+	const string& getFileName() const noexcept { return fileName; }
+
+	size_t size() const noexcept { return directory->size() + fileName.size(); }
+
+	bool operator==(const string& aPath) const noexcept;
+
+	// Same as comparing the full paths with compare()
+	int compare(const QueueTarget& aOther) const noexcept;
+
+	// Same as PathUtil::pathSort for the full paths
+	static int pathSort(const QueueTarget& a, const QueueTarget& b) noexcept;
+
+	// Non-owning reference to a path split into the directory and file name parts
+	// (can be used for lookups with full paths without constructing queue targets)
+	struct Key {
+		explicit Key(const QueueTarget& aTarget) noexcept : directory(*aTarget.directory), fileName(aTarget.fileName) {}
+		explicit Key(string_view aPath) noexcept;
+
+		string_view directory;
+		string_view fileName;
+	};
+
+	// Case-insensitive comparison, matching noCaseStringHash/noCaseStringEq for full paths
+	struct NoCaseHash {
+		size_t operator()(const Key& aKey) const noexcept;
+	};
+
+	struct NoCaseEq {
+		bool operator()(const Key& a, const Key& b) const noexcept;
+	};
+
+	// Number of unique directories in use
+	static size_t getDirectoryCount() noexcept;
+private:
+	const string* directory;
+	const string fileName;
+
+	static const string* acquireDirectory(string_view aDirectory) noexcept;
+	static void releaseDirectory(const string* aDirectory) noexcept;
+};
+
+} // namespace dcpp
+
+#endif // !defined(DCPLUSPLUS_DCPP_QUEUE_TARGET_H)
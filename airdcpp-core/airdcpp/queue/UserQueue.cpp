@@ -132,10 +132,14 @@ QueueItemPtr UserQueue::getNextBundleQI(const QueueDownloadQuery& aQuery, string
 
 void UserQueue::addDownload(const QueueItemPtr& qi, Download* d) noexcept {
 	qi->addDownload(d);
+	runningItems.insert(qi);
 }
 
 void UserQueue::removeDownload(const QueueItemPtr& qi, const Download* d) noexcept {
 	qi->removeDownload(d);
+	if (qi->isWaiting()) {
+		runningItems.erase(qi);
+	}
 }
 
 void UserQueue::setQIPriority(const QueueItemPtr& qi, Priority p) noexcept {
@@ -148,12 +152,21 @@ void UserQueue::removeQI(const QueueItemPtr& qi, bool removeRunning /*true*/) no
 	for(const auto& i: qi->getSources()) {
 		removeQI(qi, i.getUser(), removeRunning, 0);
 	}
+
+	if (removeRunning) {
+		// The item is leaving the queue (or has finished) so it shouldn't be processed anymore
+		// even if there are downloads left from sources that were removed earlier
+		runningItems.erase(qi);
+	}
 }
 
 void UserQueue::removeQI(const QueueItemPtr& qi, const UserPtr& aUser, bool removeRunning /*true*/, Flags::MaskType reason) noexcept{
 
 	if(removeRunning) {
 		qi->removeDownloads(aUser);
+		if (qi->isWaiting()) {
+			runningItems.erase(qi);
+		}
 	}
 
 	dcassert(qi->isSource(aUser));
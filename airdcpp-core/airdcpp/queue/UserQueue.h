@@ -50,7 +50,11 @@ public:
 
 	unordered_map<UserPtr, BundleList, User::Hash>& getBundleList()  { return userBundleQueue; }
 	unordered_map<UserPtr, QueueItemList, User::Hash>& getPrioList()  { return userPrioQueue; }
+	const QueueItem::Set& getRunningItems() const noexcept { return runningItems; }
 private:
+	/** QueueItems with at least one active download (maintained when downloads are added/removed) */
+	QueueItem::Set runningItems;
+
 	/** Bundles by priority and user (this is where the download order is determined) */
 	unordered_map<UserPtr, BundleList, User::Hash> userBundleQueue;
 	/** High priority QueueItems by user (this is where the download order is determined) */
@@ -49,6 +49,10 @@ public:
 		return providerName;
 	}
 
+	bool hasCompleteFiles() const noexcept override {
+		return false;
+	}
+
 	const string providerName = "partial_sharing";
 private:
 	uint8_t extraPartial = 0;
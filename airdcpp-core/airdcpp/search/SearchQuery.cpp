@@ -30,7 +30,7 @@ namespace {
 
 namespace dcpp {
 
-double SearchQuery::getRelevanceScore(const SearchQuery& aSearch, int aLevel, bool aIsDirectory, const string& aName) noexcept {
+double SearchQuery::getRelevanceScore(const SearchQuery& aSearch, int aLevel, bool aIsDirectory, string_view aName) noexcept {
 	// get the level scores first
 	double scores = aLevel > 0 ? 9 / static_cast<double>(aLevel) : 10;
 	double maxPoints = 10;
@@ -114,7 +114,7 @@ double SearchQuery::getRelevanceScore(const SearchQuery& aSearch, int aLevel, bo
 	return scores;
 }
 
-SearchQuery::ResultPointsList SearchQuery::toPointList(const string& aName) const noexcept {
+SearchQuery::ResultPointsList SearchQuery::toPointList(string_view aName) const noexcept {
 	ResultPointsList ret(lastIncludePositions.size());
 	for (size_t j = 0; j < lastIncludePositions.size(); ++j) {
 		int points = 0;
@@ -317,13 +317,13 @@ bool SearchQuery::matchesStr(const string& aStr) noexcept {
 	return matchesFileLower(Text::toLower(aStr), 0, 0);
 }
 
-bool SearchQuery::matchesFileLower(const string& aName, int64_t aSize, uint64_t aDate) noexcept {
+bool SearchQuery::matchesFileLower(string_view aName, int64_t aSize, uint64_t aDate) noexcept {
 	if (!matchesDate(aDate) || !matchesSize(aSize)) {
 		return false;
 	}
 
 	// Validate exact matches first
-	if (matchType == Search::MATCH_NAME_EXACT && compare(include.getPatterns().front().str(), aName) != 0) {
+	if (matchType == Search::MATCH_NAME_EXACT && aName.compare(include.getPatterns().front().str()) != 0) {
 		return false;
 	}
 
@@ -377,7 +377,7 @@ bool SearchQuery::matchesAdcPath(const string& aPath, Recursion& recursion_) noe
 	return positionsComplete();
 }
 
-SearchQuery::ResultPointsList SearchQuery::getResultPositions(const string& aName) const noexcept {
+SearchQuery::ResultPointsList SearchQuery::getResultPositions(string_view aName) const noexcept {
 	// Do we need to use matches from a lower level?
 	auto ret = toPointList(aName);
 	if (recursion && ranges::find(lastIncludePositions, string::npos) != lastIncludePositions.end()) {
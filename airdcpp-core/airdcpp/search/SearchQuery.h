@@ -41,10 +41,10 @@ namespace dcpp {
 		using ResultPointsList = vector<pair<size_t, int>>;
 
 		// Gets a score (0-1) based on how well the current item matches the provided search (which must have been fully matched first)
-		static double getRelevanceScore(const SearchQuery& aSearch, int aLevel, bool aIsDirectory, const string& aName) noexcept;
+		static double getRelevanceScore(const SearchQuery& aSearch, int aLevel, bool aIsDirectory, string_view aName) noexcept;
 
 		// Count points per pattern based on the matching positions (based on the surrounding separators)
-		ResultPointsList toPointList(const string& aName) const noexcept;
+		ResultPointsList toPointList(string_view aName) const noexcept;
 
 		// General initialization
 		static SearchQuery* fromSearch(const SearchPtr& aSearch) noexcept;
@@ -57,7 +57,7 @@ namespace dcpp {
 		SearchQuery(const string& nmdcString, Search::SizeModes aSizeMode, int64_t aSize, Search::TypeModes aTypeMode, size_t maxResults) noexcept;
 
 		inline bool isExcluded(const string& str) const noexcept { return exclude.match_any(str); }
-		inline bool isExcludedLower(const string& str) const noexcept { return exclude.match_any_lower(str); }
+		inline bool isExcludedLower(string_view str) const noexcept { return exclude.match_any_lower(str); }
 		bool hasExt(const string_view& name) noexcept;
 
 		StringSearch include;
@@ -70,7 +70,7 @@ namespace dcpp {
 		int getLastIncludeMatches() const noexcept { return lastIncludeMatches; }
 
 		// get the merged positions
-		ResultPointsList getResultPositions(const string& aName) const noexcept;
+		ResultPointsList getResultPositions(string_view aName) const noexcept;
 		bool positionsComplete() const noexcept;
 
 
@@ -118,7 +118,7 @@ namespace dcpp {
 		bool matchesAnyDirectoryLower(const string& aName) noexcept;
 
 		// Returns true if the file is a valid result. Saves positions
-		bool matchesFileLower(const string& aName, int64_t aSize, uint64_t aDate) noexcept;
+		bool matchesFileLower(string_view aName, int64_t aSize, uint64_t aDate) noexcept;
 
 		// Plain string match with position storing
 		bool matchesStr(const string& aStr) noexcept;
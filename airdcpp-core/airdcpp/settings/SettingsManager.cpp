@@ -262,7 +262,7 @@ const string SettingsManager::settingTags[] =
 	"RemovedTrees", "RemovedFiles", "MultithreadedRefresh",
 	"MaxRunningBundles", "DefaultShareProfile", "UpdateChannel",
 
-	"AutoSearchEvery", "ASDelayHours",
+	"AutoSearchEvery", "ASDelayHours", "UploadBlockCacheSize",
 
 #ifdef HAVE_GUI
 	// Windows GUI
@@ -342,7 +342,7 @@ const string SettingsManager::settingTags[] =
 	"SkipEmptyDirsShare", "RemoveExpiredAs", "AdcLogGroupCID", "ShareFollowSymlinks", "UseDefaultCertPaths", "StartupRefresh",
 	"FLReportDupeFiles", "UseUploadBundles", "LogIgnored", "RemoveFinishedBundles", "AlwaysCCPM",
 
-	"PopupBotPms", "PopupHubPms", "SortFavUsersFirst",
+	"PopupBotPms", "PopupHubPms", "SortFavUsersFirst", "AsyncDownloadWrites",
 #ifdef HAVE_GUI
 	// Windows GUI
 	"BoldFinishedDownloads", "BoldFinishedUploads", "BoldHub", "BoldPm",
@@ -621,6 +621,7 @@ SettingsManager::SettingsManager() : connectionRegex("(\\d+(\\.\\d+)?)")
 	setDefault(SKIP_EMPTY_DIRS_SHARE, true);
 
 	setDefault(DB_CACHE_SIZE, 8);
+	setDefault(UPLOAD_BLOCK_CACHE_SIZE, 64);
 	setDefault(CUR_REMOVED_TREES, 0);
 	setDefault(CUR_REMOVED_FILES, 0);
 
@@ -661,6 +662,7 @@ SettingsManager::SettingsManager() : connectionRegex("(\\d+(\\.\\d+)?)")
 	setDefault(POPUP_HUB_PMS, true);
 	setDefault(POPUP_BOT_PMS, true);
 	setDefault(SORT_FAVUSERS_FIRST, false);
+	setDefault(ASYNC_DOWNLOAD_WRITES, true);
 
 #ifdef _WIN32
 	setDefault(NMDC_ENCODING, Text::systemCharset);
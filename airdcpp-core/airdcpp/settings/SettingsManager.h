@@ -138,7 +138,7 @@ public:
 		CUR_REMOVED_TREES, CUR_REMOVED_FILES, REFRESH_THREADING,
 		MAX_RUNNING_BUNDLES, DEFAULT_SP, UPDATE_CHANNEL,
 
-		AUTOSEARCH_EVERY, AS_DELAY_HOURS,
+		AUTOSEARCH_EVERY, AS_DELAY_HOURS, UPLOAD_BLOCK_CACHE_SIZE,
 
 #ifdef HAVE_GUI
 		// Windows GUI
@@ -218,7 +218,7 @@ public:
 		SKIP_EMPTY_DIRS_SHARE, REMOVE_EXPIRED_AS, PM_LOG_GROUP_CID, SHARE_FOLLOW_SYMLINKS, USE_DEFAULT_CERT_PATHS, STARTUP_REFRESH,
 		FL_REPORT_FILE_DUPES, USE_UPLOAD_BUNDLES, LOG_IGNORED, REMOVE_FINISHED_BUNDLES, ALWAYS_CCPM,
 
-		POPUP_BOT_PMS, POPUP_HUB_PMS, SORT_FAVUSERS_FIRST,
+		POPUP_BOT_PMS, POPUP_HUB_PMS, SORT_FAVUSERS_FIRST, ASYNC_DOWNLOAD_WRITES,
 #ifdef HAVE_GUI
 		// Windows GUI
 		BOLD_FINISHED_DOWNLOADS, BOLD_FINISHED_UPLOADS, BOLD_HUB, BOLD_PM,
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "stdinc.h"
+#include <airdcpp/share/ShareArena.h>
+
+#include <airdcpp/core/header/debug.h>
+
+namespace dcpp {
+
+ShareArena::ShareArena() noexcept {
+	fill_n(freeRecords, MAX_RECORD_SIZE / ALIGNMENT + 1, nullptr);
+}
+
+ShareArena::~ShareArena() {
+	dcassert(usedBytes == 0);
+	for (auto block : blocks) {
+		::operator delete(block);
+	}
+}
+
+void* ShareArena::allocate(size_t aSize) noexcept {
+	aSize = getAlignedSize(aSize);
+
+	Lock l(cs);
+	usedBytes += aSize;
+	if (aSize > MAX_RECORD_SIZE) {
+		reservedBytes += aSize;
+		return ::operator new(aSize);
+	}
+
+	auto& freeRecord = freeRecords[aSize / ALIGNMENT];
+	if (freeRecord) {
+		auto ret = freeRecord;
+		freeRecord = freeRecord->next;
+		return ret;
+	}
+
+	if (static_cast<size_t>(blockEnd - blockPos) < aSize) {
+		// The remaining space of the current block is left unused
+		blockPos = static_cast<uint8_t*>(::operator new(BLOCK_SIZE));
+		blockEnd = blockPos + BLOCK_SIZE;
+		blocks.push_back(blockPos);
+		reservedBytes += BLOCK_SIZE;
+	}
+
+	auto ret = blockPos;
+	blockPos += aSize;
+	return ret;
+}
+
+void ShareArena::deallocate(void* aPtr, size_t aSize) noexcept {
+	aSize = getAlignedSize(aSize);
+
+	Lock l(cs);
+	dcassert(usedBytes >= aSize);
+	usedBytes -= aSize;
+	if (aSize > MAX_RECORD_SIZE) {
+		reservedBytes -= aSize;
+		::operator delete(aPtr);
+		return;
+	}
+
+	auto& freeRecord = freeRecords[aSize / ALIGNMENT];
+	auto record = static_cast<FreeRecord*>(aPtr);
+	record->next = freeRecord;
+	freeRecord = record;
+}
+
+size_t ShareArena::getReservedBytes() const noexcept {
+	Lock l(cs);
+	return reservedBytes;
+}
+
+size_t ShareArena::getUsedBytes() const noexcept {
+	Lock l(cs);
+	return usedBytes;
+}
+
+} // namespace dcpp
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef DCPLUSPLUS_DCPP_SHAREARENA_H
+#define DCPLUSPLUS_DCPP_SHAREARENA_H
+
+#include <airdcpp/core/header/typedefs.h>
+#include <airdcpp/core/thread/CriticalSection.h>
+
+namespace dcpp {
+
+/*
+* Storage for the file records of a share tree
+*
+* Every refresh task and cache loader builds its tree in a new arena, so refreshing a root
+* rebuilds its records and the previous arena is released together with the old tree.
+* Records are carved from large blocks in the order they are added, which keeps the files
+* of a directory (and their names) next to each other in memory. Removed records are kept
+* in free lists by size and the blocks are released only when the arena is destroyed.
+*/
+class ShareArena {
+public:
+	typedef shared_ptr<ShareArena> Ptr;
+
+	static const size_t ALIGNMENT = 8;
+
+	ShareArena() noexcept;
+	~ShareArena();
+
+	void* allocate(size_t aSize) noexcept;
+	void deallocate(void* aPtr, size_t aSize) noexcept;
+
+	// Memory reserved from the system
+	size_t getReservedBytes() const noexcept;
+
+	// Memory used by the allocated records
+	size_t getUsedBytes() const noexcept;
+
+	ShareArena(ShareArena&) = delete;
+	ShareArena& operator=(ShareArena&) = delete;
+private:
+	static const size_t BLOCK_SIZE = 64 * 1024;
+
+	// Larger records are allocated separately
+	static const size_t MAX_RECORD_SIZE = 4 * 1024;
+
+	struct FreeRecord {
+		FreeRecord* next;
+	};
+
+	static size_t getAlignedSize(size_t aSize) noexcept {
+		return (aSize + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+	}
+
+	// Free lists indexed by the aligned record size
+	FreeRecord* freeRecords[MAX_RECORD_SIZE / ALIGNMENT + 1];
+
+	vector<void*> blocks;
+	uint8_t* blockPos = nullptr;
+	uint8_t* blockEnd = nullptr;
+
+	size_t reservedBytes = 0;
+	size_t usedBytes = 0;
+
+	mutable CriticalSection cs;
+};
+
+} // namespace dcpp
+
+#endif // !defined(DCPLUSPLUS_DCPP_SHAREARENA_H)
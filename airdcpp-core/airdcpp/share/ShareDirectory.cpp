@@ -35,8 +35,9 @@ bool ShareDirectory::RootIsParentOrExact::operator()(const ShareDirectory::Ptr&
 	return PathUtil::isParentOrExactLower(aDirectory->getRoot()->getPathLower(), compareToLower, separator);
 }
 
-ShareDirectory::ShareDirectory(DualString&& aRealName, const ShareDirectory::Ptr& aParent, time_t aLastWrite, const ShareRoot::Ptr& aRoot) :
+ShareDirectory::ShareDirectory(DualString&& aRealName, const ShareDirectory::Ptr& aParent, time_t aLastWrite, const ShareArena::Ptr& aArena, const ShareRoot::Ptr& aRoot) :
 	lastWrite(aLastWrite),
+	arena(aArena),
 	parent(aParent.get()),
 	root(aRoot),
 	realName(std::move(aRealName))
@@ -44,22 +45,64 @@ ShareDirectory::ShareDirectory(DualString&& aRealName, const ShareDirectory::Ptr
 }
 
 ShareDirectory::~ShareDirectory() {
-	ranges::for_each(files, DeleteFunction());
+	for (auto f : files) {
+		File::destroy(f, *arena);
+	}
 }
 
-ShareDirectory::File::File(DualString&& aName, ShareDirectory* aParent, const HashedFile& aFileInfo) :
-	size(aFileInfo.getSize()), parent(aParent), lastWrite(aFileInfo.getTimeStamp()), tth(aFileInfo.getRoot()), name(std::move(aName)) {
+ShareDirectory::File::File(const DualString& aName, ShareDirectory* aParent, const HashedFile& aFileInfo) :
+	size(aFileInfo.getSize()), parent(aParent), lastWrite(aFileInfo.getTimeStamp()), tth(aFileInfo.getRoot()),
+	nameLength(static_cast<uint32_t>(aName.getLower().size())), hasUpperCase(!aName.lowerCaseOnly()) {
 
 }
 
-ShareDirectory::File::~File() {
+size_t ShareDirectory::File::getMaskOffset(size_t aNameLength) noexcept {
+	// After the null-terminated name
+	auto offset = sizeof(File) + aNameLength + 1;
+	return (offset + alignof(DualString::MaskType) - 1) & ~(alignof(DualString::MaskType) - 1);
+}
 
+size_t ShareDirectory::File::getAllocationSize(size_t aNameLength, bool aHasUpperCase) noexcept {
+	if (!aHasUpperCase) {
+		return sizeof(File) + aNameLength + 1;
+	}
+
+	return getMaskOffset(aNameLength) + DualString::getMaskSize(aNameLength) * sizeof(DualString::MaskType);
+}
+
+ShareDirectory::File* ShareDirectory::File::create(const DualString& aName, ShareDirectory* aParent, const HashedFile& aFileInfo, ShareArena& arena_) noexcept {
+	const auto& nameLower = aName.getLower();
+	auto mask = aName.getMask();
+
+	auto memory = static_cast<uint8_t*>(arena_.allocate(getAllocationSize(nameLower.size(), mask)));
+	auto file = new (memory) File(aName, aParent, aFileInfo);
+
+	memcpy(memory + sizeof(File), nameLower.c_str(), nameLower.size() + 1);
+	if (mask) {
+		memcpy(memory + getMaskOffset(nameLower.size()), mask, DualString::getMaskSize(nameLower.size()) * sizeof(DualString::MaskType));
+	}
+
+	return file;
+}
+
+void ShareDirectory::File::destroy(File* aFile, ShareArena& arena_) noexcept {
+	auto allocationSize = getAllocationSize(aFile->nameLength, aFile->hasUpperCase);
+	aFile->~File();
+	arena_.deallocate(aFile, allocationSize);
+}
+
+const DualString::MaskType* ShareDirectory::File::getNameMask() const noexcept {
+	if (!hasUpperCase) {
+		return nullptr;
+	}
+
+	return reinterpret_cast<const DualString::MaskType*>(reinterpret_cast<const uint8_t*>(this) + getMaskOffset(nameLength));
 }
 
 
 
 ShareDirectory::Ptr ShareDirectory::createNormal(DualString&& aRealName, const Ptr& aParent, time_t aLastWrite, ShareTreeMaps& maps_) noexcept {
-	auto dir = Ptr(new ShareDirectory(std::move(aRealName), aParent, aLastWrite, nullptr));
+	auto dir = Ptr(new ShareDirectory(std::move(aRealName), aParent, aLastWrite, maps_.getArena(), nullptr));
 
 	if (aParent) {
 		auto added = aParent->directories.insert_sorted(dir).second;
@@ -75,7 +118,7 @@ ShareDirectory::Ptr ShareDirectory::createNormal(DualString&& aRealName, const P
 ShareDirectory::Ptr ShareDirectory::createRoot(const string& aRootPath, const string& aVname, const ProfileTokenSet& aProfiles, bool aIncoming,
 	time_t aLastWrite, ShareTreeMaps& maps_, time_t aLastRefreshTime) noexcept
 {
-	auto dir = Ptr(new ShareDirectory(PathUtil::getLastDir(aRootPath), nullptr, aLastWrite, ShareRoot::create(aRootPath, aVname, aProfiles, aIncoming, aLastRefreshTime)));
+	auto dir = Ptr(new ShareDirectory(PathUtil::getLastDir(aRootPath), nullptr, aLastWrite, maps_.getArena(), ShareRoot::create(aRootPath, aVname, aProfiles, aIncoming, aLastRefreshTime)));
 
 	dcassert(maps_.rootPaths.find(dir->getRealPathUnsafe()) == maps_.rootPaths.end());
 	maps_.rootPaths[dir->getRealPathUnsafe()] = dir;
@@ -153,18 +196,19 @@ const string& ShareDirectory::getVirtualNameLower() const noexcept {
 	return realName.getLower();
 }
 
-void ShareDirectory::addFile(DualString&& aName, const HashedFile& aFileInfo, ShareTreeMaps& maps_, int64_t& sharedSize_, ProfileTokenSet* dirtyProfiles_) noexcept {
+void ShareDirectory::addFile(const DualString& aName, const HashedFile& aFileInfo, ShareTreeMaps& maps_, int64_t& sharedSize_, ProfileTokenSet* dirtyProfiles_) noexcept {
 	{
 		auto i = files.find(aName.getLower());
 		if (i != files.end()) {
 			// Get rid of false constness...
 			(*i)->cleanIndices(sharedSize_, maps_.tthIndex);
-			delete* i;
+			File::destroy(*i, *arena);
 			files.erase(i);
 		}
 	}
 
-	auto it = files.insert_sorted(new ShareDirectory::File(std::move(aName), this, aFileInfo)).first;
+	// The directory may have been created with different maps, use the same arena for all files
+	auto it = files.insert_sorted(File::create(aName, this, aFileInfo, *arena)).first;
 	(*it)->updateIndices(maps_.getBloom(), sharedSize_, maps_.tthIndex);
 
 	if (dirtyProfiles_) {
@@ -215,8 +259,8 @@ void ShareDirectory::countStats(time_t& totalAge_, size_t& totalDirs_, int64_t&
 	for (const auto& f : files) {
 		totalSize_ += f->getSize();
 		totalAge_ += f->getLastWrite();
-		totalStrLen_ += f->getName().length();
-		if (f->getName().lowerCaseOnly()) {
+		totalStrLen_ += f->getNameLower().length();
+		if (f->isLowerCaseOnly()) {
 			lowerCaseFiles_++;
 		}
 	}
@@ -247,8 +291,8 @@ ShareDirectory::Ptr ShareDirectory::findDirectoryLower(const string& aNameLower)
 	return p != directories.end() ? *p : nullptr;
 }
 
-ShareDirectory::File* ShareDirectory::findFileLower(const string& aNameLower) const noexcept {
-	dcassert(Text::isLower(aNameLower));
+ShareDirectory::File* ShareDirectory::findFileLower(string_view aNameLower) const noexcept {
+	dcassert(Text::isLower(string(aNameLower)));
 	auto fileIter = files.find(aNameLower);
 	return fileIter != files.end() ? *fileIter : nullptr;
 }
@@ -356,7 +400,7 @@ void ShareDirectory::File::updateIndices(ShareBloom& bloom_, int64_t& sharedSize
 	checkAddedTTHDebug(this, tthIndex_);
 #endif
 	tthIndex_.emplace(&tth, this);
-	bloom_.add(name.getLower());
+	bloom_.add(getNameLower());
 }
 
 void ShareDirectory::File::cleanIndices(int64_t& sharedSize_, File::TTHMap& tthIndex_) noexcept {
@@ -415,7 +459,7 @@ void ShareDirectory::File::checkAddedTTHDebug(const ShareDirectory::File* aFile,
 // SEARCH
 
 ShareDirectory::SearchResultInfo::SearchResultInfo(const File* f, const SearchQuery& aSearch, int aLevel) :
-	file(f), type(FILE), scores(SearchQuery::getRelevanceScore(aSearch, aLevel, false, f->getName().getLower())) {
+	file(f), type(FILE), scores(SearchQuery::getRelevanceScore(aSearch, aLevel, false, f->getNameLower())) {
 
 }
 
@@ -481,7 +525,7 @@ void ShareDirectory::search(SearchResultInfo::Set& results_, SearchQuery& aStrin
 	// Match files
 	if (aStrings.itemType != SearchQuery::ItemType::DIRECTORY) {
 		for (const auto& f : files) {
-			if (!aStrings.matchesFileLower(f->getName().getLower(), f->getSize(), f->getLastWrite())) {
+			if (!aStrings.matchesFileLower(f->getNameLower(), f->getSize(), f->getLastWrite())) {
 				continue;
 			}
 
@@ -550,7 +594,7 @@ void ShareDirectory::filesToCacheXmlList(OutputStream& xmlFile, string& indent,
 	for (const auto& f : files) {
 		xmlFile.write(indent);
 		xmlFile.write(LITERAL("<File Name=\""));
-		xmlFile.write(SimpleXML::escape(f->getName().lowerCaseOnly() ? f->getName().getLower() : f->getName().getNormal(), tmp2, true));
+		xmlFile.write(SimpleXML::escape(f->getName(), tmp2, true));
 		xmlFile.write(LITERAL("\"/>\r\n"));
 	}
 }
@@ -595,7 +639,7 @@ void FilelistDirectory::toFileList(const ShareDirectory::Ptr& aShareDirectory, b
 void ShareDirectory::File::toXml(OutputStream& xmlFile, string& indent, string& tmp2, bool addDate) const {
 	xmlFile.write(indent);
 	xmlFile.write(LITERAL("<File Name=\""));
-	xmlFile.write(SimpleXML::escape(name.lowerCaseOnly() ? name.getLower() : name.getNormal(), tmp2, true));
+	xmlFile.write(SimpleXML::escape(getName(), tmp2, true));
 	xmlFile.write(LITERAL("\" Size=\""));
 	xmlFile.write(Util::toString(size));
 	xmlFile.write(LITERAL("\" TTH=\""));
@@ -680,7 +724,7 @@ void FilelistDirectory::filesToXml(OutputStream& xmlFile, string& indent, string
 		if (filesAdded) {
 			for (const auto& fi : (*di)->getFiles()) {
 				//go through the dirs that we have added already
-				if (none_of(shareDirs.begin(), di, [&fi](const ShareDirectory::Ptr& d) { return d->findFileLower(fi->getName().getLower()); })) {
+				if (none_of(shareDirs.begin(), di, [&fi](const ShareDirectory::Ptr& d) { return d->findFileLower(fi->getNameLower()); })) {
 					fi->toXml(xmlFile, indent, tmp2, aAddDate);
 				} else {
 					dupeFileCount++;
@@ -26,6 +26,7 @@
 #include <airdcpp/hash/value/MerkleTree.h>
 #include <airdcpp/core/classes/Pointer.h>
 #include <airdcpp/core/classes/SortedVector.h>
+#include <airdcpp/share/ShareArena.h>
 #include <airdcpp/util/Util.h>
 
 #include <airdcpp/core/header/typedefs.h>
@@ -102,21 +103,23 @@ public:
 		const string& operator()(const Ptr& a) const noexcept { return a->realName.getLower(); }
 	};
 
+	// Files are stored in the arena of the directory, the lowercase name (and the possible
+	// uppercase flags) follow the record in the same allocation
 	class File {
 	public:
 		struct NameLower {
-			const string& operator()(const File* a) const noexcept { return a->name.getLower(); }
+			string_view operator()(const File* a) const noexcept { return a->getNameLower(); }
 		};
 
-		typedef SortedVector<File*, std::vector, string, Compare, NameLower> Set;
-		typedef SortedVector<const File*, std::vector, string, Compare, NameLower> ConstSet;
+		typedef SortedVector<File*, std::vector, string_view, Compare, NameLower> Set;
+		typedef SortedVector<const File*, std::vector, string_view, Compare, NameLower> ConstSet;
 		typedef unordered_multimap<TTHValue*, const ShareDirectory::File*> TTHMap;
 
-		File(DualString&& aName, ShareDirectory* aParent, const HashedFile& aFileInfo);
-		~File();
+		static File* create(const DualString& aName, ShareDirectory* aParent, const HashedFile& aFileInfo, ShareArena& arena_) noexcept;
+		static void destroy(File* aFile, ShareArena& arena_) noexcept;
 
-		inline string getAdcPath() const noexcept { return parent->getAdcPathUnsafe() + name.getNormal(); }
-		inline string getRealPath() const noexcept { return parent->getRealPath(name.getNormal()); }
+		inline string getAdcPath() const noexcept { return parent->getAdcPathUnsafe() + getName(); }
+		inline string getRealPath() const noexcept { return parent->getRealPath(getName()); }
 		inline bool hasProfile(const OptionalProfileToken& aProfile) const noexcept { return parent->hasProfile(aProfile); }
 
 		void toXml(OutputStream& xmlFile, string& indent, string& tmp2, bool addDate) const;
@@ -135,11 +138,31 @@ public:
 		// Called before the file has been added in the index
 		static void checkAddedTTHDebug(const ShareDirectory::File* f, TTHMap& aTTHIndex) noexcept;
 #endif
-		const DualString& getName() const noexcept {
-			return name;
+		string_view getNameLower() const noexcept {
+			return string_view(reinterpret_cast<const char*>(this + 1), nameLength);
 		}
+
+		string getName() const noexcept {
+			return DualString::toNormal(getNameLower(), getNameMask());
+		}
+
+		bool isLowerCaseOnly() const noexcept {
+			return !hasUpperCase;
+		}
+
+		File(File&) = delete;
+		File& operator=(File&) = delete;
 	private:
-		DualString name;
+		File(const DualString& aName, ShareDirectory* aParent, const HashedFile& aFileInfo);
+		~File() = default;
+
+		static size_t getAllocationSize(size_t aNameLength, bool aHasUpperCase) noexcept;
+		static size_t getMaskOffset(size_t aNameLength) noexcept;
+
+		const DualString::MaskType* getNameMask() const noexcept;
+
+		uint32_t nameLength;
+		bool hasUpperCase;
 	};
 
 	class SearchResultInfo {
@@ -258,7 +281,7 @@ public:
 	ShareDirectory::Ptr findDirectoryByPath(const string& aPath, char aSeparator) const noexcept;
 
 	ShareDirectory::Ptr findDirectoryLower(const string& aName) const noexcept;
-	File* findFileLower(const string& aNameLower) const noexcept;
+	File* findFileLower(string_view aNameLower) const noexcept;
 
 
 	class RootIsParentOrExact {
@@ -282,16 +305,23 @@ public:
 	static void checkAddedDirNameDebug(const ShareDirectory::Ptr& aDir, ShareDirectory::MultiMap& aDirNames) noexcept;
 #endif
 
-	void addFile(DualString&& aName, const HashedFile& fi, ShareTreeMaps& maps_, int64_t& sharedSize_, ProfileTokenSet* dirtyProfiles_ = nullptr) noexcept;
+	void addFile(const DualString& aName, const HashedFile& fi, ShareTreeMaps& maps_, int64_t& sharedSize_, ProfileTokenSet* dirtyProfiles_ = nullptr) noexcept;
 
-	File::Set getFiles() const noexcept {
+	const File::Set& getFiles() const noexcept {
 		return files;
 	}
 
+	const ShareArena::Ptr& getArena() const noexcept {
+		return arena;
+	}
+
 	const DualString& getRealName() const noexcept {
 		return realName;
 	}
 private:
+	// Storage for the files
+	const ShareArena::Ptr arena;
+
 	File::Set files;
 	void cleanIndices(int64_t& sharedSize_, File::TTHMap& tthIndex_, ShareDirectory::MultiMap& dirNames_) const noexcept;
 
@@ -302,7 +332,7 @@ private:
 	int64_t size = 0;
 	ShareRoot::Ptr root;
 
-	ShareDirectory(DualString&& aRealName, const Ptr& aParent, time_t aLastWrite, const ShareRoot::Ptr& aRoot = nullptr);
+	ShareDirectory(DualString&& aRealName, const Ptr& aParent, time_t aLastWrite, const ShareArena::Ptr& aArena, const ShareRoot::Ptr& aRoot = nullptr);
 	friend void intrusive_ptr_release(intrusive_ptr_base<ShareDirectory>*);
 
 	string getRealPath(const string& path) const noexcept;
@@ -312,7 +342,7 @@ private:
 class ShareTreeMaps {
 public:
 	typedef std::function<ShareBloom*()> GetBloomF;
-	ShareTreeMaps(GetBloomF&& aGetBloomF) : getBloomF(aGetBloomF) {}
+	ShareTreeMaps(GetBloomF&& aGetBloomF) : getBloomF(aGetBloomF), arena(make_shared<ShareArena>()) {}
 
 	// Map real name to virtual name - multiple real names may be mapped to a single virtual one
 	ShareDirectory::Map rootPaths;
@@ -324,8 +354,14 @@ public:
 	ShareBloom& getBloom() noexcept {
 		return *getBloomF();
 	}
+
+	// Storage for the files of the directories created with these maps
+	const ShareArena::Ptr& getArena() const noexcept {
+		return arena;
+	}
 private:
 	GetBloomF getBloomF;
+	const ShareArena::Ptr arena;
 };
 
 class FilelistDirectory {
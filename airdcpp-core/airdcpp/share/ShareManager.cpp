@@ -44,6 +44,9 @@
 
 #include <airdcpp/core/thread/concurrency.h>
 
+// Threads for listing the directories of a single refresh path (with multithreaded refreshes)
+#define REFRESH_CRAWLER_THREADS 4
+
 namespace dcpp {
 
 using ranges::find_if;
@@ -624,14 +627,18 @@ ShareSearchStats ShareManager::getSearchMatchingStats() const noexcept {
 
 
 // REFRESH
-ShareManager::RefreshTaskHandler::ShareBuilder::ShareBuilder(const string& aPath, const ShareDirectory::Ptr& aOldRoot, time_t aLastWrite, ShareBloom& bloom_, ShareManager* aSm) :
-	sm(*aSm), ShareRefreshInfo(aPath, aOldRoot, aLastWrite, bloom_) {
+ShareManager::RefreshTaskHandler::ShareBuilder::ShareBuilder(const string& aPath, const ShareDirectory::Ptr& aOldRoot, time_t aLastWrite, ShareBloom& bloom_, ShareManager* aSm, size_t aCrawlerThreads) :
+	ShareRefreshInfo(aPath, aOldRoot, aLastWrite, bloom_), sm(*aSm), crawler(aCrawlerThreads) {
 
 }
 
 bool ShareManager::RefreshTaskHandler::ShareBuilder::buildTree(const bool& aStopping) noexcept {
 	try {
-		buildTree(path, Text::toLower(path), newDirectory, optionalOldDirectory, aStopping);
+		buildTree(crawler.createRoot(path), Text::toLower(path), newDirectory, optionalOldDirectory, aStopping);
+	} catch (const FileException& e) {
+		// Keep the old content
+		log(STRING_F(DIR_REFRESH_FAILED, path % e.getError()), LogMessage::SEV_ERROR);
+		return false;
 	} catch (const std::bad_alloc&) {
 		log(STRING_F(DIR_REFRESH_FAILED, path % STRING(OUT_OF_MEMORY)), LogMessage::SEV_ERROR);
 		return false;
@@ -664,99 +671,147 @@ bool ShareManager::RefreshTaskHandler::ShareBuilder::validateFileItem(const File
 	return true;
 }
 
-void ShareManager::RefreshTaskHandler::ShareBuilder::buildTree(const string& aPath, const string& aPathLower, const ShareDirectory::Ptr& aParent, const ShareDirectory::Ptr& aOldParent, const bool& aStopping) {
+void ShareManager::RefreshTaskHandler::ShareBuilder::buildTree(const DirectoryCrawler::DirectoryPtr& aDirectory, const string& aPathLower, const ShareDirectory::Ptr& aParent, const ShareDirectory::Ptr& aOldParent, const bool& aStopping) {
+	const auto& path = aDirectory->getPath();
+	const auto& entries = crawler.getEntries(aDirectory);
+
 	ErrorCollector errors;
-	FileFindIter end;
-	for(FileFindIter i(aPath, "*"); i != end && !aStopping; ++i) {
-		const auto name = i->getFileName();
-		if(name.empty()) {
-			return;
+
+	struct Subdirectory {
+		DualString name;
+		time_t lastWrite;
+		ShareDirectory::Ptr oldDirectory;
+		DirectoryCrawler::DirectoryPtr directory;
+	};
+
+	// Validate the directories first so that their content can be listed in background while the files are being processed
+	vector<Subdirectory> subdirectories;
+	for (const auto& entry: entries) {
+		if (aStopping) {
+			break;
+		}
+
+		if (!entry.isDirectory()) {
+			continue;
+		}
+
+		DualString dualName(entry.name);
+		auto curPath = path + entry.name + PATH_SEPARATOR_STR;
+
+		// Check whether it's shared already
+		ShareDirectory::Ptr oldDir = nullptr;
+		if (aOldParent) {
+			RLock l(sm.tree->getCS());
+			oldDir = aOldParent->findDirectoryLower(dualName.getLower());
 		}
 
-		const auto isDirectory = i->isDirectory();
-		if (!isDirectory) {
-			errors.increaseTotal();
+		// Validations
+		auto isNew = !oldDir;
+		auto newParent = !aOldParent;
+		if (!validateFileItem(entry, curPath, isNew, newParent, errors)) {
+			stats.skippedDirectoryCount++;
+			continue;
 		}
 
-		DualString dualName(name);
-		auto curPath = aPath + name + (isDirectory ? PATH_SEPARATOR_STR : Util::emptyString);
-		auto curPathLower = aPathLower + dualName.getLower() + (isDirectory ? PATH_SEPARATOR_STR : Util::emptyString);
+		subdirectories.push_back({ std::move(dualName), entry.getLastWriteTime(), oldDir, crawler.addDirectory(aDirectory, entry) });
+	}
 
-		if (isDirectory) {
+	// Loaded with the first file (one database seek instead of a lookup for each file)
+	optional<HashedFileMap> hashedFiles;
+
+	for (const auto& entry: entries) {
+		if (aStopping) {
+			break;
+		}
+
+		if (entry.isDirectory()) {
+			continue;
+		}
+
+		errors.increaseTotal();
+
+		// Not a directory, assume it's a file...
+		DualString dualName(entry.name);
+		auto curPath = path + entry.name;
+
+		{
 			// Check whether it's shared already
-			ShareDirectory::Ptr oldDir = nullptr;
+			auto isNew = !aOldParent;
 			if (aOldParent) {
 				RLock l(sm.tree->getCS());
-				oldDir = aOldParent->findDirectoryLower(dualName.getLower());
+				isNew = !aOldParent->findFileLower(dualName.getLower());
 			}
 
-			auto isNew = !oldDir;
 
 			// Validations
-			{
-				auto newParent = !aOldParent;
-				if (!validateFileItem(*i, curPath, isNew, newParent, errors)) {
-					stats.skippedDirectoryCount++;
-					continue;
-				}
+			auto newParent = !aOldParent;
+			if (!validateFileItem(entry, curPath, isNew, newParent, errors)) {
+				stats.skippedFileCount++;
+				continue;
+			}
 
+			if (isNew) {
+				stats.newFileCount++;
+			} else {
+				stats.existingFileCount++;
 			}
+		}
 
-			// Add it
-			auto curDir = ShareDirectory::createNormal(std::move(dualName), aParent, i->getLastWriteTime(), *this);
-			if (curDir) {
-				buildTree(curPath, curPathLower, curDir, oldDir, aStopping);
-				if (checkContent(curDir)) {
-					if (isNew) {
-						stats.newDirectoryCount++;
-					} else {
-						stats.existingDirectoryCount++;
-					}
-				}
+		// Add it
+		auto size = entry.getSize();
+		try {
+			if (!hashedFiles) {
+				hashedFiles = HashManager::getInstance()->getDirectoryFiles(aPathLower);
 			}
-		} else {
-			// Not a directory, assume it's a file...
-
-			{
-				// Check whether it's shared already
-				auto isNew = !aOldParent;
-				if (aOldParent) {
-					RLock l(sm.tree->getCS());
-					isNew = !aOldParent->findFileLower(dualName.getLower());
-				}
 
+			HashedFile fi(entry.getLastWriteTime(), size);
+			if (HashManager::getInstance()->checkTTH(*hashedFiles, dualName.getLower(), curPath, aPathLower + dualName.getLower(), fi)) {
+				aParent->addFile(std::move(dualName), fi, *this, stats.addedSize);
+			} else {
+				stats.hashSize += size;
+			}
+		} catch(const HashException&) {
+		}
+	}
+
+	for (auto& subdirectory: subdirectories) {
+		if (aStopping) {
+			break;
+		}
 
-				// Validations
-				auto newParent = !aOldParent;
-				if (!validateFileItem(*i, curPath, isNew, newParent, errors)) {
-					stats.skippedFileCount++;
-					continue;
-				}
+		auto curPathLower = aPathLower + subdirectory.name.getLower() + PATH_SEPARATOR_STR;
+		auto isNew = !subdirectory.oldDirectory;
 
-				if (isNew) {
-					stats.newFileCount++;
-				} else {
-					stats.existingFileCount++;
+		// Add it
+		auto curDir = ShareDirectory::createNormal(std::move(subdirectory.name), aParent, subdirectory.lastWrite, *this);
+		if (curDir) {
+			try {
+				buildTree(subdirectory.directory, curPathLower, curDir, subdirectory.oldDirectory, aStopping);
+			} catch (const FileException& e) {
+				if (DirectoryCrawler::isResourceError(e)) {
+					// The directory itself may be fine, don't remove it from share
+					throw;
 				}
+
+				log(STRING_F(DIR_REFRESH_FAILED, subdirectory.directory->getPath() % e.getError()), LogMessage::SEV_WARNING);
 			}
 
-			// Add it
-			auto size = i->getSize();
-			try {
-				HashedFile fi(i->getLastWriteTime(), size);
-				if(HashManager::getInstance()->checkTTH(aPathLower + dualName.getLower(), aPath + name, fi)) {
-					aParent->addFile(std::move(dualName), fi, *this, stats.addedSize);
+			if (checkContent(curDir)) {
+				if (isNew) {
+					stats.newDirectoryCount++;
 				} else {
-					stats.hashSize += size;
+					stats.existingDirectoryCount++;
 				}
-			} catch(const HashException&) {
 			}
 		}
+
+		// Release the listing
+		subdirectory.directory = nullptr;
 	}
 
 	auto msg = errors.getMessage();
 	if (!msg.empty()) {
-		log(STRING_F(SHARE_FILES_BLOCKED, aPath % msg), LogMessage::SEV_INFO);
+		log(STRING_F(SHARE_FILES_BLOCKED, path % msg), LogMessage::SEV_INFO);
 	}
 }
 
@@ -822,7 +877,7 @@ bool ShareManager::handleRefreshPath(const string& aRefreshPath, const ShareRefr
 		optionalOldDirectory = tree->findDirectoryUnsafe(aRefreshPath);
 	}
 
-	auto ri = RefreshTaskHandler::ShareBuilder(aRefreshPath, optionalOldDirectory, File::getLastModified(aRefreshPath), *bloom_, this);
+	auto ri = RefreshTaskHandler::ShareBuilder(aRefreshPath, optionalOldDirectory, File::getLastModified(aRefreshPath), *bloom_, this, aTask.isMultithreaded() ? REFRESH_CRAWLER_THREADS : 0);
 	setRefreshState(ri.path, ShareRootRefreshState::STATE_RUNNING, false, aTask.token);
 
 	// Build the tree
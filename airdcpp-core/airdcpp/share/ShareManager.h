@@ -27,6 +27,7 @@
 
 #include <airdcpp/core/types/DupeType.h>
 #include <airdcpp/core/classes/Exception.h>
+#include <airdcpp/core/io/DirectoryCrawler.h>
 #include <airdcpp/share/UploadFileProvider.h>
 #include <airdcpp/message/Message.h>
 #include <airdcpp/hash/value/MerkleTree.h>
@@ -262,16 +263,18 @@ private:
 
 		class ShareBuilder : public ShareRefreshInfo {
 		public:
-			ShareBuilder(const string& aPath, const ShareDirectory::Ptr& aOldRoot, time_t aLastWrite, ShareBloom& bloom_, ShareManager* sm);
+			// Subdirectories are listed with aCrawlerThreads in background (0 = list by the refresh thread)
+			ShareBuilder(const string& aPath, const ShareDirectory::Ptr& aOldRoot, time_t aLastWrite, ShareBloom& bloom_, ShareManager* sm, size_t aCrawlerThreads);
 
 			// Recursive function for building a new share tree from a path
 			bool buildTree(const bool& aStopping) noexcept;
 		private:
-			void buildTree(const string& aPath, const string& aPathLower, const ShareDirectory::Ptr& aCurrentDirectory, const ShareDirectory::Ptr& aOldDirectory, const bool& aStopping);
+			void buildTree(const DirectoryCrawler::DirectoryPtr& aDirectory, const string& aPathLower, const ShareDirectory::Ptr& aCurrentDirectory, const ShareDirectory::Ptr& aOldDirectory, const bool& aStopping);
 
 			bool validateFileItem(const FileItemInfoBase& aFileItem, const string& aPath, bool aIsNew, bool aNewParent, ErrorCollector& aErrorCollector) noexcept;
 
 			const ShareManager& sm;
+			DirectoryCrawler crawler;
 		};
 
 		using ShareBuilderPtr = shared_ptr<ShareBuilder>;
@@ -70,6 +70,9 @@ struct ShareRefreshTask : public Task {
 
 	bool canceled = false;
 	bool running = false;
+
+	// Should the paths be refreshed using multiple threads?
+	bool isMultithreaded() const noexcept;
 };
 
 typedef std::vector<ShareRefreshTask> ShareRefreshTaskList;
@@ -130,6 +130,10 @@ void ShareTasks::shutdown() noexcept {
 ShareRefreshTask::ShareRefreshTask(ShareRefreshTaskToken aToken, const RefreshPathList& aDirs, const string& aDisplayName, ShareRefreshType aRefreshType, ShareRefreshPriority aPriority) :
 	token(aToken), dirs(aDirs), displayName(aDisplayName), type(aRefreshType), priority(aPriority) { }
 
+bool ShareRefreshTask::isMultithreaded() const noexcept {
+	return SETTING(REFRESH_THREADING) == SettingsManager::MULTITHREAD_ALWAYS || (SETTING(REFRESH_THREADING) == SettingsManager::MULTITHREAD_MANUAL && priority == ShareRefreshPriority::MANUAL);
+}
+
 void ShareTasks::validateRefreshTask(StringList& dirs_) noexcept {
 	Lock l(tasks.cs);
 	const auto& tq = tasks.getTasks();
@@ -352,7 +356,7 @@ Callback ShareTasks::runRefreshTask(const ShareRefreshTask& aTask, const Progres
 	};
 
 	try {
-		if (SETTING(REFRESH_THREADING) == SettingsManager::MULTITHREAD_ALWAYS || (SETTING(REFRESH_THREADING) == SettingsManager::MULTITHREAD_MANUAL && aTask.priority == ShareRefreshPriority::MANUAL)) {
+		if (aTask.isMultithreaded()) {
 			TaskScheduler s;
 			parallel_for_each(refreshPaths.begin(), refreshPaths.end(), doRefresh);
 		} else {
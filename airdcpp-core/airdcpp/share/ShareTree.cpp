@@ -981,7 +981,7 @@ void ShareTree::validateDirectoryRecursiveDebugUnsafe(const ShareDirectory::Ptr&
 			return aFile->getRealPath() == f->getRealPath();
 		}) == 1);
 
-		dcassert(bloom->match(f->getName().getLower()));
+		dcassert(bloom->match(f->getNameLower()));
 		auto [_, isUnique] = filePaths_.insert(f->getRealPath());
 		dcassert(isUnique);
 		realDirectorySize += f->getSize();
@@ -54,6 +54,9 @@ public:
 	virtual void search(SearchResultList&, const TTHValue&, const ShareSearch&) const noexcept {}
 
 	virtual const string& getProviderName() const noexcept = 0;
+
+	// Whether the provided files are complete (content of unfinished files may still change)
+	virtual bool hasCompleteFiles() const noexcept { return true; }
 };
 
 }
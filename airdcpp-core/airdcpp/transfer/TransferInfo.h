@@ -49,6 +49,7 @@ namespace dcpp {
 			ENCRYPTION = 0x2000,
 			QUEUE_ID = 0x4000,
 			SUPPORTS = 0x8000,
+			COMPRESSION = 0x10000,
 		};
 
 		enum ItemState {
@@ -87,6 +88,11 @@ namespace dcpp {
 
 		IGETSET(QueueToken, queueToken, QueueToken, 0);
 
+		// Compressed uploads only (ratio -1 for other transfers)
+		IGETSET(double, compressionRatio, CompressionRatio, -1);
+		IGETSET(int64_t, compressionTime, CompressionTime, 0); // milliseconds
+		IGETSET(int, compressionLevel, CompressionLevel, -1);
+
 		TransferInfoToken getToken() const noexcept {
 			return token;
 		}
@@ -28,6 +28,7 @@
 #include <airdcpp/queue/QueueManager.h>
 #include <airdcpp/connection/ThrottleManager.h>
 #include <airdcpp/transfer/upload/UploadManager.h>
+#include <airdcpp/core/io/compress/ZUtils.h>
 
 
 namespace dcpp {
@@ -73,16 +74,28 @@ namespace dcpp {
 			t->setStatusString(STRING_F(RUNNING_PCT, t->getPercentage()));
 		}
 
-		onTransferUpdated(
-			t,
-			TransferInfo::UpdateFlags::STATUS | TransferInfo::UpdateFlags::BYTES_TRANSFERRED |
-			TransferInfo::UpdateFlags::SPEED | TransferInfo::UpdateFlags::SECONDS_LEFT,
-			true
-		);
+		int updatedProperties = TransferInfo::UpdateFlags::STATUS | TransferInfo::UpdateFlags::BYTES_TRANSFERRED |
+			TransferInfo::UpdateFlags::SPEED | TransferInfo::UpdateFlags::SECONDS_LEFT;
+		if (!aIsDownload && updateCompressionInfo(*t, static_cast<const Upload*>(aTransfer))) {
+			updatedProperties |= TransferInfo::UpdateFlags::COMPRESSION;
+		}
 
+		onTransferUpdated(t, updatedProperties, true);
 		return t;
 	}
 
+	bool TransferInfoManager::updateCompressionInfo(TransferInfo& aInfo, const Upload* aUpload) noexcept {
+		auto filter = aUpload->getCompressionFilter();
+		if (!filter || filter->getTotalIn() == 0) {
+			return false;
+		}
+
+		aInfo.setCompressionRatio(static_cast<double>(filter->getTotalOut()) / static_cast<double>(filter->getTotalIn()));
+		aInfo.setCompressionTime(filter->getCompressionTime() / 1000);
+		aInfo.setCompressionLevel(filter->getLevel());
+		return true;
+	}
+
 	void TransferInfoManager::on(UploadManagerListener::Tick, const UploadList& aUploads) noexcept {
 		TransferInfo::List tickTransfers;
 		for (const auto& ul : aUploads) {
@@ -96,7 +109,7 @@ namespace dcpp {
 
 		if (!tickTransfers.empty()) {
 			fire(TransferInfoManagerListener::Tick(), tickTransfers, TransferInfo::UpdateFlags::STATUS | TransferInfo::UpdateFlags::BYTES_TRANSFERRED |
-				TransferInfo::UpdateFlags::SPEED | TransferInfo::UpdateFlags::SECONDS_LEFT);
+				TransferInfo::UpdateFlags::SPEED | TransferInfo::UpdateFlags::SECONDS_LEFT | TransferInfo::UpdateFlags::COMPRESSION);
 		}
 	}
 
@@ -293,6 +306,10 @@ namespace dcpp {
 
 		aInfo->setSupports(aTransfer->getUserConnection().getSupports().getAll());
 
+		aInfo->setCompressionRatio(-1);
+		aInfo->setCompressionTime(0);
+		aInfo->setCompressionLevel(-1);
+
 		onTransferUpdated(
 			aInfo,
 			TransferInfo::UpdateFlags::STATUS | TransferInfo::UpdateFlags::SPEED |
@@ -300,7 +317,7 @@ namespace dcpp {
 			TransferInfo::UpdateFlags::SIZE | TransferInfo::UpdateFlags::TARGET | TransferInfo::UpdateFlags::STATE |
 			TransferInfo::UpdateFlags::QUEUE_ID | TransferInfo::UpdateFlags::TYPE |
 			TransferInfo::UpdateFlags::IP | TransferInfo::UpdateFlags::ENCRYPTION | TransferInfo::UpdateFlags::FLAGS | 
-			TransferInfo::UpdateFlags::SUPPORTS
+			TransferInfo::UpdateFlags::SUPPORTS | TransferInfo::UpdateFlags::COMPRESSION
 		);
 
 
@@ -408,12 +425,14 @@ namespace dcpp {
 		t->setBytesTransferred(aTransfer->getSegmentSize());
 		t->setState(TransferInfo::STATE_FINISHED);
 
-		onTransferUpdated(
-			t,
-			TransferInfo::UpdateFlags::STATUS | TransferInfo::UpdateFlags::SPEED |
+		int updatedProperties = TransferInfo::UpdateFlags::STATUS | TransferInfo::UpdateFlags::SPEED |
 			TransferInfo::UpdateFlags::SECONDS_LEFT | TransferInfo::UpdateFlags::TIME_STARTED |
-			TransferInfo::UpdateFlags::BYTES_TRANSFERRED | TransferInfo::UpdateFlags::STATE
-		);
+			TransferInfo::UpdateFlags::BYTES_TRANSFERRED | TransferInfo::UpdateFlags::STATE;
+		if (!aIsDownload && updateCompressionInfo(*t, static_cast<const Upload*>(aTransfer))) {
+			updatedProperties |= TransferInfo::UpdateFlags::COMPRESSION;
+		}
+
+		onTransferUpdated(t, updatedProperties);
 
 		fire(TransferInfoManagerListener::Completed(), t);
 	}
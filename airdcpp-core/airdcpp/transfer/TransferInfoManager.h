@@ -53,6 +53,9 @@ namespace dcpp {
 		TransferInfoPtr onTick(const Transfer* aTransfer, bool aIsDownload) noexcept;
 		static void updateQueueInfo(const TransferInfoPtr& aInfo) noexcept;
 
+		// Returns true if the information was changed
+		static bool updateCompressionInfo(TransferInfo& aInfo, const Upload* aUpload) noexcept;
+
 		void on(DownloadManagerListener::Tick, const DownloadList& aDownloads, uint64_t) noexcept override;
 		void on(UploadManagerListener::Tick, const UploadList& aUploads) noexcept override;
 
@@ -21,6 +21,7 @@
 
 #include <airdcpp/queue/Bundle.h>
 #include <airdcpp/core/io/File.h>
+#include <airdcpp/core/io/stream/AsyncOutputStream.h>
 #include <airdcpp/core/io/stream/FilteredFile.h>
 #include <airdcpp/hash/HashManager.h>
 #include <airdcpp/hash/value/MerkleCheckOutputStream.h>
@@ -33,6 +34,9 @@
 #include <airdcpp/connection/UserConnection.h>
 #include <airdcpp/core/io/compress/ZUtils.h>
 
+// Maximum amount of received data that can be waiting to be written for each download
+#define MAX_QUEUED_WRITE_BYTES (2 * 1024 * 1024)
+
 namespace dcpp {
 
 Download::Download(UserConnection& conn, QueueItem& qi) noexcept : Transfer(conn, qi.getTarget(), qi.getTTH()),
@@ -135,7 +139,7 @@ string Download::getBundleStringToken() const noexcept {
 	return bundle->getStringToken();
 }
 
-void Download::flush() const noexcept {
+void Download::flush() noexcept {
 	if (!getOutput()) {
 		return;
 	}
@@ -146,6 +150,14 @@ void Download::flush() const noexcept {
 		} catch (const Exception&) {
 			// ...
 		}
+
+		if (asyncOutput) {
+			// Data that was discarded because of write errors must not be marked as downloaded
+			auto written = asyncOutput->getWrittenBytes();
+			if (written < getPos()) {
+				addPos(written - getPos(), 0);
+			}
+		}
 	}
 }
 
@@ -249,7 +261,7 @@ void Download::disconnectOverlappedThrow() {
 	}
 }
 
-void Download::open(int64_t bytes, bool z, bool aHasDownloadedBytes) {
+void Download::open(int64_t bytes, bool z, bool aHasDownloadedBytes, StreamWriterPool* aWriterPool) {
 	if(getType() == Transfer::TYPE_FILE) {
 
 		disconnectOverlappedThrow();
@@ -308,6 +320,12 @@ void Download::open(int64_t bytes, bool z, bool aHasDownloadedBytes) {
 
 		output.reset(new MerkleStream(tt, output.release(), getStartPos()));
 		setFlag(Download::FLAG_TTH_CHECK);
+
+		// The end of compressed data is detected by the filter, so it must be processed by the caller
+		if (aWriterPool && !z) {
+			asyncOutput = new AsyncOutputStream(output.release(), *aWriterPool, MAX_QUEUED_WRITE_BYTES);
+			output.reset(asyncOutput);
+		}
 	}
 
 	// Check that we don't get too many bytes
@@ -319,8 +337,15 @@ void Download::open(int64_t bytes, bool z, bool aHasDownloadedBytes) {
 	}
 }
 
+void Download::waitPendingWrites() {
+	if (asyncOutput) {
+		asyncOutput->waitPending();
+	}
+}
+
 void Download::close()
 {
+	asyncOutput = nullptr;
 	output.reset();
 }
 
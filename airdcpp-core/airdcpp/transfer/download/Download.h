@@ -67,8 +67,11 @@ public:
 	/** @return Target filename without path. */
 	string getTargetFileName() const noexcept;
 
-	/** Open the target output for writing */
-	void open(int64_t bytes, bool z, bool hasDownloadedBytes);
+	/** Open the target output for writing. File data is verified and written by aWriterPool if it's set. */
+	void open(int64_t bytes, bool z, bool hasDownloadedBytes, StreamWriterPool* aWriterPool = nullptr);
+
+	/** Wait until the data passed to the writer pool has been written. Throws the write errors. */
+	void waitPendingWrites();
 
 	/** Release the target output */
 	void close();
@@ -92,7 +95,7 @@ public:
 	string getBundleStringToken() const noexcept;
 
 	void appendFlags(OrderedStringSet& flags_) const noexcept override;
-	void flush() const noexcept;
+	void flush() noexcept;
 private:
 	void initFlags(const QueueItem& aQI) noexcept;
 	void initOverlapped(const QueueItem& aQI) noexcept;
@@ -106,6 +109,10 @@ private:
 	const string& getDownloadTarget() const noexcept;
 
 	unique_ptr<OutputStream> output;
+
+	// Set when the output is written by a writer pool (owned by output)
+	AsyncOutputStream* asyncOutput = nullptr;
+
 	TigerTree tt;
 	string pfs;
 };
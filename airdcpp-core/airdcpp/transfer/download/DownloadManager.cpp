@@ -21,6 +21,7 @@
 
 #include <airdcpp/hub/ClientManager.h>
 #include <airdcpp/transfer/download/Download.h>
+#include <airdcpp/core/io/stream/AsyncOutputStream.h>
 #include <airdcpp/events/LogManager.h>
 #include <airdcpp/queue/QueueManager.h>
 #include <airdcpp/core/localization/ResourceManager.h>
@@ -29,12 +30,13 @@
 
 #include <limits>
 #include <cmath>
+#include <thread>
 
 namespace dcpp {
 
 static const string DOWNLOAD_AREA = "Downloads";
 
-DownloadManager::DownloadManager() {
+DownloadManager::DownloadManager() : writerPool(make_unique<StreamWriterPool>(std::clamp(std::thread::hardware_concurrency() / 2, 1U, 4U))) {
 	TimerManager::getInstance()->addListener(this);
 }
 
@@ -364,7 +366,7 @@ void DownloadManager::startData(UserConnection* aSource, int64_t start, int64_t
 
 		{
 			RLock l (cs);
-			d->open(bytes, z, hasDownloadedBytes);
+			d->open(bytes, z, hasDownloadedBytes, SETTING(ASYNC_DOWNLOAD_WRITES) ? writerPool.get() : nullptr);
 		}
 	} catch(const FileException& e) {
 		QueueManager::getInstance()->onDownloadError(d->getBundle(), e.getError());
@@ -409,6 +411,9 @@ void DownloadManager::on(UserConnectionListener::Data, UserConnection* aSource,
 		d->tick();
 
 		if(d->getOutput()->eof()) {
+			// Report the errors from pending writes before completing the download
+			d->waitPendingWrites();
+
 			endData(aSource);
 			aSource->setLineMode(0);
 		}
@@ -78,6 +78,9 @@ private:
 	mutable SharedMutex cs;
 	DownloadList downloads;
 
+	// Verifies and writes the received file data outside the socket threads
+	unique_ptr<StreamWriterPool> writerPool;
+
 	// The list of bundles being download. Note that all of them may not be running
 	// as the bundle is removed from here only after the connection has been 
 	// switched to use another bundle (or no other downloads were found)
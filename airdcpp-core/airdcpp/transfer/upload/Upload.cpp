@@ -39,7 +39,10 @@ InputStream* Upload::getStream() {
 }
 
 void Upload::setFiltered() {
-	stream.reset(new FilteredInputStream<ZFilter, true>(stream.release()));
+	auto filtered = new FilteredInputStream<ZFilter, true>(stream.release());
+	compressionFilter = &filtered->getFilter();
+
+	stream.reset(filtered);
 	setFlag(Upload::FLAG_ZUPLOAD);
 }
 
@@ -46,11 +46,17 @@ public:
 	InputStream* getStream();
 	void setFiltered();
 
+	// Returns null if the upload isn't compressed
+	const ZFilter* getCompressionFilter() const noexcept {
+		return compressionFilter;
+	}
+
 	void appendFlags(OrderedStringSet& flags_) const noexcept override;
 	bool checkDelaySecond() noexcept;
 	void disableDelayCheck() noexcept;
 private:
 	unique_ptr<InputStream> stream;
+	const ZFilter* compressionFilter = nullptr;
 	int8_t delayTime = 0;
 };
 
@@ -0,0 +1,204 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "stdinc.h"
+
+#include <airdcpp/transfer/upload/UploadBlockCache.h>
+
+namespace dcpp {
+
+UploadBlockCache::Block UploadBlockCache::getBlock(const TTHValue& aTTH, int64_t aBlock, int aReadAhead, File& aFile, int64_t aFileSize) {
+	auto blockCount = (aFileSize + BLOCK_SIZE - 1) / BLOCK_SIZE;
+	dcassert(aBlock >= 0 && aBlock < blockCount);
+
+	PendingReadList reads;
+	std::shared_future<Block> pendingRead;
+
+	{
+		Lock l(cs);
+		if (auto i = index.find({ aTTH, aBlock }); i != index.end()) {
+			entries.splice(entries.begin(), entries, i->second);
+			return i->second->second;
+		}
+
+		if (auto p = pendingReads.find({ aTTH, aBlock }); p != pendingReads.end()) {
+			pendingRead = p->second;
+		} else {
+			// Read the following blocks as well unless someone else has done that already
+			// (don't read more than what fits in the cache)
+			auto readAhead = min(static_cast<int64_t>(aReadAhead), maxSize / BLOCK_SIZE);
+			auto lastBlock = min(aBlock + max(readAhead, static_cast<int64_t>(1)), blockCount);
+			for (auto i = aBlock; i < lastBlock; ++i) {
+				BlockKey key{ aTTH, i };
+				if (i != aBlock && (index.contains(key) || pendingReads.contains(key))) {
+					break;
+				}
+
+				std::promise<Block> promise;
+				pendingReads.emplace(key, promise.get_future().share());
+				reads.emplace_back(key, std::move(promise));
+			}
+		}
+	}
+
+	if (pendingRead.valid()) {
+		// Another upload is reading the block already
+		return pendingRead.get();
+	}
+
+	BlockList blocks;
+	try {
+		blocks = readBlocksThrow(aFile, aBlock, reads.size(), aFileSize);
+	} catch (...) {
+		{
+			Lock l(cs);
+			for (const auto& r : reads) {
+				pendingReads.erase(r.first);
+			}
+		}
+
+		for (auto& r : reads) {
+			r.second.set_exception(std::current_exception());
+		}
+
+		throw;
+	}
+
+	{
+		Lock l(cs);
+		for (size_t i = 0; i < reads.size(); ++i) {
+			const auto& key = reads[i].first;
+			pendingReads.erase(key);
+
+			if (maxSize >= BLOCK_SIZE && !index.contains(key)) {
+				entries.emplace_front(key, blocks[i]);
+				index.emplace(key, entries.begin());
+			}
+		}
+
+		evict();
+	}
+
+	for (size_t i = 0; i < reads.size(); ++i) {
+		reads[i].second.set_value(blocks[i]);
+	}
+
+	return blocks.front();
+}
+
+UploadBlockCache::BlockList UploadBlockCache::readBlocksThrow(File& aFile, int64_t aFirstBlock, size_t aBlockCount, int64_t aFileSize) {
+	// Read everything with a single request so that the disk doesn't need to seek between the blocks
+	auto startPos = aFirstBlock * BLOCK_SIZE;
+	auto bytes = static_cast<size_t>(min(static_cast<int64_t>(aBlockCount) * BLOCK_SIZE, aFileSize - startPos));
+
+	ByteVector buf(bytes);
+	size_t pos = 0;
+	while (pos < bytes) {
+		auto n = aFile.readAt(&buf[pos], bytes - pos, startPos + static_cast<int64_t>(pos));
+		if (n == 0) {
+			throw FileException("Unexpected end of file");
+		}
+
+		pos += n;
+	}
+
+	BlockList blocks;
+	for (size_t offset = 0; offset < bytes; offset += BLOCK_SIZE) {
+		auto blockBytes = min(static_cast<size_t>(BLOCK_SIZE), bytes - offset);
+		blocks.push_back(createBlock(buf.begin() + offset, buf.begin() + offset + blockBytes));
+	}
+
+	return blocks;
+}
+
+UploadBlockCache::Block UploadBlockCache::createBlock(ByteVector::const_iterator aBegin, ByteVector::const_iterator aEnd) noexcept {
+	auto data = new ByteVector(aBegin, aEnd);
+	allocatedSize += static_cast<int64_t>(data->size());
+
+	// The uploads are finished before the cache is destructed
+	return Block(data, [this](const ByteVector* aData) {
+		allocatedSize -= static_cast<int64_t>(aData->size());
+		delete aData;
+	});
+}
+
+void UploadBlockCache::clear() noexcept {
+	Lock l(cs);
+	entries.clear();
+	index.clear();
+}
+
+void UploadBlockCache::setMaxSize(int64_t aMaxSize) noexcept {
+	Lock l(cs);
+	maxSize = aMaxSize;
+	evict();
+}
+
+int64_t UploadBlockCache::getMaxSize() const noexcept {
+	Lock l(cs);
+	return maxSize;
+}
+
+void UploadBlockCache::evict() noexcept {
+	// Blocks used by the uploads are released only after they have been read so more cached blocks need to be evicted instead
+	while (allocatedSize > maxSize && !entries.empty()) {
+		const auto& entry = entries.back();
+		index.erase(entry.first);
+		entries.pop_back();
+	}
+}
+
+
+UploadBlockStream::UploadBlockStream(UploadBlockCache& aCache, const TTHValue& aTTH, const string& aPath, int64_t aSize) :
+	cache(aCache), tth(aTTH), file(aPath, File::READ, File::OPEN | File::SHARED_WRITE), size(aSize) { // write for partial sharing
+
+}
+
+size_t UploadBlockStream::read(void* aBuf, size_t& len) {
+	auto buf = static_cast<uint8_t*>(aBuf);
+
+	size_t copied = 0;
+	while (copied < len && pos < size) {
+		auto wantedBlock = pos / UploadBlockCache::BLOCK_SIZE;
+		if (wantedBlock != blockIndex) {
+			if (wantedBlock == blockIndex + 1) {
+				readAhead = min(readAhead * 2, UploadBlockCache::MAX_READ_AHEAD);
+			} else {
+				readAhead = 1;
+			}
+
+			block = cache.getBlock(tth, wantedBlock, readAhead, file, size);
+			blockIndex = wantedBlock;
+		}
+
+		auto offset = static_cast<size_t>(pos - blockIndex * UploadBlockCache::BLOCK_SIZE);
+		if (offset >= block->size()) {
+			break;
+		}
+
+		auto n = min(len - copied, block->size() - offset);
+		memcpy(buf + copied, block->data() + offset, n);
+		copied += n;
+		pos += static_cast<int64_t>(n);
+	}
+
+	len = copied;
+	return copied;
+}
+
+} // namespace dcpp
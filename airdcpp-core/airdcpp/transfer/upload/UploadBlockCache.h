@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef DCPLUSPLUS_DCPP_UPLOAD_BLOCK_CACHE_H
+#define DCPLUSPLUS_DCPP_UPLOAD_BLOCK_CACHE_H
+
+#include <airdcpp/core/header/typedefs.h>
+#include <airdcpp/core/classes/Exception.h>
+#include <airdcpp/core/io/File.h>
+#include <airdcpp/core/thread/CriticalSection.h>
+#include <airdcpp/hash/value/MerkleTree.h>
+
+#include <atomic>
+#include <future>
+#include <list>
+
+namespace dcpp {
+
+// LRU cache for file blocks shared by all uploads
+// Peers downloading the same popular file are served from memory instead of causing random disk reads
+// Blocks that are still being used by uploads count towards the maximum size even after they have been evicted
+class UploadBlockCache {
+public:
+	static constexpr int64_t BLOCK_SIZE = 1024 * 1024;
+
+	// Maximum number of blocks to read from disk with a single request
+	static constexpr int MAX_READ_AHEAD = 8;
+
+	using Block = shared_ptr<const ByteVector>;
+
+	explicit UploadBlockCache(int64_t aMaxSize = 0) noexcept : maxSize(aMaxSize) {}
+
+	// Returns the wanted block of the file
+	// Missing blocks are read from the disk together with up to aReadAhead - 1 following blocks that aren't cached either
+	// Concurrent requests for a block that is being read will wait for the first reader
+	// Throws FileException
+	Block getBlock(const TTHValue& aTTH, int64_t aBlock, int aReadAhead, File& aFile, int64_t aFileSize);
+
+	void clear() noexcept;
+
+	void setMaxSize(int64_t aMaxSize) noexcept;
+	int64_t getMaxSize() const noexcept;
+private:
+	struct BlockKey {
+		TTHValue tth;
+		int64_t block;
+
+		bool operator==(const BlockKey& aOther) const noexcept {
+			return block == aOther.block && tth == aOther.tth;
+		}
+	};
+
+	struct BlockKeyHash {
+		size_t operator()(const BlockKey& aKey) const noexcept {
+			return std::hash<TTHValue>()(aKey.tth) ^ static_cast<size_t>(aKey.block);
+		}
+	};
+
+	using Entry = pair<BlockKey, Block>;
+	using EntryList = std::list<Entry>;
+
+	using BlockList = vector<Block>;
+	using PendingReadList = vector<pair<BlockKey, std::promise<Block>>>;
+
+	BlockList readBlocksThrow(File& aFile, int64_t aFirstBlock, size_t aBlockCount, int64_t aFileSize);
+	Block createBlock(ByteVector::const_iterator aBegin, ByteVector::const_iterator aEnd) noexcept;
+	void evict() noexcept;
+
+	mutable CriticalSection cs;
+
+	// Most recently used blocks first
+	EntryList entries;
+	unordered_map<BlockKey, EntryList::iterator, BlockKeyHash> index;
+
+	// Blocks that are currently being read from the disk
+	unordered_map<BlockKey, std::shared_future<Block>, BlockKeyHash> pendingReads;
+
+	// Size of all blocks in memory (including the ones that have been evicted but are still being used by uploads)
+	std::atomic<int64_t> allocatedSize = 0;
+	int64_t maxSize;
+};
+
+// File stream for uploads that reads the data via the shared block cache
+// The read-ahead window grows while the stream is being read sequentially and resets on seeks
+class UploadBlockStream : public InputStream {
+public:
+	UploadBlockStream(UploadBlockCache& aCache, const TTHValue& aTTH, const string& aPath, int64_t aSize);
+
+	size_t read(void* aBuf, size_t& len) override;
+
+	void setPos(int64_t aPos) noexcept override {
+		pos = aPos;
+	}
+
+	int64_t getSize() const noexcept override {
+		return size;
+	}
+private:
+	UploadBlockCache& cache;
+	const TTHValue tth;
+	File file;
+	const int64_t size;
+	int64_t pos = 0;
+
+	UploadBlockCache::Block block;
+	int64_t blockIndex = -1;
+	int readAhead = 1;
+};
+
+} // namespace dcpp
+
+#endif // !defined(DCPLUSPLUS_DCPP_UPLOAD_BLOCK_CACHE_H)
@@ -28,6 +28,7 @@
 #include <airdcpp/share/ShareManager.h>
 #include <airdcpp/core/io/stream/Streams.h>
 #include <airdcpp/transfer/upload/Upload.h>
+#include <airdcpp/transfer/upload/UploadBlockCache.h>
 #include <airdcpp/connection/UserConnection.h>
 
 
@@ -61,6 +62,16 @@ void UploadParser::toRealWithSize(const UploadRequest& aRequest, ProfileToken aP
 	sourceFile = result.path;
 	fileSize = result.size;
 	provider = result.provider->getProviderName();
+	completeFile = result.provider->hasCompleteFiles();
+}
+
+unique_ptr<InputStream> UploadParser::openFile(const UploadRequest& aRequest) const {
+	// Files with a known TTH can be shared between uploads via the block cache
+	if (type == Transfer::TYPE_FILE && completeFile && blockCache.getMaxSize() > 0 && aRequest.file.compare(0, 4, "TTH/") == 0) {
+		return make_unique<UploadBlockStream>(blockCache, TTHValue(aRequest.file.substr(4)), sourceFile, fileSize);
+	}
+
+	return make_unique<File>(sourceFile, File::READ, File::OPEN | File::SHARED_WRITE); // write for partial sharing
 }
 
 void UploadParser::parseFileInfo(const UploadRequest& aRequest, ProfileToken aProfile, const HintedUser& aUser) {
@@ -126,8 +137,7 @@ Upload* UploadParser::toUpload(UserConnection& aSource, const UploadRequest& aRe
 			}
 
 			if (!is) {
-				auto f = make_unique<File>(sourceFile, File::READ, File::OPEN | File::SHARED_WRITE); // write for partial sharing
-				is = std::move(f);
+				is = openFile(aRequest);
 			}
 
 			is->setPos(startPos);
@@ -28,6 +28,7 @@
 namespace dcpp {
 
 struct StringMatch;
+class UploadBlockCache;
 class UploadQueueManager;
 
 struct ParsedUpload {
@@ -37,6 +38,9 @@ struct ParsedUpload {
 
 	string provider;
 	bool miniSlot = false;
+
+	// Partially downloaded files may still change
+	bool completeFile = true;
 };
 
 class UploadParser : public ParsedUpload {
@@ -50,7 +54,7 @@ public:
 		const bool noAccess;
 	};
 
-	UploadParser(const StringMatch& aFreeSlotMatcher) : freeSlotMatcher(aFreeSlotMatcher) {}
+	UploadParser(const StringMatch& aFreeSlotMatcher, UploadBlockCache& aBlockCache) : freeSlotMatcher(aFreeSlotMatcher), blockCache(aBlockCache) {}
 
 	void parseFileInfo(const UploadRequest& aRequest, ProfileToken aProfile, const HintedUser& aUser);
 	Upload* toUpload(UserConnection& aSource, const UploadRequest& aRequest, unique_ptr<InputStream>& is, ProfileToken aProfile);
@@ -60,7 +64,10 @@ private:
 	ProfileTokenSet getShareProfiles(const HintedUser& aUser) const noexcept;
 
 	void toRealWithSize(const UploadRequest& aRequest, ProfileToken aProfile, const HintedUser& aUser);
+	unique_ptr<InputStream> openFile(const UploadRequest& aRequest) const;
+
 	const StringMatch& freeSlotMatcher;
+	UploadBlockCache& blockCache;
 };
 
 } // namespace dcpp
@@ -47,6 +47,12 @@ UploadManager::UploadManager() noexcept : queue(make_unique<UploadQueueManager>(
 	}, [this](auto ...) {
 		setFreeSlotMatcher();
 	});
+
+	SettingsManager::getInstance()->registerChangeHandler({
+		SettingsManager::UPLOAD_BLOCK_CACHE_SIZE
+	}, [this](auto ...) {
+		setBlockCacheSize();
+	});
 }
 
 UploadManager::~UploadManager() {
@@ -68,6 +74,10 @@ void UploadManager::setFreeSlotMatcher() {
 	freeSlotMatcher.prepare();
 }
 
+void UploadManager::setBlockCacheSize() noexcept {
+	blockCache.setMaxSize(Util::convertSize(max(SETTING(UPLOAD_BLOCK_CACHE_SIZE), 0), Util::MB));
+}
+
 uint8_t UploadManager::getSlots() const noexcept {
 	return static_cast<uint8_t>(AutoLimitUtil::getSlots(false)); 
 }
@@ -118,7 +128,7 @@ bool UploadManager::prepareFile(UserConnection& aSource, const UploadRequest& aR
 	}
 
 	// Check that we have something to send (no disk access at this point)
-	UploadParser creator(freeSlotMatcher);
+	UploadParser creator(freeSlotMatcher, blockCache);
 	try {
 		creator.parseFileInfo(aRequest, *profile, aSource.getHintedUser());
 	} catch (const UploadParser::UploadParserException& e) {
@@ -872,6 +882,11 @@ void UploadManager::on(TimerManagerListener::Second, uint64_t /*aTick*/) noexcep
 
 void UploadManager::on(TimerManagerListener::Minute, uint64_t) noexcept {
 	disconnectOfflineUsers();
+
+	if (getUploadCount() == 0) {
+		// Don't keep the memory reserved while idling
+		blockCache.clear();
+	}
 }
 
 
@@ -29,6 +29,7 @@
 #include <airdcpp/core/Speaker.h>
 #include <airdcpp/util/text/StringMatch.h>
 #include <airdcpp/core/timer/TimerManagerListener.h>
+#include <airdcpp/transfer/upload/UploadBlockCache.h>
 #include <airdcpp/transfer/upload/UploadManagerListener.h>
 #include <airdcpp/transfer/upload/UploadSlot.h>
 #include <airdcpp/connection/UserConnectionListener.h>
@@ -46,6 +47,7 @@ public:
 	ActionHook<OptionalUploadSlot, const UserConnection&, const ParsedUpload&> slotTypeHook;
 
 	void setFreeSlotMatcher();
+	void setBlockCacheSize() noexcept;
 
 	/** @return Number of uploads. */ 
 	size_t getUploadCount() const noexcept;
@@ -98,6 +100,9 @@ private:
 	static void log(const string& aMsg, LogMessage::Severity aSeverity) noexcept;
 	StringMatch freeSlotMatcher;
 
+	// Shared by all file uploads
+	UploadBlockCache blockCache;
+
 	uint8_t runningUsers = 0;
 	uint8_t mcnConnections = 0;
 	uint8_t smallFileConnections = 0;
@@ -582,7 +582,7 @@ private:
 };
 
 struct Compare {
-	int operator()(const string& a, const string& b) const noexcept {
+	int operator()(string_view a, string_view b) const noexcept {
 		return a.compare(b);
 	}
 };
@@ -31,26 +31,45 @@ DualString::DualString(const string& aStr) : str(dcpp::Text::toLower(aStr)) {
 	init(aStr);
 }
 
+DualString::~DualString() {
+	if (!hasInlineMask()) {
+		delete[] charSizes;
+	}
+}
+
 // Set possible uppercase characters
 void DualString::init(const string& aNormalStr) noexcept {
+	if (hasInlineMask()) {
+		inlineCharSizes[0] = inlineCharSizes[1] = 0;
+	} else {
+		charSizes = nullptr;
+	}
+
+	// The bit positions refer to the lowercase string (which is what getNormal iterates),
+	// so all flags of the inline mask fit in it
 	int arrayPos = 0, bitPos = 0;
 	auto a = aNormalStr.c_str();
 	auto b = str.c_str();
-	while (*a) {
+	while (*a && *b) {
 		wchar_t ca = 0, cb = 0;
 		int na = dcpp::Text::utf8ToWc(a, ca);
 		int nb = dcpp::Text::utf8ToWc(b, cb);
 		if (ca != cb) {
-			if (!charSizes) {
-				initSizeArray(aNormalStr.size());
+			if (hasInlineMask()) {
+				dcassert(arrayPos < 2);
+				inlineCharSizes[arrayPos] |= (1 << bitPos);
+			} else {
+				if (!charSizes) {
+					initSizeArray(str.size());
+				}
+				charSizes[arrayPos] |= (1 << bitPos);
 			}
-			charSizes.get()[arrayPos] |= (1 << bitPos);
 		}
 
 		a += abs(na);
 		b += abs(nb);
 
-		bitPos += abs(na);
+		bitPos += abs(nb);
 
 		// move to the next array?
 		if (bitPos >= static_cast<int>(ARRAY_BITS)) {
@@ -66,29 +85,48 @@ size_t DualString::length() const noexcept {
 
 // Create an array with minimum possible length that will store the character sizes (unset=lowercase, set=uppercase)
 size_t DualString::initSizeArray(size_t strLen) noexcept {
-	size_t arrSize = strLen % ARRAY_BITS == 0 ? strLen / ARRAY_BITS : (strLen / ARRAY_BITS) + 1;
-	charSizes = std::make_unique<MaskType[]>(arrSize);
+	auto arrSize = getMaskSize(strLen);
+	charSizes = new MaskType[arrSize];
 	for (size_t s = 0; s < arrSize; ++s) {
-		charSizes.get()[s] = 0;
+		charSizes[s] = 0;
 	}
 
 	return arrSize;
 }
 
-DualString::DualString(DualString&& rhs) noexcept : charSizes(std::move(rhs.charSizes)), str(std::move(rhs.str)) {
+DualString::DualString(DualString&& rhs) noexcept : str(std::move(rhs.str)) {
+	if (hasInlineMask()) {
+		inlineCharSizes[0] = rhs.inlineCharSizes[0];
+		inlineCharSizes[1] = rhs.inlineCharSizes[1];
+	} else {
+		// The const string is copied, so the source will still have the same length
+		charSizes = rhs.charSizes;
+		rhs.charSizes = nullptr;
+	}
 }
 
 string DualString::getNormal() const noexcept {
-	if (!charSizes)
+	if (lowerCaseOnly())
 		return str;
 
+	return toNormal(str, getCharSizes());
+}
+
+size_t DualString::getMaskSize(size_t aLowerLength) noexcept {
+	return aLowerLength % ARRAY_BITS == 0 ? aLowerLength / ARRAY_BITS : (aLowerLength / ARRAY_BITS) + 1;
+}
+
+string DualString::toNormal(std::string_view aLower, const MaskType* aMask) noexcept {
+	if (!aMask)
+		return string(aLower);
+
 	string ret;
-	ret.reserve(length());
+	ret.reserve(aLower.length());
 
 	int bitPos = 0, arrayPos = 0;
-	const char* end = &str.c_str()[0] + str.size();
-	for (const char* p = &str.c_str()[0]; p < end;) {
-		if (charSizes.get()[arrayPos] & (1 << bitPos)) {
+	const char* end = aLower.data() + aLower.size();
+	for (const char* p = aLower.data(); p < end;) {
+		if (aMask[arrayPos] & (1 << bitPos)) {
 			wchar_t c = 0;
 			int n = dcpp::Text::utf8ToWc(p, c);
 
@@ -112,5 +150,9 @@ string DualString::getNormal() const noexcept {
 }
 
 bool DualString::lowerCaseOnly() const noexcept {
+	if (hasInlineMask()) {
+		return inlineCharSizes[0] == 0 && inlineCharSizes[1] == 0;
+	}
+
 	return !charSizes; 
 }
\ No newline at end of file
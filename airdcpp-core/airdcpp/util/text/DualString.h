@@ -20,6 +20,7 @@
 #define DCPLUSPLUS_DUALSTRING
 
 #include <string>
+#include <string_view>
 
 #include <airdcpp/core/header/typedefs.h>
 
@@ -40,15 +41,35 @@ public:
 
 	bool lowerCaseOnly() const noexcept;
 
+	// Uppercase flags for each byte of the lowercase string (nullptr if the string is lowercase only)
+	const MaskType* getMask() const noexcept { return lowerCaseOnly() ? nullptr : getCharSizes(); }
+
+	// Number of mask values needed for a lowercase string of the given length
+	static size_t getMaskSize(size_t aLowerLength) noexcept;
+
+	// Restore the original string from a lowercase string and its mask (for strings stored elsewhere)
+	static string toNormal(std::string_view aLower, const MaskType* aMask) noexcept;
+
 	DualString(DualString&& rhs) noexcept;
 	DualString(const DualString&) = delete;
+	~DualString();
 
 	DualString& operator=(DualString&& rhs) = delete;
 	DualString& operator= (const DualString& other) = delete;
 private:
+	// Strings up to this length store the uppercase flags inline without a separate allocation
+	static constexpr size_t INLINE_MASK_LENGTH = 2 * sizeof(MaskType) * 8;
+
+	bool hasInlineMask() const noexcept { return str.length() <= INLINE_MASK_LENGTH; }
+	const MaskType* getCharSizes() const noexcept { return hasInlineMask() ? inlineCharSizes : charSizes; }
+
 	void init(const string& aNormalStr) noexcept;
 	size_t initSizeArray(size_t strLen) noexcept;
-	std::unique_ptr<MaskType[]> charSizes;
+
+	union {
+		MaskType inlineCharSizes[2];
+		MaskType* charSizes;
+	};
 
 	const string str;
 };
@@ -20,7 +20,6 @@
 #include <airdcpp/util/text/StringMatch.h>
 
 #include <airdcpp/events/LogManager.h>
-#include <airdcpp/util/RegexUtil.h>
 #include <airdcpp/core/localization/ResourceManager.h>
 #include <airdcpp/util/text/StringTokenizer.h>
 
@@ -36,16 +35,15 @@ StringMatch StringMatch::getSearch(const string& aPattern, Method aMethod) {
 }
 
 StringMatch::Method StringMatch::getMethod() const noexcept {
-	return boost::get<StringSearch>(&search) ? PARTIAL : boost::get<string>(&search) ? EXACT : isWildCard ? WILDCARD : REGEX;
+	return boost::get<StringSearch>(&search) ? PARTIAL : boost::get<string>(&search) ? EXACT : boost::get<WildcardMatcher>(&search) ? WILDCARD : REGEX;
 }
 
 void StringMatch::setMethod(Method method) {
-	isWildCard = false;
 	switch(method) {
 		case PARTIAL: search = StringSearch(); break;
 		case EXACT: search = string(); break;
 		case REGEX: search = boost::regex(); break;
-		case WILDCARD: search = boost::regex(); isWildCard=true; break;
+		case WILDCARD: search = WildcardMatcher(); break;
 		//case TTH: search = TTHValue(); break;
 		//case TTH: search = string(); break;
 		case METHOD_LAST: break;
@@ -58,7 +56,7 @@ bool StringMatch::operator==(const StringMatch& rhs) const noexcept {
 }
 
 struct Prepare : boost::static_visitor<bool> {
-	Prepare(const string& aPattern, bool aWildCard, bool aVerbosePatternErrors) : pattern(aPattern), wildCard(aWildCard), verbosePatternErrors(aVerbosePatternErrors) {}
+	Prepare(const string& aPattern, bool aVerbosePatternErrors) : pattern(aPattern), verbosePatternErrors(aVerbosePatternErrors) {}
 	Prepare& operator=(const Prepare&) = delete;
 
 	bool operator()(StringSearch& s) const {
@@ -76,13 +74,13 @@ struct Prepare : boost::static_visitor<bool> {
 		return true;
 	}
 
+	bool operator()(WildcardMatcher& m) const {
+		return m.prepare(pattern);
+	}
+
 	bool operator()(boost::regex& r) const {
 		try {
-			if (wildCard) {
-				r.assign(RegexUtil::regexEscape(pattern, true), boost::regex::icase);
-			} else {
-				r.assign(pattern);
-			}
+			r.assign(pattern);
 			return true;
 		} catch(const std::runtime_error&) {
 			if (verbosePatternErrors) {
@@ -94,13 +92,12 @@ struct Prepare : boost::static_visitor<bool> {
 	}
 
 private:
-	bool wildCard;
 	const string& pattern;
 	bool verbosePatternErrors = true;
 };
 
 bool StringMatch::prepare() {
-	return !pattern.empty() && boost::apply_visitor(Prepare(pattern, isWildCard /*m == WILDCARD*/, verbosePatternErrors), search);
+	return !pattern.empty() && boost::apply_visitor(Prepare(pattern, verbosePatternErrors), search);
 }
 
 struct Match : boost::static_visitor<bool> {
@@ -115,6 +112,10 @@ struct Match : boost::static_visitor<bool> {
 		return Util::stricmp(str, s) == 0;
 	}
 
+	bool operator()(const WildcardMatcher& m) const {
+		return m.match(str);
+	}
+
 	bool operator()(const boost::regex& r) const {
 		try {
 			return !r.empty() && boost::regex_search(str, r);
@@ -21,6 +21,7 @@
 
 #include <airdcpp/forward.h>
 #include <airdcpp/util/text/StringSearch.h>
+#include <airdcpp/util/text/WildcardMatcher.h>
 
 #include <string>
 
@@ -37,7 +38,7 @@ struct StringMatch {
 	enum Method {
 		PARTIAL, /// case-insensitive pattern matching (multiple patterns separated with spaces)
 		REGEX, /// regular expression
-		WILDCARD,
+		WILDCARD, /// case-insensitive wildcard patterns (multiple patterns separated with '|')
 		EXACT, /// case-sensitive, character-for-character equality
 
 		METHOD_LAST
@@ -58,8 +59,7 @@ struct StringMatch {
 
 
 private:
-	boost::variant<StringSearch, string, boost::regex> search;
-	bool isWildCard = false;
+	boost::variant<StringSearch, string, boost::regex, WildcardMatcher> search;
 	bool verbosePatternErrors = true;
 };
 
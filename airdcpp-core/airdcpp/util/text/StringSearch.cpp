@@ -59,8 +59,8 @@ void StringSearch::Pattern::initDelta1() {
 	}
 }
 
-size_t StringSearch::Pattern::matchLower(const string& aText, int aStartPos) const noexcept{
-	dcassert(Text::isLower(aText));
+size_t StringSearch::Pattern::matchLower(string_view aText, int aStartPos) const noexcept{
+	dcassert(Text::isLower(string(aText)));
 	dcassert(pattern.length() == plen);
 	const auto tlen = aText.length() - aStartPos;
 
@@ -68,7 +68,7 @@ size_t StringSearch::Pattern::matchLower(const string& aText, int aStartPos) con
 		return string::npos;
 
 	// uint8_t to avoid problems with signed char pointer arithmetic
-	uint8_t *tx = (uint8_t*) aText.c_str() + aStartPos;
+	uint8_t *tx = (uint8_t*) aText.data() + aStartPos;
 	uint8_t *px = (uint8_t*) pattern.c_str();
 
 	uint8_t *end = tx + tlen - plen + 1;
@@ -78,7 +78,12 @@ size_t StringSearch::Pattern::matchLower(const string& aText, int aStartPos) con
 			;       // Empty!
 
 		if (px[i] == 0) {
-			return distance((uint8_t*)aText.c_str(), tx);
+			return distance((uint8_t*)aText.data(), tx);
+		}
+
+		// The text doesn't need to be null-terminated
+		if (tx + 1 == end) {
+			break;
 		}
 
 		tx += delta1[tx[plen]];
@@ -104,7 +109,7 @@ bool StringSearch::match_all(const string& aText) const {
 	return true;
 }
 
-bool StringSearch::match_any_lower(const string& aText) const {
+bool StringSearch::match_any_lower(string_view aText) const {
 	for (const auto& p : patterns) {
 		if (p.matchLower(aText) != string::npos) {
 			return true;
@@ -118,7 +123,7 @@ bool StringSearch::match_any(const string& aText) const {
 	return match_any_lower(Text::toLower(aText));
 }
 
-int StringSearch::matchLower(const string& aText, bool aResumeOnNoMatch, ResultList* results_) const {
+int StringSearch::matchLower(string_view aText, bool aResumeOnNoMatch, ResultList* results_) const {
 	int matches = 0, listPos = 0;
 	for (const auto& p: patterns) {
 		size_t addPos = string::npos;
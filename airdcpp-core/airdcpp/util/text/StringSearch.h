@@ -45,7 +45,7 @@ public:
 		bool operator==(const Pattern& rhs) { return pattern.compare(rhs.pattern) == 0; }
 
 		/** Match a text against the pattern */
-		size_t matchLower(const string& aText, int aStartPos = 0) const noexcept;
+		size_t matchLower(string_view aText, int aStartPos = 0) const noexcept;
 
 		const string& str() const { return pattern; }
 		inline string::size_type size() const { return plen; }
@@ -66,9 +66,9 @@ public:
 
 	bool match_all(const string& aText) const;
 	bool match_any(const string& aText) const;
-	bool match_any_lower(const string& aText) const;
+	bool match_any_lower(string_view aText) const;
 
-	int matchLower(const string& aText, bool aResumeOnNoMatch, ResultList* results_ = nullptr) const;
+	int matchLower(string_view aText, bool aResumeOnNoMatch, ResultList* results_ = nullptr) const;
 	void addString(const string& aPattern);
 	void clear();
 
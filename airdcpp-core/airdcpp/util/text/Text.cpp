@@ -30,6 +30,13 @@
 
 #include <airdcpp/util/Util.h>
 
+#include <bit>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define DCPP_TEXT_SSE2
+#endif
+
 namespace dcpp {
 
 namespace Text {
@@ -37,9 +44,78 @@ namespace Text {
 const string utf8 = "utf-8"; // optimization
 string systemCharset;
 
+namespace {
+	// False if the current locale maps some ASCII characters to something else than the plain ASCII lowercase
+	// (ASCII runs can't be lowercased without the character conversions in that case)
+	bool plainAsciiLower = true;
+
+	// Returns the length of the leading run of ASCII characters
+	size_t getAsciiPrefixLength(const char* aStr, size_t aLen) noexcept {
+		size_t i = 0;
+#ifdef DCPP_TEXT_SSE2
+		for (; i + 16 <= aLen; i += 16) {
+			auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(aStr + i));
+			auto nonAsciiMask = static_cast<unsigned>(_mm_movemask_epi8(chunk));
+			if (nonAsciiMask != 0) {
+				return i + std::countr_zero(nonAsciiMask);
+			}
+		}
+#else
+		for (; i + 8 <= aLen; i += 8) {
+			uint64_t chunk;
+			memcpy(&chunk, aStr + i, 8);
+			if (chunk & 0x8080808080808080ULL) {
+				break;
+			}
+		}
+#endif
+
+		while (i < aLen && (static_cast<uint8_t>(aStr[i]) & 0x80) == 0) {
+			i++;
+		}
+
+		return i;
+	}
+
+	// Appends the ASCII characters in lowercase
+	void appendAsciiLower(const char* aStr, size_t aLen, string& tgt_) noexcept {
+		auto pos = tgt_.size();
+		tgt_.resize(pos + aLen);
+		auto out = &tgt_[pos];
+
+		size_t i = 0;
+#ifdef DCPP_TEXT_SSE2
+		// ASCII bytes are positive so the signed comparisons can be used
+		const auto beforeA = _mm_set1_epi8('A' - 1);
+		const auto afterZ = _mm_set1_epi8('Z' + 1);
+		const auto caseBit = _mm_set1_epi8(0x20);
+		for (; i + 16 <= aLen; i += 16) {
+			auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(aStr + i));
+			auto isUpper = _mm_and_si128(_mm_cmpgt_epi8(chunk, beforeA), _mm_cmplt_epi8(chunk, afterZ));
+			chunk = _mm_or_si128(chunk, _mm_and_si128(isUpper, caseBit));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), chunk);
+		}
+#endif
+
+		for (; i < aLen; ++i) {
+			auto c = aStr[i];
+			out[i] = (c >= 'A' && c <= 'Z') ? static_cast<char>(c | 0x20) : c;
+		}
+	}
+}
+
 void initialize() {
 	setlocale(LC_ALL, "");
 
+	plainAsciiLower = true;
+	for (wchar_t c = 0; c < 0x80; ++c) {
+		auto plainLower = (c >= L'A' && c <= L'Z') ? static_cast<wchar_t>(c | 0x20) : c;
+		if (toLower(c) != plainLower) {
+			plainAsciiLower = false;
+			break;
+		}
+	}
+
 #ifdef _WIN32
 	char *ctype = setlocale(LC_CTYPE, NULL);
 	if(ctype) {
@@ -80,11 +156,8 @@ int getCodePage(const string& charset) {
 #endif
 
 bool isAscii(const char* str) noexcept {
-	for(const uint8_t* p = (const uint8_t*)str; *p; ++p) {
-		if(*p & 0x80)
-			return false;
-	}
-	return true;
+	auto len = strlen(str);
+	return getAsciiPrefixLength(str, len) == len;
 }
 
 // NOTE: this won't handle UTF-16 surrogate pairs
@@ -173,6 +246,11 @@ string sanitizeUtf8(const string& str) noexcept {
 bool validateUtf8(const string& str) noexcept {
 	string::size_type i = 0;
 	while (i < str.length()) {
+		i += getAsciiPrefixLength(&str[i], str.length() - i);
+		if (i == str.length()) {
+			break;
+		}
+
 		wchar_t dummy = 0;
 		int j = utf8ToWc(&str[i], dummy);
 		if (j < 0)
@@ -213,6 +291,13 @@ string toLower(const string& str) noexcept {
 		return Util::emptyString;
 
 #ifdef _WIN32
+	if (plainAsciiLower && getAsciiPrefixLength(str.c_str(), str.length()) == str.length()) {
+		string tmp;
+		tmp.reserve(str.length());
+		appendAsciiLower(str.c_str(), str.length(), tmp);
+		return tmp;
+	}
+
 	// WinAPI will handle UTF-16 surrogate pairs correctly
 	auto wstr = utf8ToWide(str);
 	return wideToUtf8(Text::toLowerReplace(wstr));
@@ -221,6 +306,16 @@ string toLower(const string& str) noexcept {
 	tmp.reserve(str.length());
 	const char* end = &str[0] + str.length();
 	for(const char* p = &str[0]; p < end;) {
+		if (plainAsciiLower) {
+			// Convert ASCII runs directly
+			auto asciiLen = getAsciiPrefixLength(p, end - p);
+			if (asciiLen > 0) {
+				appendAsciiLower(p, asciiLen, tmp);
+				p += asciiLen;
+				continue;
+			}
+		}
+
 		wchar_t c = 0;
 		int n = utf8ToWc(p, c);
 		if(n < 0) {
@@ -97,8 +97,8 @@ namespace Text {
 	string convert(const string& str, const string& fromCharset, const string& toCharset = "") noexcept;
 #endif
 
-	inline bool isAscii(const string& str) noexcept { return isAscii(str.c_str()); }
 	bool isAscii(const char* str) noexcept;
+	inline bool isAscii(const string& str) noexcept { return isAscii(str.c_str()); }
 	inline char asciiToLower(char c) { dcassert((((uint8_t)c) & 0x80) == 0); return (char)tolower(c); }
 
 	string sanitizeUtf8(const string& str) noexcept;
@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "stdinc.h"
+#include <airdcpp/util/text/WildcardMatcher.h>
+
+#include <airdcpp/util/text/StringTokenizer.h>
+#include <airdcpp/util/text/Text.h>
+
+namespace dcpp {
+
+bool WildcardMatcher::prepare(const string& aPatterns) noexcept {
+	clear();
+
+	StringTokenizer<string> st(aPatterns, '|');
+	for (const auto& pattern: st.getTokens()) {
+		if (pattern.empty()) {
+			continue;
+		}
+
+		auto index = patterns.size();
+		patterns.push_back(pattern);
+
+		auto lower = Text::toLower(pattern);
+		auto wildcardPos = lower.find_first_of("*?");
+		if (wildcardPos == string::npos) {
+			exact.try_emplace(lower, index);
+		} else if (lower.find_first_of("*?", 1) == string::npos && lower.front() == '*') {
+			// *.ext
+			suffixes[lower.size() - 1].try_emplace(lower.substr(1), index);
+		} else if (wildcardPos == lower.size() - 1 && lower.back() == '*') {
+			// name*
+			prefixes[lower.size() - 1].try_emplace(lower.substr(0, lower.size() - 1), index);
+		} else {
+			wildcards.emplace_back(std::move(lower), index);
+		}
+	}
+
+	return !patterns.empty();
+}
+
+void WildcardMatcher::clear() noexcept {
+	patterns.clear();
+	exact.clear();
+	suffixes.clear();
+	prefixes.clear();
+	wildcards.clear();
+}
+
+optional<size_t> WildcardMatcher::findAffix(const AffixMap& aMap, const string& aStr, bool aSuffix) noexcept {
+	for (const auto& [length, entries]: aMap) {
+		if (length > aStr.size()) {
+			break;
+		}
+
+		auto p = entries.find(aSuffix ? aStr.substr(aStr.size() - length) : aStr.substr(0, length));
+		if (p != entries.end()) {
+			return p->second;
+		}
+	}
+
+	return nullopt;
+}
+
+optional<size_t> WildcardMatcher::findMatch(const string& aStr) const noexcept {
+	if (patterns.empty()) {
+		return nullopt;
+	}
+
+	auto lower = Text::toLower(aStr);
+	if (auto p = exact.find(lower); p != exact.end()) {
+		return p->second;
+	}
+
+	if (auto index = findAffix(suffixes, lower, true)) {
+		return index;
+	}
+
+	if (auto index = findAffix(prefixes, lower, false)) {
+		return index;
+	}
+
+	for (const auto& [pattern, index]: wildcards) {
+		if (matchWildcard(pattern, lower)) {
+			return index;
+		}
+	}
+
+	return nullopt;
+}
+
+// Length of the UTF-8 sequence starting with the given byte
+static size_t getCharLength(char c) noexcept {
+	auto b = static_cast<uint8_t>(c);
+	return b < 0xC0 ? 1 : b < 0xE0 ? 2 : b < 0xF0 ? 3 : 4;
+}
+
+bool WildcardMatcher::matchWildcard(const string_view& aPattern, const string_view& aStr) noexcept {
+	size_t p = 0, s = 0;
+
+	// Position after the last '*' and the string position that it currently covers
+	auto starPattern = string_view::npos;
+	size_t starStr = 0;
+
+	while (s < aStr.size()) {
+		if (p < aPattern.size() && aPattern[p] == '*') {
+			starPattern = ++p;
+			starStr = s;
+		} else if (p < aPattern.size() && aPattern[p] == '?') {
+			p++;
+			s = min(s + getCharLength(aStr[s]), aStr.size());
+		} else if (p < aPattern.size() && aPattern[p] == aStr[s]) {
+			p++;
+			s++;
+		} else if (starPattern != string_view::npos) {
+			// Let the last '*' cover one more character (earlier stars never need to be revisited)
+			p = starPattern;
+			starStr = min(starStr + getCharLength(aStr[starStr]), aStr.size());
+			s = starStr;
+		} else {
+			return false;
+		}
+	}
+
+	while (p < aPattern.size() && aPattern[p] == '*') {
+		p++;
+	}
+
+	return p == aPattern.size();
+}
+
+} // namespace dcpp
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef DCPLUSPLUS_DCPP_WILDCARD_MATCHER_H
+#define DCPLUSPLUS_DCPP_WILDCARD_MATCHER_H
+
+#include <airdcpp/core/header/typedefs.h>
+
+namespace dcpp {
+
+/**
+* Case-insensitive matching against a list of wildcard patterns separated with '|' 
+* ('*' matches any number of characters and '?' a single character).
+* 
+* All patterns are compiled into the same set: plain names, suffix patterns (*.ext) and 
+* prefix patterns (name*) are hash table lookups and the remaining patterns are matched 
+* without backtracking, so the cost of a long list stays low.
+*/
+class WildcardMatcher {
+public:
+	// Returns false if the list contains no patterns
+	bool prepare(const string& aPatterns) noexcept;
+	void clear() noexcept;
+
+	// Returns the index of a matching pattern
+	optional<size_t> findMatch(const string& aStr) const noexcept;
+	bool match(const string& aStr) const noexcept { return !!findMatch(aStr); }
+
+	const string& getPattern(size_t aIndex) const noexcept { return patterns[aIndex]; }
+	const StringList& getPatterns() const noexcept { return patterns; }
+	bool empty() const noexcept { return patterns.empty(); }
+
+	// Both strings must be lowercase
+	static bool matchWildcard(const string_view& aPattern, const string_view& aStr) noexcept;
+private:
+	using IndexMap = unordered_map<string, size_t>;
+
+	// Suffix and prefix tables grouped by the pattern length
+	using AffixMap = map<size_t, IndexMap>;
+	static optional<size_t> findAffix(const AffixMap& aMap, const string& aStr, bool aSuffix) noexcept;
+
+	StringList patterns;
+
+	IndexMap exact;
+	AffixMap suffixes;
+	AffixMap prefixes;
+
+	// Lowercase pattern, pattern index
+	vector<pair<string, size_t>> wildcards;
+};
+
+} // namespace dcpp
+
+#endif // !defined(DCPLUSPLUS_DCPP_WILDCARD_MATCHER_H)
@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include <airdcpp/stdinc.h>
+#include <airdcpp/filelist/DirectoryListingDirectory.h>
+#include <airdcpp/search/SearchQuery.h>
+
+#include "TestUtil.h"
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+// Measures the memory usage and traversal speed of a generated filelist tree
+
+using namespace dcpp;
+
+namespace {
+	using Directory = DirectoryListing::Directory;
+
+	const int RUNS = 5;
+	const int DIRECTORY_COUNT = 20000;
+	const int FILES_PER_DIRECTORY = 50;
+
+	size_t getAllocatedBytes() noexcept {
+#ifdef __GLIBC__
+		return mallinfo2().uordblks;
+#else
+		return 0;
+#endif
+	}
+
+	TTHValue makeTTH(int aDirectory, int aFile) noexcept {
+		TTHValue tth;
+		auto value = static_cast<uint64_t>(aDirectory) * FILES_PER_DIRECTORY + aFile + 1;
+		for (size_t i = 0; i < TTHValue::BYTES; ++i) {
+			tth.data[i] = static_cast<uint8_t>(value >> ((i % 8) * 8)) ^ static_cast<uint8_t>(i * 31);
+		}
+
+		return tth;
+	}
+
+	// Same as ListLoader: one name pool for the whole load
+	// File sizes are zero so that the files aren't checked for dupes
+	Directory::Ptr buildTree() {
+		auto names = make_shared<DirectoryListing::NamePool>();
+		DirectoryListing::FileArray::ItemList files;
+
+		auto root = Directory::create(nullptr, ADC_ROOT_STR, Directory::TYPE_NORMAL, 0);
+		for (int d = 0; d < DIRECTORY_COUNT; ++d) {
+			auto dirName = "Some.Release.Name.2024.1080p.WEB.H264-GROUP" + std::to_string(d);
+			auto dir = Directory::create(root.get(), dirName, Directory::TYPE_NORMAL, 0, DirectoryContentInfo::uninitialized(), Util::emptyString, 1700000000);
+			for (int f = 0; f < FILES_PER_DIRECTORY; ++f) {
+				auto fileName = dirName + ".part" + std::to_string(f) + ".rar";
+				files.push_back({ names->add(fileName), 0, makeTTH(d, f), 1700000000 });
+			}
+
+			dir->addFiles(names, files);
+			files.clear();
+		}
+
+		return root;
+	}
+
+	// Same as DirectoryListingSearch::searchRecursive
+	void searchRecursive(const Directory::Ptr& aDir, SearchQuery& aQuery, size_t& results_) {
+		for (const auto& f : aDir->files) {
+			if (aQuery.matchesFile(f->getName(), f->getSize(), f->getRemoteDate(), f->getTTH())) {
+				results_++;
+			}
+		}
+
+		for (const auto& d : aDir->directories | views::values) {
+			searchRecursive(d, aQuery, results_);
+		}
+	}
+
+	void search(const Directory::Ptr& aRoot, const string& aQuery) {
+		size_t results = 0;
+		auto duration = dcpp::test::benchmark(RUNS, [&] {
+			SearchQuery query(aQuery, StringList(), StringList(), Search::MATCH_NAME_PARTIAL);
+			results = 0;
+			searchRecursive(aRoot, query, results);
+		});
+
+		printf("%-32s %8.1f ms (%zu results)\n", ("\"" + aQuery + "\"").c_str(), duration, results);
+	}
+
+	template<typename F>
+	void measure(const string& aName, F&& aF) {
+		printf("%-32s %8.1f ms\n", aName.c_str(), dcpp::test::benchmark(RUNS, aF));
+	}
+}
+
+int main() {
+	Text::initialize();
+
+	auto allocatedBefore = getAllocatedBytes();
+	auto start = std::chrono::steady_clock::now();
+	auto root = buildTree();
+	auto buildDuration = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	auto allocated = getAllocatedBytes() - allocatedBefore;
+
+	auto fileCount = static_cast<size_t>(DIRECTORY_COUNT) * FILES_PER_DIRECTORY;
+	printf("Filelist with %d directories and %zu files\n", DIRECTORY_COUNT, fileCount);
+	printf("%-32s %8.1f ms\n", "Build", buildDuration);
+	printf("%-32s %8.1f MB (%zu bytes per file)\n", "Allocated memory", static_cast<double>(allocated) / 1024 / 1024, allocated / fileCount);
+
+	search(root, "part12 rar");
+	search(root, "group1234");
+	search(root, "no such file");
+
+	measure("Content info", [&] {
+		root->getContentInfoRecursive(false);
+	});
+
+	measure("Hash list", [&] {
+		Directory::TTHSet hashes;
+		root->getHashList(hashes);
+	});
+
+	measure("Bundle file list", [&] {
+		root->toBundleInfoList();
+	});
+
+	start = std::chrono::steady_clock::now();
+	root = nullptr;
+	printf("%-32s %8.1f ms\n", "Destroy", std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+	return 0;
+}
@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include <airdcpp/stdinc.h>
+#include <airdcpp/filelist/DirectoryListingDirectory.h>
+
+#include "TestUtil.h"
+
+// Checks the file arrays of filelist directories: the fields, parents and tokens are
+// resolved from the array and the names stay available for as long as a file pointer is held
+
+using namespace dcpp;
+
+namespace {
+	using Directory = DirectoryListing::Directory;
+	using File = DirectoryListing::File;
+	using FileArray = DirectoryListing::FileArray;
+	using NamePool = DirectoryListing::NamePool;
+
+	TTHValue makeTTH(uint8_t aValue) noexcept {
+		TTHValue tth;
+		fill_n(tth.data, TTHValue::BYTES, aValue);
+		return tth;
+	}
+
+	const string names[] = {
+		"a",
+		"File.txt",
+		"\xc3\x89t\xc3\xa9 Caf\xc3\xa9.mkv",
+		string(300, 'x'),
+		// Larger than a pool block
+		string(2 * 1024 * 1024, 'y'),
+	};
+
+	// File sizes are zero so that the files aren't checked for dupes
+	FileArray::ItemList toItems(NamePool& aNames, const string* aBegin, const string* aEnd, uint8_t aFirstTTH) {
+		FileArray::ItemList items;
+		auto tth = aFirstTTH;
+		for (auto n = aBegin; n != aEnd; ++n) {
+			items.push_back({ aNames.add(*n), 0, makeTTH(tth), static_cast<time_t>(1700000000 + tth) });
+			tth++;
+		}
+
+		return items;
+	}
+
+	void testFiles() {
+		auto names_ = make_shared<NamePool>();
+		auto root = Directory::create(nullptr, ADC_ROOT_STR, Directory::TYPE_NORMAL, 0);
+		auto dir = Directory::create(root.get(), "Directory", Directory::TYPE_NORMAL, 0);
+
+		dir->addFiles(names_, toItems(*names_, std::begin(names), std::end(names), 1));
+		TEST_CHECK(dir->files.size() == std::size(names));
+
+		// Files added later are stored in another array
+		const string moreNames[] = { "More 1", "More 2" };
+		dir->addFiles(names_, toItems(*names_, std::begin(moreNames), std::end(moreNames), 100));
+		TEST_CHECK(dir->files.size() == std::size(names) + std::size(moreNames));
+
+		// Empty lists don't create arrays
+		dir->addFiles(names_, FileArray::ItemList());
+		TEST_CHECK(dir->files.size() == std::size(names) + std::size(moreNames));
+
+		for (size_t i = 0; i < dir->files.size(); ++i) {
+			const auto& f = dir->files[i];
+			const auto& name = i < std::size(names) ? names[i] : moreNames[i - std::size(names)];
+			auto tth = static_cast<uint8_t>(i < std::size(names) ? i + 1 : 100 + i - std::size(names));
+
+			TEST_CHECK_MSG(f->getName() == name, dcpp::test::escape(name.substr(0, 64)));
+			TEST_CHECK(f->getParent() == dir.get());
+			TEST_CHECK(f->getTTH() == makeTTH(tth));
+			TEST_CHECK(f->getRemoteDate() == static_cast<time_t>(1700000000 + tth));
+			TEST_CHECK(f->getSize() == 0);
+			TEST_CHECK(f->getDupe() == DUPE_NONE);
+			TEST_CHECK(!f->getOwner());
+			TEST_CHECK(f->getAdcPathUnsafe() == "/Directory/" + name);
+			TEST_CHECK(f == name);
+
+			for (size_t j = 0; j < i; ++j) {
+				TEST_CHECK(dir->files[j]->getToken() != f->getToken());
+			}
+		}
+
+		TEST_CHECK(names_->getAllocatedBytes() >= names[4].size());
+
+		// Sorting
+		auto sorted = dir->files;
+		ranges::sort(sorted, File::Sort());
+		TEST_CHECK(sorted.front()->getName() == "File.txt");
+		TEST_CHECK(sorted.back()->getName() == names[2]);
+	}
+
+	void testCopy() {
+		auto names_ = make_shared<NamePool>();
+		auto root = Directory::create(nullptr, ADC_ROOT_STR, Directory::TYPE_NORMAL, 0);
+		auto dir = Directory::create(root.get(), "Directory", Directory::TYPE_NORMAL, 0);
+		dir->addFiles(names_, toItems(*names_, std::begin(names), std::begin(names) + 2, 1));
+
+		const auto& source = dir->files[1];
+		source->setDupe(DUPE_QUEUE_FULL);
+
+		int owner = 0;
+		auto copy = File::copy(*source, &owner);
+		TEST_CHECK(copy->getName() == source->getName());
+		TEST_CHECK(copy->getParent() == dir.get());
+		TEST_CHECK(copy->getTTH() == source->getTTH());
+		TEST_CHECK(copy->getRemoteDate() == source->getRemoteDate());
+		TEST_CHECK(copy->getDupe() == DUPE_QUEUE_FULL);
+		TEST_CHECK(copy->getOwner() == &owner);
+		TEST_CHECK(copy->getToken() != source->getToken());
+	}
+
+	void testLifetime() {
+		File::Ptr file;
+		File::Ptr copy;
+
+		{
+			auto names_ = make_shared<NamePool>();
+			auto root = Directory::create(nullptr, ADC_ROOT_STR, Directory::TYPE_NORMAL, 0);
+			auto dir = Directory::create(root.get(), "Directory", Directory::TYPE_NORMAL, 0);
+			dir->addFiles(names_, toItems(*names_, std::begin(names), std::end(names), 1));
+
+			file = dir->files[3];
+			copy = File::copy(*dir->files[2], nullptr);
+
+			// Removing files from the list doesn't move the remaining ones
+			auto token = file->getToken();
+			std::erase_if(dir->files, [](const File::Ptr& f) { return f->getName() == "a"; });
+			TEST_CHECK(dir->files.size() == std::size(names) - 1);
+			TEST_CHECK(file->getToken() == token);
+			TEST_CHECK(dir->files[2] == file);
+		}
+
+		// The pointers keep the arrays and the name pool alive
+		TEST_CHECK(file->getName() == names[3]);
+		TEST_CHECK(file->getTTH() == makeTTH(4));
+		TEST_CHECK(copy->getName() == names[2]);
+	}
+}
+
+int main() {
+	Text::initialize();
+
+	testFiles();
+	testCopy();
+	testLifetime();
+
+	return dcpp::test::result();
+}
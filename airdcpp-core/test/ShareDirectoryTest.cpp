@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include <airdcpp/stdinc.h>
+#include <airdcpp/hash/HashedFile.h>
+#include <airdcpp/search/SearchQuery.h>
+#include <airdcpp/share/ShareDirectory.h>
+
+#include "TestUtil.h"
+
+// Checks the file records that ShareDirectory stores in the arena: names are restored
+// with the original case, lookups and searches use the stored lowercase names and
+// replaced or removed records are returned to the arena
+
+using namespace dcpp;
+
+namespace {
+	TTHValue makeTTH(uint8_t aValue) noexcept {
+		TTHValue tth;
+		fill_n(tth.data, TTHValue::BYTES, aValue);
+		return tth;
+	}
+
+	// Names around the length of the inline uppercase mask of DualString (64 bytes)
+	const string names[] = {
+		"",
+		"a",
+		"B",
+		"file.txt",
+		"Other.TXT",
+		"\xc3\x89t\xc3\xa9 Caf\xc3\xa9.mkv",
+		string(63, 'x') + "Y",
+		string(64, 'x') + "Y",
+		"Y" + string(64, 'x'),
+		string(100, 'x') + "Y" + string(100, 'z') + "\xc3\x89",
+		string(300, 'x'),
+	};
+
+	void testNames() {
+		ShareBloom bloom(1 << 10);
+		ShareTreeMaps maps([&bloom] { return &bloom; });
+		int64_t sharedSize = 0;
+
+		auto root = ShareDirectory::createRoot("/share/", "Share", { 0 }, false, 0, maps, 0);
+		auto dir = ShareDirectory::createNormal(DualString("Directory"), root, 0, maps);
+
+		uint8_t tthValue = 1;
+		for (const auto& name : names) {
+			if (!name.empty()) {
+				dir->addFile(DualString(name), HashedFile(makeTTH(tthValue++), 0, name.size()), maps, sharedSize);
+			}
+		}
+
+		TEST_CHECK(dir->getFiles().size() == size(names) - 1);
+		for (const auto& name : names) {
+			if (name.empty()) {
+				TEST_CHECK(!dir->findFileLower(name));
+				continue;
+			}
+
+			auto nameLower = Text::toLower(name);
+			auto file = dir->findFileLower(nameLower);
+			TEST_CHECK_MSG(file, dcpp::test::escape(name));
+			if (!file) {
+				continue;
+			}
+
+			TEST_CHECK_MSG(file->getName() == name, dcpp::test::escape(file->getName()));
+			TEST_CHECK_MSG(file->getNameLower() == nameLower, dcpp::test::escape(string(file->getNameLower())));
+			TEST_CHECK(file->isLowerCaseOnly() == (name == nameLower));
+			TEST_CHECK(file->getSize() == static_cast<int64_t>(name.size()));
+			TEST_CHECK(file->getParent() == dir.get());
+			TEST_CHECK(file->getAdcPath() == "/Share/Directory/" + name);
+		}
+
+		// The files are sorted by their lowercase names
+		TEST_CHECK(is_sorted(dir->getFiles().begin(), dir->getFiles().end(), [](const ShareDirectory::File* a, const ShareDirectory::File* b) {
+			return a->getNameLower() < b->getNameLower();
+		}));
+
+		TEST_CHECK(sharedSize == dir->getLevelSize());
+		TEST_CHECK(maps.tthIndex.size() == size(names) - 1);
+	}
+
+	void testReplace() {
+		ShareBloom bloom(1 << 10);
+		ShareTreeMaps maps([&bloom] { return &bloom; });
+		int64_t sharedSize = 0;
+
+		auto root = ShareDirectory::createRoot("/share/", "Share", { 0 }, false, 0, maps, 0);
+		root->addFile(DualString("Name.txt"), HashedFile(makeTTH(1), 0, 100), maps, sharedSize);
+		auto usedBytes = maps.getArena()->getUsedBytes();
+
+		// Same name with a different case replaces the file
+		root->addFile(DualString("NAME.TXT"), HashedFile(makeTTH(2), 0, 50), maps, sharedSize);
+		TEST_CHECK(root->getFiles().size() == 1);
+		TEST_CHECK(root->getFiles().front()->getName() == "NAME.TXT");
+		TEST_CHECK(root->getFiles().front()->getTTH() == makeTTH(2));
+		TEST_CHECK(sharedSize == 50);
+		TEST_CHECK(maps.tthIndex.size() == 1);
+		TEST_CHECK(maps.getArena()->getUsedBytes() == usedBytes);
+	}
+
+	void testArena() {
+		ShareBloom bloom(1 << 10);
+		ShareTreeMaps maps([&bloom] { return &bloom; });
+		int64_t sharedSize = 0;
+
+		auto arena = maps.getArena();
+		{
+			auto root = ShareDirectory::createRoot("/share/", "Share", { 0 }, false, 0, maps, 0);
+			for (int i = 0; i < 10000; ++i) {
+				auto dir = ShareDirectory::createNormal(DualString("Directory " + std::to_string(i)), root, 0, maps);
+				dir->addFile(DualString("File " + std::to_string(i)), HashedFile(makeTTH(static_cast<uint8_t>(i)), 0, i), maps, sharedSize);
+			}
+
+			TEST_CHECK(arena->getUsedBytes() > 0);
+			TEST_CHECK(arena->getReservedBytes() >= arena->getUsedBytes());
+
+			// The directories keep the arena alive
+			TEST_CHECK(root->getDirectories().front()->getArena() == arena);
+
+			SearchQuery query("file 123", StringList(), StringList(), Search::MATCH_PATH_PARTIAL);
+			ShareDirectory::SearchResultInfo::Set results;
+			root->search(results, query, 0);
+
+			// "File 123", "File 1230"..."File 1239" and "File N123"
+			TEST_CHECK_MSG(results.size() == 20, std::to_string(results.size()));
+
+			maps.rootPaths.clear();
+			maps.lowerDirNameMap.clear();
+			maps.tthIndex.clear();
+		}
+
+		TEST_CHECK(arena->getUsedBytes() == 0);
+	}
+}
+
+int main() {
+	Text::initialize();
+
+	testNames();
+	testReplace();
+	testArena();
+
+	return dcpp::test::result();
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include <airdcpp/stdinc.h>
+#include <airdcpp/hash/HashedFile.h>
+#include <airdcpp/search/SearchQuery.h>
+#include <airdcpp/share/ShareDirectory.h>
+
+#include "TestUtil.h"
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+// Measures the memory usage and search speed of a generated share tree
+
+using namespace dcpp;
+
+namespace {
+	const int RUNS = 5;
+	const int DIRECTORY_COUNT = 20000;
+	const int FILES_PER_DIRECTORY = 50;
+
+	size_t getAllocatedBytes() noexcept {
+#ifdef __GLIBC__
+		return mallinfo2().uordblks;
+#else
+		return 0;
+#endif
+	}
+
+	TTHValue makeTTH(int aDirectory, int aFile) noexcept {
+		TTHValue tth;
+		auto value = static_cast<uint64_t>(aDirectory) * FILES_PER_DIRECTORY + aFile + 1;
+		for (size_t i = 0; i < TTHValue::BYTES; ++i) {
+			tth.data[i] = static_cast<uint8_t>(value >> ((i % 8) * 8)) ^ static_cast<uint8_t>(i * 31);
+		}
+
+		return tth;
+	}
+
+	ShareDirectory::Ptr buildTree(ShareTreeMaps& maps_, int64_t& sharedSize_) {
+		auto root = ShareDirectory::createRoot("/share/", "Share", { 0 }, false, 0, maps_, 0);
+		for (int d = 0; d < DIRECTORY_COUNT; ++d) {
+			auto dirName = "Some.Release.Name.2024.1080p.WEB.H264-GROUP" + std::to_string(d);
+			auto dir = ShareDirectory::createNormal(DualString(dirName), root, 1700000000, maps_);
+			for (int f = 0; f < FILES_PER_DIRECTORY; ++f) {
+				// Every fourth name is lowercase only
+				auto fileName = (f % 4 == 0 ? "some.release.name.2024.1080p.web.h264-group" : "Some.Release.Name.2024.1080p.WEB.H264-GROUP") + std::to_string(d) + ".part" + std::to_string(f) + ".rar";
+				dir->addFile(DualString(fileName), HashedFile(makeTTH(d, f), 1700000000, 50000000 + f), maps_, sharedSize_);
+			}
+		}
+
+		return root;
+	}
+
+	void search(const ShareDirectory::Ptr& aRoot, const string& aQuery, const StringList& aExtensions) {
+		size_t results = 0;
+		auto duration = dcpp::test::benchmark(RUNS, [&] {
+			SearchQuery query(aQuery, StringList(), aExtensions, Search::MATCH_PATH_PARTIAL);
+			ShareDirectory::SearchResultInfo::Set resultInfos;
+			aRoot->search(resultInfos, query, 0);
+			results = resultInfos.size();
+		});
+
+		printf("%-32s %8.1f ms (%zu results)\n", ("\"" + aQuery + "\"").c_str(), duration, results);
+	}
+}
+
+int main() {
+	Text::initialize();
+
+	ShareBloom bloom(1 << 20);
+	ShareTreeMaps maps([&bloom] { return &bloom; });
+	int64_t sharedSize = 0;
+
+	auto allocatedBefore = getAllocatedBytes();
+	auto start = std::chrono::steady_clock::now();
+	auto root = buildTree(maps, sharedSize);
+	auto buildDuration = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	auto allocated = getAllocatedBytes() - allocatedBefore;
+
+	auto fileCount = static_cast<size_t>(DIRECTORY_COUNT) * FILES_PER_DIRECTORY;
+	printf("Share tree with %d directories and %zu files\n", DIRECTORY_COUNT, fileCount);
+	printf("%-32s %8.1f ms\n", "Build", buildDuration);
+	printf("%-32s %8.1f MB (%zu bytes per file)\n", "Allocated memory", static_cast<double>(allocated) / 1024 / 1024, allocated / fileCount);
+
+	search(root, "part12 rar", StringList());
+	search(root, "group1234", StringList());
+	search(root, "h264 part7", { "rar" });
+	search(root, "no such file", StringList());
+
+	start = std::chrono::steady_clock::now();
+	root = nullptr;
+	maps.rootPaths.clear();
+	maps.lowerDirNameMap.clear();
+	maps.tthIndex.clear();
+	printf("%-32s %8.1f ms\n", "Destroy", std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+	return 0;
+}
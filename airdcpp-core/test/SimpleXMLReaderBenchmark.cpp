@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include <airdcpp/stdinc.h>
+#include <airdcpp/core/io/xml/SimpleXMLReader.h>
+
+#include "TestUtil.h"
+
+// Measures the parsing speed of SimpleXMLReader with a generated file list
+// The document is parsed both at once and in chunks of the size used when reading file lists from disk
+
+using namespace dcpp;
+
+namespace {
+	const int RUNS = 5;
+	const int DIRECTORY_COUNT = 10000;
+	const int FILES_PER_DIRECTORY = 25;
+
+	class CountingCallBack : public SimpleXMLReader::CallBack {
+	public:
+		void startTag(const string& aName, StringPairList& aAttribs, bool) override {
+			tags++;
+			bytes += aName.size();
+			for (const auto& [name, value] : aAttribs) {
+				bytes += name.size() + value.size();
+			}
+		}
+
+		void endTag(const string&) override {
+			tags++;
+		}
+
+		size_t tags = 0;
+		size_t bytes = 0;
+	};
+
+	string makeFileList() {
+		string xml = "<?xml version=\"1.0\" encoding=\"utf-8\" standalone=\"yes\"?>\r\n";
+		xml += "<FileListing Version=\"1\" CID=\"ABCDEFGHIJKLMNOPQRSTUVWXYZ234567ABCDEFG\" Base=\"/\" Generator=\"AirDC++ 4.21\">\r\n";
+		for (int d = 0; d < DIRECTORY_COUNT; ++d) {
+			xml += "<Directory Name=\"Some.Release.Name.2024.1080p.WEB.H264-GROUP" + std::to_string(d) + "\" Date=\"1700000000\">\r\n";
+			for (int f = 0; f < FILES_PER_DIRECTORY; ++f) {
+				xml += "<File Name=\"some.release.name.2024.1080p.web.h264-group.part" + std::to_string(f) + (f % 5 == 0 ? " &amp; sample" : "") + ".rar\" Size=\"" + std::to_string(50000000 + f) + "\" TTH=\"ABCDEFGHIJKLMNOPQRSTUVWXYZ234567ABCDEFG\" Date=\"1700000000\"/>\r\n";
+			}
+
+			xml += "</Directory>\r\n";
+		}
+
+		xml += "</FileListing>\r\n";
+		return xml;
+	}
+
+	void run(const char* aName, const string& aXml, size_t aChunkSize) {
+		CountingCallBack cb;
+		auto duration = dcpp::test::benchmark(RUNS, [&] {
+			SimpleXMLReader reader(&cb);
+			for (size_t pos = 0; pos < aXml.size(); pos += aChunkSize) {
+				reader.parse(aXml.c_str() + pos, min(aChunkSize, aXml.size() - pos));
+			}
+		});
+
+		printf("%-24s %8.1f ms %8.1f MB/s (%zu tags, %zu bytes)\n", aName, duration, static_cast<double>(aXml.size()) / 1024 / 1024 / (duration / 1000), cb.tags, cb.bytes);
+	}
+}
+
+int main() {
+	auto xml = makeFileList();
+	printf("File list of %.1f MB (%d directories, %d files)\n", static_cast<double>(xml.size()) / 1024 / 1024, DIRECTORY_COUNT, DIRECTORY_COUNT * FILES_PER_DIRECTORY);
+
+	run("Whole document", xml, xml.size());
+	run("64 KiB chunks", xml, 64 * 1024);
+	run("4 KiB chunks", xml, 4 * 1024);
+	return 0;
+}
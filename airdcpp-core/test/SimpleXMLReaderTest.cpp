@@ -0,0 +1,183 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include <airdcpp/stdinc.h>
+#include <airdcpp/core/classes/Exception.h>
+#include <airdcpp/core/io/xml/SimpleXMLReader.h>
+
+#include "TestUtil.h"
+
+// Parses fixed documents with SimpleXMLReader and compares the callbacks with the expected output
+// Each document is also fed in small chunks to cover values that are split between buffer refills
+
+using namespace dcpp;
+
+namespace {
+	// Writes the callbacks in an XML-like form: <name a="value"> [data] </name>
+	class RecordingCallBack : public SimpleXMLReader::CallBack {
+	public:
+		void startTag(const string& aName, StringPairList& aAttribs, bool aSimple) override {
+			output += "<" + aName;
+			for (const auto& [name, value] : aAttribs) {
+				output += " " + name + "=\"" + value + "\"";
+			}
+
+			output += aSimple ? "/>" : ">";
+		}
+
+		void data(const string& aData) override {
+			output += "[" + aData + "]";
+		}
+
+		void endTag(const string& aName) override {
+			output += "</" + aName + ">";
+		}
+
+		string output;
+	};
+
+	// Parses the document in chunks of the wanted size (0 for the whole document at once)
+	string parse(const string& aXml, size_t aChunkSize) {
+		RecordingCallBack cb;
+		SimpleXMLReader reader(&cb);
+		try {
+			if (aChunkSize == 0) {
+				reader.parse(aXml);
+			} else {
+				for (size_t pos = 0; pos < aXml.size(); pos += aChunkSize) {
+					reader.parse(aXml.c_str() + pos, min(aChunkSize, aXml.size() - pos));
+				}
+			}
+		} catch (const SimpleXMLException& e) {
+			cb.output += "error: " + e.getError();
+		}
+
+		return cb.output;
+	}
+
+	// The error position depends on the chunk boundaries for some errors
+	string stripErrorPosition(const string& aOutput) {
+		auto pos = aOutput.find("error: ");
+		if (pos == string::npos) {
+			return aOutput;
+		}
+
+		auto end = aOutput.find(": ", pos + 7);
+		return aOutput.substr(0, pos + 7) + (end == string::npos ? aOutput.substr(pos + 7) : aOutput.substr(end + 2));
+	}
+
+	const size_t chunkSizes[] = { 1, 2, 3, 5, 7, 15, 16, 17, 31, 32, 33, 64 };
+
+	void check(const string& aXml, const string& aExpected) {
+		auto output = parse(aXml, 0);
+		TEST_CHECK_MSG(output == aExpected, dcpp::test::escape(aXml.substr(0, 100)) + ": " + dcpp::test::escape(output.substr(0, 200)));
+
+		for (auto chunkSize : chunkSizes) {
+			auto chunkedOutput = parse(aXml, chunkSize);
+			TEST_CHECK_MSG(stripErrorPosition(chunkedOutput) == stripErrorPosition(aExpected), "chunk size " + std::to_string(chunkSize) + ", " + dcpp::test::escape(aXml.substr(0, 100)) + ": " + dcpp::test::escape(chunkedOutput.substr(0, 200)));
+		}
+	}
+
+	void testEntities() {
+		check(
+			"<a>x &amp; y &lt;z&gt; &quot;q&quot; &apos;s&apos;&#65;&#x4A;.</a>",
+			"<a>[x & y <z> \"q\" 's'.]</a>"
+		);
+
+		check(
+			"<a x=\"1 &amp; 2\" y='&lt;&quot;&gt;' z=\"&#x41;b\"/>",
+			"<a x=\"1 & 2\" y=\"<\">\" z=\"b\"/>"
+		);
+
+		// Entities at the vector block boundaries
+		check(
+			"<a v=\"0123456789abcd&amp;0123456789abcde&lt;0123456789abcdef&gt;\">0123456789abc&amp;0123456789abcdefghi&apos;</a>",
+			"<a v=\"0123456789abcd&0123456789abcde<0123456789abcdef>\">[0123456789abc&0123456789abcdefghi']</a>"
+		);
+	}
+
+	void testAttributes() {
+		check(
+			"<?xml version=\"1.0\" encoding=\"utf-8\"?><FileListing Version=\"1\" Base=\"/Some Directory/\"><Directory Name=\"Name with 'quotes'\" Date='1700000000'><File Name=\"a file name that is longer than sixteen bytes.mkv\" Size=\"123\" TTH=\"ABCDEFGHIJKLMNOPQRSTUVWXYZ234567ABCDEFG\"/></Directory></FileListing>",
+			"<FileListing Version=\"1\" Base=\"/Some Directory/\"><Directory Name=\"Name with 'quotes'\" Date=\"1700000000\"><File Name=\"a file name that is longer than sixteen bytes.mkv\" Size=\"123\" TTH=\"ABCDEFGHIJKLMNOPQRSTUVWXYZ234567ABCDEFG\"/></Directory></FileListing>"
+		);
+
+		// Spaces and the other quote character inside values
+		check(
+			"<a  first = \"x'y\"\tsecond='x\"y'   empty=\"\" />",
+			"<a first=\"x'y\" second=\"x\"y\" empty=\"\"/>"
+		);
+
+		// Incomplete documents produce no callbacks
+		check("<a b=\"c\" b2=\"d></a>", "");
+	}
+
+	void testContent() {
+		check("<a>1<b>2</b>3<c/>4</a>", "<a>[1]<b>[2]</b>[3]<c/>[4]</a>");
+		check("<a><![CDATA[x]]y]>z<&]]]></a>", "<a>[x]]y]>z<&]]</a>");
+		check("<a><!-- comment - -- -> --><b/></a>", "<a><b/></a>");
+		check("<a>\xc3\x89t\xc3\xa9 0123456789abcdef</a>", "<a>[\xc3\x89t\xc3\xa9 0123456789abcdef]</a>");
+	}
+
+	void testLimits() {
+		const auto maxValue = SimpleXMLReader::MAX_VALUE_SIZE;
+
+		// Character data can reach maxLen + 1 characters (the size is checked before each character)
+		for (auto length : { maxValue - 1, maxValue, maxValue + 1 }) {
+			string value(length, 'x');
+			check("<a>" + value + "</a>", "<a>[" + value + "]</a>");
+		}
+
+		check("<a>" + string(maxValue + 2, 'x') + "</a>", "<a>error: " + std::to_string(3 + maxValue + 1) + ": Buffer overflow");
+		check("<a>" + string(maxValue + 16, 'x') + "</a>", "<a>error: " + std::to_string(3 + maxValue + 1) + ": Buffer overflow");
+
+		// Entities are checked in the same way
+		check("<a>" + string(maxValue, 'x') + "&amp;</a>", "<a>[" + string(maxValue, 'x') + "&]</a>");
+		check("<a>" + string(maxValue + 1, 'x') + "&amp;</a>", "<a>error: " + std::to_string(3 + maxValue + 1) + ": Buffer overflow");
+
+		{
+			string value(maxValue, 'x');
+			check("<a><![CDATA[" + value + "]]></a>", "<a>[" + value + "]</a>");
+			check("<a><![CDATA[" + value + "y]]></a>", "<a>[" + value + "y]</a>");
+			check("<a><![CDATA[" + value + "yz]]></a>", "<a>error: " + std::to_string(12 + maxValue + 1) + ": Buffer overflow");
+		}
+
+		// Attribute values are limited to maxLen characters
+		{
+			string value(maxValue, 'x');
+			check("<a v=\"" + value + "\"/>", "<a v=\"" + value + "\"/>");
+			check("<a v=\"" + value + "y\"/>", "error: 6: Buffer overflow");
+		}
+
+		// Names
+		{
+			string name(SimpleXMLReader::MAX_NAME_SIZE, 'n');
+			check("<" + name + "/>", "<" + name + "/>");
+			check("<a " + name + "=\"v\"/>", "<a " + name + "=\"v\"/>");
+		}
+	}
+}
+
+int main() {
+	testEntities();
+	testAttributes();
+	testContent();
+	testLimits();
+
+	return dcpp::test::result();
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef DCPLUSPLUS_TEST_TEST_UTIL_H
+#define DCPLUSPLUS_TEST_TEST_UTIL_H
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <string>
+
+// Minimal helpers for the core tests (each test is a separate executable run by CTest)
+
+namespace dcpp::test {
+
+inline int failures = 0;
+
+inline void reportFailure(const char* aFile, int aLine, const char* aExpression, const std::string& aDetails) noexcept {
+	failures++;
+	fprintf(stderr, "%s:%d: check failed: %s%s%s\n", aFile, aLine, aExpression, aDetails.empty() ? "" : ", ", aDetails.c_str());
+}
+
+// Printable form of a test input (non-printable bytes are escaped)
+inline std::string escape(const std::string& aStr) noexcept {
+	std::string ret = "\"";
+	for (auto c : aStr) {
+		if (c >= 0x20 && c < 0x7f && c != '\\' && c != '"') {
+			ret += c;
+		} else {
+			char tmp[8];
+			snprintf(tmp, sizeof(tmp), "\\x%02x", static_cast<unsigned char>(c));
+			ret += tmp;
+		}
+	}
+
+	return ret + "\"";
+}
+
+// Returns the exit code of the test
+inline int result() noexcept {
+	if (failures > 0) {
+		fprintf(stderr, "%d check(s) failed\n", failures);
+		return 1;
+	}
+
+	return 0;
+}
+
+// Returns the fastest of the runs in milliseconds
+inline double benchmark(int aRuns, const std::function<void ()>& aF) noexcept {
+	double best = 0;
+	for (int i = 0; i < aRuns; ++i) {
+		auto start = std::chrono::steady_clock::now();
+		aF();
+		auto duration = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		if (i == 0 || duration < best) {
+			best = duration;
+		}
+	}
+
+	return best;
+}
+
+} // namespace dcpp::test
+
+#define TEST_CHECK(expr) \
+	do { if (!(expr)) dcpp::test::reportFailure(__FILE__, __LINE__, #expr, std::string()); } while (false)
+
+#define TEST_CHECK_MSG(expr, details) \
+	do { if (!(expr)) dcpp::test::reportFailure(__FILE__, __LINE__, #expr, details); } while (false)
+
+#endif // !defined(DCPLUSPLUS_TEST_TEST_UTIL_H)
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include <airdcpp/stdinc.h>
+#include <airdcpp/util/text/Text.h>
+
+#include "TestUtil.h"
+#include "TextReference.h"
+
+// Compares the speed of the vectorized Text functions with the character-by-character implementations
+
+using namespace dcpp;
+
+namespace {
+	const int RUNS = 5;
+	const int NAME_COUNT = 1000000;
+
+	StringList makeNames(bool aUnicode) {
+		StringList ret;
+		ret.reserve(NAME_COUNT);
+		for (int i = 0; i < NAME_COUNT; ++i) {
+			auto name = "Some.Release.Name.2024.1080p.WEB.H264-GROUP" + std::to_string(i) + (aUnicode ? "/\xc3\x89t\xc3\xa9.Caf\xc3\xa9" : "/Sample.Part") + ".mkv";
+			ret.push_back(std::move(name));
+		}
+
+		return ret;
+	}
+
+	template<class F>
+	void run(const char* aName, const StringList& aNames, const F& aVectorized, const F& aReference) {
+		size_t checksum = 0;
+		auto vectorized = dcpp::test::benchmark(RUNS, [&] {
+			for (const auto& name : aNames) {
+				checksum += aVectorized(name);
+			}
+		});
+
+		auto reference = dcpp::test::benchmark(RUNS, [&] {
+			for (const auto& name : aNames) {
+				checksum += aReference(name);
+			}
+		});
+
+		printf("%-24s %8.1f ms %8.1f ms %6.1fx (%zu)\n", aName, vectorized, reference, reference / vectorized, checksum);
+	}
+
+	void runAll(const char* aTitle, const StringList& aNames) {
+		using TextF = std::function<size_t (const string&)>;
+
+		printf("\n%s (%d names)\n", aTitle, NAME_COUNT);
+		printf("%-24s %11s %11s %7s\n", "", "vectorized", "reference", "speedup");
+
+		run<TextF>("toLower", aNames, [](const string& s) { return Text::toLower(s).size(); }, [](const string& s) { return TextReference::toLower(s).size(); });
+		run<TextF>("validateUtf8", aNames, [](const string& s) { return Text::validateUtf8(s); }, [](const string& s) { return TextReference::validateUtf8(s); });
+		run<TextF>("isAscii", aNames, [](const string& s) { return Text::isAscii(s); }, [](const string& s) { return TextReference::isAscii(s); });
+	}
+}
+
+int main() {
+	Text::initialize();
+
+	runAll("ASCII file names", makeNames(false));
+	runAll("File names with non-ASCII characters", makeNames(true));
+	return 0;
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef DCPLUSPLUS_TEST_TEXT_REFERENCE_H
+#define DCPLUSPLUS_TEST_TEXT_REFERENCE_H
+
+#include <airdcpp/util/text/Text.h>
+
+// Character-by-character implementations of the Text functions that have vectorized ASCII paths
+
+namespace dcpp::TextReference {
+	inline string toLower(const string& aStr) {
+		string ret;
+		const char* end = aStr.c_str() + aStr.length();
+		for (const char* p = aStr.c_str(); p < end;) {
+			wchar_t c = 0;
+			int n = Text::utf8ToWc(p, c);
+			if (n < 0) {
+				ret += '_';
+				p += abs(n);
+			} else {
+				p += n;
+				Text::wcToUtf8(Text::toLower(c), ret);
+			}
+		}
+
+		return ret;
+	}
+
+	inline bool validateUtf8(const string& aStr) {
+		for (size_t i = 0; i < aStr.length(); ) {
+			wchar_t c = 0;
+			int n = Text::utf8ToWc(&aStr[i], c);
+			if (n < 0) {
+				return false;
+			}
+
+			i += n;
+		}
+
+		return true;
+	}
+
+	inline bool isAscii(const string& aStr) {
+		for (auto c : aStr) {
+			if (c == 0) {
+				break;
+			}
+
+			if (static_cast<uint8_t>(c) & 0x80) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
+
+#endif // !defined(DCPLUSPLUS_TEST_TEXT_REFERENCE_H)
@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include <airdcpp/stdinc.h>
+#include <airdcpp/util/text/Text.h>
+
+#include "TestUtil.h"
+#include "TextReference.h"
+
+// Compares the vectorized ASCII paths of Text::toLower, Text::validateUtf8 and Text::isAscii
+// with character-by-character implementations on inputs around the 16-byte block boundaries
+
+using namespace dcpp;
+
+namespace {
+	void checkEqual(const string& aStr) {
+		auto valid = TextReference::validateUtf8(aStr);
+		TEST_CHECK_MSG(Text::validateUtf8(aStr) == valid, dcpp::test::escape(aStr));
+		TEST_CHECK_MSG(Text::isAscii(aStr) == TextReference::isAscii(aStr), dcpp::test::escape(aStr));
+
+#ifdef _WIN32
+		// Invalid sequences are converted by WinAPI
+		if (!valid) {
+			return;
+		}
+#endif
+
+		TEST_CHECK_MSG(Text::toLower(aStr) == TextReference::toLower(aStr), dcpp::test::escape(aStr));
+	}
+
+	// Mixed case ASCII text of the wanted length
+	string makeAscii(size_t aLength) {
+		const string chars = "AbCdEfGhIjKlMnOpQrStUvWxYzZ@[`{09 ._-";
+
+		string ret;
+		for (size_t i = 0; i < aLength; ++i) {
+			ret += chars[i % chars.size()];
+		}
+
+		return ret;
+	}
+
+	const size_t boundaryLengths[] = { 0, 1, 15, 16, 17, 31, 32, 33, 47, 48, 49, 64 };
+
+	// Multibyte and invalid sequences that are inserted at each position
+	const string sequences[] = {
+		"\xc3\x89", // É
+		"\xe2\x82\xac", // €
+		"\xf0\x9f\x8c\x8d", // Emoji
+		"\xd0\x96", // Ж
+		"\x80", // Lone continuation byte
+		"\xbf",
+		"\xff",
+		"\xc3\x28", // Invalid continuation bytes
+		"\xe2\x28\xa1",
+		"\xe2\x82\x28",
+		"\xf0\x28\x8c\xbc",
+		"\xf0\x90\x28\xbc",
+		"\xc0\xaf", // Overlong encodings
+		"\xe0\x80\xaf",
+		"\xf0\x80\x80\xaf",
+		"\xed\xa0\x80", // Surrogate
+		"\xf4\x90\x80\x80", // Above U+10FFFF
+	};
+
+	// Sequences that are cut at the end of the input
+	const string truncatedSequences[] = {
+		"\xc3",
+		"\xe2",
+		"\xe2\x82",
+		"\xf0",
+		"\xf0\x9f",
+		"\xf0\x9f\x8c",
+	};
+
+	void testBoundaries() {
+		for (auto length : boundaryLengths) {
+			checkEqual(makeAscii(length));
+
+			// Non-ASCII sequence at each lane position
+			for (size_t pos = 0; pos <= length; ++pos) {
+				for (const auto& sequence : sequences) {
+					auto str = makeAscii(length);
+					str.insert(pos, sequence);
+					checkEqual(str);
+
+					// Replacing keeps the length (e.g. 16 bytes in total)
+					if (pos + sequence.size() <= length) {
+						str = makeAscii(length);
+						str.replace(pos, sequence.size(), sequence);
+						checkEqual(str);
+					}
+				}
+			}
+
+			for (const auto& sequence : truncatedSequences) {
+				auto str = makeAscii(length) + sequence;
+				checkEqual(str);
+				TEST_CHECK_MSG(!Text::validateUtf8(str), dcpp::test::escape(str));
+
+				// Truncated sequence followed by ASCII
+				str += makeAscii(length);
+				checkEqual(str);
+				TEST_CHECK_MSG(!Text::validateUtf8(str), dcpp::test::escape(str));
+			}
+		}
+	}
+
+	void testExpected() {
+		TEST_CHECK(Text::toLower("ABCd1") == "abcd1");
+		TEST_CHECK(Text::toLower(makeAscii(33)) == "abcdefghijklmnopqrstuvwxyzz@[`{09");
+		TEST_CHECK(Text::toLower("@[`{") == "@[`{");
+
+		TEST_CHECK(Text::isAscii(makeAscii(32)));
+		TEST_CHECK(!Text::isAscii(makeAscii(16) + "\x80"));
+		TEST_CHECK(!Text::isAscii("\xc3\x89" + makeAscii(31)));
+
+		TEST_CHECK(Text::validateUtf8(makeAscii(15) + "\xe2\x82\xac" + makeAscii(15)));
+		TEST_CHECK(!Text::validateUtf8(makeAscii(15) + "\x80" + makeAscii(16)));
+		TEST_CHECK(!Text::validateUtf8(makeAscii(16) + "\xc3\x28"));
+		TEST_CHECK(!Text::validateUtf8(makeAscii(31) + "\xe2\x82"));
+	}
+}
+
+int main() {
+	Text::initialize();
+
+	testExpected();
+	testBoundaries();
+
+	return dcpp::test::result();
+}
@@ -103,7 +103,7 @@ namespace webserver {
 		auto start = aRequest.getRangeParam(START_POS);
 		auto count = aRequest.getRangeParam(MAX_COUNT);
 
-		auto j = Serializer::serializeItemList(start, count, OnlineUserUtils::propertyHandler, users);
+		auto j = OnlineUserUtils::serializeUserList(start, count, users);
 		aRequest.setResponseBody(j);
 		return websocketpp::http::status_code::ok;
 	}
@@ -24,6 +24,8 @@
 #include <api/common/Serializer.h>
 #include <api/common/Format.h>
 
+#include <airdcpp/core/geo/GeoManager.h>
+
 namespace webserver {
 	const PropertyList OnlineUserUtils::properties = {
 		{ PROP_NICK, "nick", TYPE_TEXT, SERIALIZE_TEXT, SORT_CUSTOM },
@@ -61,6 +63,40 @@ namespace webserver {
 		return nullptr;
 	}
 
+	json OnlineUserUtils::serializeUserList(int aStart, int aCount, const OnlineUserList& aUsers) {
+		if (aStart < 0) {
+			throw std::domain_error("Invalid range");
+		}
+
+		// IPv4 and IPv6 address of each user in the range (same range as in Serializer::serializeFromPosition)
+		StringList ips;
+		auto listSize = static_cast<int>(aUsers.size());
+		if (aStart < listSize && aCount > 0) {
+			auto end = aStart + min(listSize - aStart, aCount);
+			for (auto i = aStart; i < end; ++i) {
+				const auto& identity = aUsers[i]->getIdentity();
+				ips.push_back(identity.getIp4());
+				ips.push_back(identity.getIp6());
+			}
+		}
+
+		auto countries = GeoManager::getInstance()->getCountries(ips);
+
+		// Other properties are serialized normally
+		auto propertyIds = toPropertyIdSet(properties);
+		propertyIds.erase(PROP_IP4);
+		propertyIds.erase(PROP_IP6);
+
+		size_t pos = 0;
+		return Serializer::serializeFromPosition(aStart, aCount, aUsers, [&](const OnlineUserPtr& aUser) {
+			auto j = Serializer::serializePartialItem(aUser, propertyHandler, propertyIds);
+			j[properties[PROP_IP4].name] = Serializer::serializeIp(ips[pos], countries[pos]);
+			j[properties[PROP_IP6].name] = Serializer::serializeIp(ips[pos + 1], countries[pos + 1]);
+			pos += 2;
+			return j;
+		});
+	}
+
 	int OnlineUserUtils::compareUsers(const OnlineUserPtr& a, const OnlineUserPtr& b, int aPropertyName) noexcept {
 		switch (aPropertyName) {
 		case PROP_NICK: {
@@ -56,6 +56,11 @@ namespace webserver {
 
 		static json serializeUser(const OnlineUserPtr& aUser, int aPropertyName) noexcept;
 
+		// Serialize a range of users with all properties
+		// Countries of the IP addresses are resolved with a single lookup
+		// Throws for invalid range parameters
+		static json serializeUserList(int aStart, int aCount, const OnlineUserList& aUsers);
+
 		static int compareUsers(const OnlineUserPtr& a, const OnlineUserPtr& b, int aPropertyName) noexcept;
 		static std::string getStringInfo(const OnlineUserPtr& a, int aPropertyName) noexcept;
 		static double getNumericInfo(const OnlineUserPtr& a, int aPropertyName) noexcept;
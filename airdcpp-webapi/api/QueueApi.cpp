@@ -668,32 +668,30 @@ namespace webserver {
 	// FILE LISTENERS
 	void QueueApi::on(QueueManagerListener::ItemAdded, const QueueItemPtr& aQI) noexcept {
 		fileView.onItemAdded(aQI);
-		if (!subscriptionActive("queue_file_added"))
-			return;
-
-		send("queue_file_added", Serializer::serializeItem(aQI, QueueFileUtils::propertyHandler));
+		maybeSendShared("queue_file_added", aQI.get(), [&] {
+			return Serializer::serializeItem(aQI, QueueFileUtils::propertyHandler);
+		});
 	}
 
 	void QueueApi::on(QueueManagerListener::ItemRemoved, const QueueItemPtr& aQI, bool /*finished*/) noexcept {
 		fileView.onItemRemoved(aQI);
-		if (!subscriptionActive("queue_file_removed"))
-			return;
-
-		send("queue_file_removed", Serializer::serializeItem(aQI, QueueFileUtils::propertyHandler));
+		maybeSendShared("queue_file_removed", aQI.get(), [&] {
+			return Serializer::serializeItem(aQI, QueueFileUtils::propertyHandler);
+		});
 	}
 
 	void QueueApi::onFileUpdated(const QueueItemPtr& aQI, const PropertyIdSet& aUpdatedProperties, const string& aSubscription) {
 		fileView.onItemUpdated(aQI, aUpdatedProperties);
-		if (subscriptionActive(aSubscription)) {
-			// Serialize full item for more specific updates to make reading of data easier 
-			// (such as cases when the script is interested only in finished files)
-			send(aSubscription, Serializer::serializeItem(aQI, QueueFileUtils::propertyHandler));
-		}
+		// Serialize full item for more specific updates to make reading of data easier 
+		// (such as cases when the script is interested only in finished files)
+		maybeSendShared(aSubscription, aQI.get(), [&] {
+			return Serializer::serializeItem(aQI, QueueFileUtils::propertyHandler);
+		});
 
-		if (subscriptionActive("queue_file_updated")) {
-			// Serialize updated properties only
-			send("queue_file_updated", Serializer::serializePartialItem(aQI, QueueFileUtils::propertyHandler, aUpdatedProperties));
-		}
+		// Serialize updated properties only
+		maybeSendShared("queue_file_updated", aQI.get(), [&] {
+			return Serializer::serializePartialItem(aQI, QueueFileUtils::propertyHandler, aUpdatedProperties);
+		});
 	}
 
 	void QueueApi::on(QueueManagerListener::ItemSources, const QueueItemPtr& aQI) noexcept {
@@ -728,31 +726,29 @@ namespace webserver {
 	// BUNDLE LISTENERS
 	void QueueApi::on(QueueManagerListener::BundleAdded, const BundlePtr& aBundle) noexcept {
 		bundleView.onItemAdded(aBundle);
-		if (!subscriptionActive("queue_bundle_added"))
-			return;
-
-		send("queue_bundle_added", Serializer::serializeItem(aBundle, QueueBundleUtils::propertyHandler));
+		maybeSendShared("queue_bundle_added", aBundle.get(), [&] {
+			return Serializer::serializeItem(aBundle, QueueBundleUtils::propertyHandler);
+		});
 	}
 	void QueueApi::on(QueueManagerListener::BundleRemoved, const BundlePtr& aBundle) noexcept {
 		bundleView.onItemRemoved(aBundle);
-		if (!subscriptionActive("queue_bundle_removed"))
-			return;
-
-		send("queue_bundle_removed", Serializer::serializeItem(aBundle, QueueBundleUtils::propertyHandler));
+		maybeSendShared("queue_bundle_removed", aBundle.get(), [&] {
+			return Serializer::serializeItem(aBundle, QueueBundleUtils::propertyHandler);
+		});
 	}
 
 	void QueueApi::onBundleUpdated(const BundlePtr& aBundle, const PropertyIdSet& aUpdatedProperties, const string& aSubscription) {
 		bundleView.onItemUpdated(aBundle, aUpdatedProperties);
-		if (subscriptionActive(aSubscription)) {
-			// Serialize full item for more specific updates to make reading of data easier 
-			// (such as cases when the script is interested only in finished bundles)
-			send(aSubscription, Serializer::serializeItem(aBundle, QueueBundleUtils::propertyHandler));
-		}
+		// Serialize full item for more specific updates to make reading of data easier 
+		// (such as cases when the script is interested only in finished bundles)
+		maybeSendShared(aSubscription, aBundle.get(), [&] {
+			return Serializer::serializeItem(aBundle, QueueBundleUtils::propertyHandler);
+		});
 
-		if (subscriptionActive("queue_bundle_updated")) {
-			// Serialize updated properties only
-			send("queue_bundle_updated", Serializer::serializePartialItem(aBundle, QueueBundleUtils::propertyHandler, aUpdatedProperties));
-		}
+		// Serialize updated properties only
+		maybeSendShared("queue_bundle_updated", aBundle.get(), [&] {
+			return Serializer::serializePartialItem(aBundle, QueueBundleUtils::propertyHandler, aUpdatedProperties);
+		});
 	}
 
 	void QueueApi::on(QueueManagerListener::BundleSize, const BundlePtr& aBundle) noexcept {
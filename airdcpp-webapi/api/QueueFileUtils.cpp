@@ -63,7 +63,7 @@ namespace webserver {
 		switch (aPropertyName) {
 		case PROP_NAME: return getDisplayName(aItem);
 		case PROP_TARGET: return aItem->getTarget();
-		case PROP_TYPE: return Util::formatFileType(aItem->getTarget());
+		case PROP_TYPE: return Util::formatFileType(aItem->getTargetFileName());
 		case PROP_STATUS: return formatDisplayStatus(aItem);
 		case PROP_PRIORITY: return Util::formatPriority(aItem->getPriority());
 		case PROP_SOURCES: return formatFileSources(aItem);
@@ -90,7 +90,14 @@ namespace webserver {
 
 	string QueueFileUtils::getDisplayName(const QueueItemPtr& aItem) noexcept {
 		if (aItem->getBundle() && !aItem->getBundle()->isFileBundle()) {
-			return aItem->getTarget().substr(aItem->getBundle()->getTarget().size(), aItem->getTarget().size());
+			// Path relative to the bundle directory
+			const auto& target = aItem->getQueueTarget();
+			auto bundleDirLength = aItem->getBundle()->getTarget().size();
+			if (bundleDirLength <= target.getDirectory().size()) {
+				return target.getDirectory().substr(bundleDirLength) + target.getFileName();
+			}
+
+			return target.str().substr(bundleDirLength);
 		}
 
 		return aItem->getTargetFileName();
@@ -99,10 +106,10 @@ namespace webserver {
 	int QueueFileUtils::compareFiles(const QueueItemPtr& a, const QueueItemPtr& b, int aPropertyName) noexcept {
 		switch (aPropertyName) {
 		case PROP_NAME: {
-			return PathUtil::pathSort(a->getTarget(), b->getTarget());
+			return QueueTarget::pathSort(a->getQueueTarget(), b->getQueueTarget());
 		}
 		case PROP_TYPE: {
-			return Util::stricmp(PathUtil::getFileExt(a->getTarget()), PathUtil::getFileExt(b->getTarget()));
+			return Util::stricmp(PathUtil::getFileExt(a->getTargetFileName()), PathUtil::getFileExt(b->getTargetFileName()));
 		}
 		case PROP_PRIORITY: {
 			COMPARE_IS_DOWNLOADED(a, b);
@@ -169,7 +176,7 @@ namespace webserver {
 		}
 		case PROP_TYPE:
 		{
-			return Serializer::serializeFileType(aFile->getTarget());
+			return Serializer::serializeFileType(aFile->getTargetFileName());
 		}
 		}
 
@@ -169,13 +169,13 @@ namespace webserver {
 		auto realPath = aFile->getRealPath();
 		return {
 			{ "id", ValueGenerator::generatePathId(realPath) },
-			{ "name", aFile->getName().getNormal() },
+			{ "name", aFile->getName() },
 			{ "path", realPath },
 			{ "virtual_path", aFile->getAdcPath() },
 			{ "size", aFile->getSize() },
 			{ "tth", aFile->getTTH().toBase32() },
 			{ "time", aFile->getLastWrite() },
-			{ "type", Serializer::serializeFileType(aFile->getName().getLower()) },
+			{ "type", Serializer::serializeFileType(string(aFile->getNameLower())) },
 			{ "profiles", aFile->getParent()->getRootProfiles() },
 		};
 	}
@@ -29,6 +29,7 @@
 #include <api/SystemApi.h>
 #include <api/common/Serializer.h>
 
+#include <airdcpp/DCPlusPlus.h>
 #include <airdcpp/hub/activity/ActivityManager.h>
 #include <airdcpp/hub/ClientManager.h>
 #include <airdcpp/core/localization/Localization.h>
@@ -135,10 +136,24 @@ namespace webserver {
 		aRequest.setResponseBody({
 			{ "server_threads", WEBCFG(SERVER_THREADS).num() },
 			{ "active_sessions", server->getUserManager().getUserSessionCount() },
+			{ "startup_phases", serializeStartupPhases() },
 		});
 		return websocketpp::http::status_code::ok;
 	}
 
+	json SystemApi::serializeStartupPhases() noexcept {
+		auto ret = json::array();
+		for (const auto& phase: getStartupPhases()) {
+			ret.push_back({
+				{ "id", phase.id },
+				{ "started", phase.started },
+				{ "duration", phase.duration },
+			});
+		}
+
+		return ret;
+	}
+
 	json SystemApi::getSystemInfo() noexcept {
 		auto started = TimerManager::getStartTime();
 		return {
@@ -34,6 +34,7 @@ namespace webserver {
 	private:
 		static string getAwayState(AwayMode aAwayMode) noexcept;
 		static json serializeAwayState() noexcept;
+		static json serializeStartupPhases() noexcept;
 
 		api_return handleGetAwayState(ApiRequest& aRequest);
 		api_return handleSetAway(ApiRequest& aRequest);
@@ -178,9 +178,9 @@ namespace webserver {
 
 	void TransferApi::on(TransferInfoManagerListener::Added, const TransferInfoPtr& aInfo) noexcept {
 		view.onItemAdded(aInfo);
-		if (subscriptionActive("transfer_added")) {
-			send("transfer_added", Serializer::serializeItem(aInfo, TransferUtils::propertyHandler));
-		}
+		maybeSendShared("transfer_added", aInfo.get(), [&] {
+			return Serializer::serializeItem(aInfo, TransferUtils::propertyHandler);
+		});
 	}
 
 	PropertyIdSet TransferApi::updateFlagsToPropertyIds(int aUpdatedProperties) noexcept {
@@ -214,6 +214,8 @@ namespace webserver {
 			updatedProps.insert(TransferUtils::PROP_ENCRYPTION);
 		if (aUpdatedProperties & TransferInfo::UpdateFlags::QUEUE_ID)
 			updatedProps.insert(TransferUtils::PROP_QUEUE_ID);
+		if (aUpdatedProperties & TransferInfo::UpdateFlags::COMPRESSION)
+			updatedProps.insert(TransferUtils::PROP_COMPRESSION);
 		if (aUpdatedProperties & TransferInfo::UpdateFlags::STATE)
 			updatedProps.insert(TransferUtils::PROP_STATUS);
 
@@ -224,33 +226,33 @@ namespace webserver {
 		auto updatedProps = updateFlagsToPropertyIds(aUpdatedProperties);
 
 		view.onItemUpdated(aInfo, updatedProps);
-		if (subscriptionActive("transfer_updated")) {
-			send("transfer_updated", Serializer::serializePartialItem(aInfo, TransferUtils::propertyHandler, updatedProps));
-		}
+		maybeSendShared("transfer_updated", aInfo.get(), [&] {
+			return Serializer::serializePartialItem(aInfo, TransferUtils::propertyHandler, updatedProps);
+		});
 	}
 
 	void TransferApi::on(TransferInfoManagerListener::Removed, const TransferInfoPtr& aInfo) noexcept {
 		view.onItemRemoved(aInfo);
-		if (subscriptionActive("transfer_removed")) {
-			send("transfer_removed", Serializer::serializeItem(aInfo, TransferUtils::propertyHandler));
-		}
+		maybeSendShared("transfer_removed", aInfo.get(), [&] {
+			return Serializer::serializeItem(aInfo, TransferUtils::propertyHandler);
+		});
 	}
 
 	void TransferApi::on(TransferInfoManagerListener::Failed, const TransferInfoPtr& aInfo) noexcept { 
-		if (subscriptionActive("transfer_failed")) {
-			send("transfer_failed", Serializer::serializeItem(aInfo, TransferUtils::propertyHandler));
-		}
+		maybeSendShared("transfer_failed", aInfo.get(), [&] {
+			return Serializer::serializeItem(aInfo, TransferUtils::propertyHandler);
+		});
 	}
 
 	void TransferApi::on(TransferInfoManagerListener::Starting, const TransferInfoPtr& aInfo) noexcept {
-		if (subscriptionActive("transfer_starting")) {
-			send("transfer_starting", Serializer::serializeItem(aInfo, TransferUtils::propertyHandler));
-		}
+		maybeSendShared("transfer_starting", aInfo.get(), [&] {
+			return Serializer::serializeItem(aInfo, TransferUtils::propertyHandler);
+		});
 	}
 
 	void TransferApi::on(TransferInfoManagerListener::Completed, const TransferInfoPtr& aInfo) noexcept {
-		if (subscriptionActive("transfer_completed")) {
-			send("transfer_completed", Serializer::serializeItem(aInfo, TransferUtils::propertyHandler));
-		}
+		maybeSendShared("transfer_completed", aInfo.get(), [&] {
+			return Serializer::serializeItem(aInfo, TransferUtils::propertyHandler);
+		});
 	}
 }
\ No newline at end of file
@@ -42,6 +42,7 @@ namespace webserver {
 		{ PROP_SUPPORTS, "supports", TYPE_LIST_TEXT, SERIALIZE_CUSTOM, SORT_NONE },
 		{ PROP_ENCRYPTION, "encryption", TYPE_TEXT, SERIALIZE_CUSTOM, SORT_TEXT },
 		{ PROP_QUEUE_ID, "queue_file_id", TYPE_NUMERIC_OTHER, SERIALIZE_CUSTOM, SORT_NUMERIC },
+		{ PROP_COMPRESSION, "compression", TYPE_NUMERIC_OTHER, SERIALIZE_CUSTOM, SORT_NUMERIC },
 	};
 
 	const PropertyItemHandler<TransferInfoPtr> TransferUtils::propertyHandler = {
@@ -72,6 +73,7 @@ namespace webserver {
 		case PROP_SPEED: return (double)aItem->getSpeed();
 		case PROP_SECONDS_LEFT: return (double)aItem->getTimeLeft();
 		case PROP_QUEUE_ID: return (double)aItem->getQueueToken();
+		case PROP_COMPRESSION: return aItem->getCompressionRatio();
 		default: dcassert(0); return 0;
 		}
 	}
@@ -145,6 +147,18 @@ namespace webserver {
 
 				return aItem->getQueueToken();
 			}
+			case PROP_COMPRESSION:
+			{
+				if (aItem->getCompressionRatio() < 0) {
+					return nullptr;
+				}
+
+				return {
+					{ "ratio", aItem->getCompressionRatio() },
+					{ "level", aItem->getCompressionLevel() },
+					{ "time", aItem->getCompressionTime() },
+				};
+			}
 		}
 
 		dcassert(0);
@@ -47,6 +47,7 @@ namespace webserver {
 			PROP_SUPPORTS,
 			PROP_ENCRYPTION,
 			PROP_QUEUE_ID,
+			PROP_COMPRESSION,
 			PROP_LAST
 		};
 
@@ -208,6 +208,11 @@ namespace webserver {
 			return send(aSubscription, aCallback());
 		}
 
+		bool maybeSendShared(const string& aSubscription, const void*, const SubscribableApiModule::JsonCallback& aCallback) override {
+			// Messages contain the entity ID
+			return maybeSend(aSubscription, aCallback);
+		}
+
 		bool subscriptionActive(const string& aSubscription) const noexcept override {
 			// Enabled across all entities?
 			if (parentModule->subscriptionActive(aSubscription)) {
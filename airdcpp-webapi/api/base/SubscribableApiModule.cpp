@@ -25,7 +25,17 @@
 
 #include <api/base/SubscribableApiModule.h>
 
+#include <airdcpp/core/Speaker.h>
+
 namespace webserver {
+	// Serialized event data for the listener call that is currently being handled in this thread
+	struct SharedEventCache {
+		uint64_t dispatchId = 0;
+		map<tuple<string, const void*, WebSocket::Encoding>, string> events;
+	};
+
+	static thread_local SharedEventCache sharedEventCache;
+
 	SubscribableApiModule::SubscribableApiModule(Session* aSession, Access aSubscriptionAccess) : ApiModule(aSession), subscriptionAccess(aSubscriptionAccess) {
 		socket = aSession->getServer()->getSocketManager().getSocket(aSession->getId());
 
@@ -120,4 +130,42 @@ namespace webserver {
 
 		return send(aSubscription, aCallback());
 	}
+
+	bool SubscribableApiModule::maybeSendShared(const string& aSubscription, const void* aEntity, const JsonCallback& aCallback) {
+		if (!subscriptionActive(aSubscription)) {
+			return false;
+		}
+
+		auto dispatchId = SpeakerDispatch::getCurrentId();
+		if (dispatchId == 0) {
+			// Not called from a listener
+			return send(aSubscription, aCallback());
+		}
+
+		auto s = socket;
+		if (!s) {
+			return false;
+		}
+
+		auto& cache = sharedEventCache;
+		if (cache.dispatchId != dispatchId) {
+			cache.events.clear();
+			cache.dispatchId = dispatchId;
+		}
+
+		auto key = make_tuple(aSubscription, aEntity, s->getEncoding());
+		try {
+			auto i = cache.events.find(key);
+			if (i == cache.events.end()) {
+				i = cache.events.emplace(std::move(key), s->serialize(aCallback())).first;
+			}
+
+			s->sendSerialized(s->createEventMessage(aSubscription, i->second));
+		} catch (const json::exception& e) {
+			s->logError("Failed to convert data to JSON: " + string(e.what()), websocketpp::log::elevel::fatal);
+			return false;
+		}
+
+		return true;
+	}
 }
\ No newline at end of file
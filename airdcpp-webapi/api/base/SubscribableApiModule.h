@@ -43,6 +43,10 @@ namespace webserver {
 		using JsonCallback = std::function<json ()>;
 		virtual bool maybeSend(const string& aSubscription, const JsonCallback& aCallback);
 
+		// Send an event with data that is identical for all sessions (such as an event from a core manager)
+		// The data is serialized only once for all modules receiving the same listener call (aEntity should identify the item being serialized)
+		virtual bool maybeSendShared(const string& aSubscription, const void* aEntity, const JsonCallback& aCallback);
+
 		virtual void setSubscriptionState(const string& aSubscription, bool aActive) noexcept {
 			subscriptions[aSubscription] = aActive;
 		}
@@ -28,15 +28,29 @@
 #include <websocketpp/http/constants.hpp>
 #include <websocketpp/config/asio.hpp>
 #include <websocketpp/server.hpp>
+#include <websocketpp/extensions/permessage_deflate/enabled.hpp>
 
 #include "json.h"
 
 
 namespace webserver {
+	// Permessage-deflate compression is used for socket messages if the client requests it
+	struct permessage_deflate_config {
+		typedef websocketpp::http::parser::request request_type;
+	};
+
+	struct config_plain : public websocketpp::config::asio {
+		typedef websocketpp::extensions::permessage_deflate::enabled<permessage_deflate_config> permessage_deflate_type;
+	};
+
+	struct config_tls : public websocketpp::config::asio_tls {
+		typedef websocketpp::extensions::permessage_deflate::enabled<permessage_deflate_config> permessage_deflate_type;
+	};
+
 	// define types for two different server endpoints, one for each config we are
 	// using
-	typedef websocketpp::server<websocketpp::config::asio> server_plain;
-	typedef websocketpp::server<websocketpp::config::asio_tls> server_tls;
+	typedef websocketpp::server<config_plain> server_plain;
+	typedef websocketpp::server<config_tls> server_tls;
 	typedef websocketpp::http::status_code::value api_return;
 
 	typedef std::function<void(api_return aStatus, const std::string& aOutput, const std::vector<std::pair<std::string, std::string>>& aHeaders)> HTTPFileCompletionF;
@@ -41,6 +41,9 @@
 
 #include <sstream>
 
+// Files (or ranges) larger than this are streamed from disk
+#define STREAM_MIN_SIZE (1024 * 1024)
+
 namespace webserver {
 	using namespace dcpp;
 
@@ -60,6 +63,7 @@ namespace webserver {
 
 	void FileServer::setResourcePath(const string& aPath) noexcept {
 		resourcePath = PathUtil::validateDirectoryPath(aPath);
+		resourceCache.load(resourcePath);
 	}
 
 	string FileServer::getExtension(const string& aResource) noexcept {
@@ -84,15 +88,12 @@ namespace webserver {
 		if (!extension.empty()) {
 			dcassert(extension[0] != '.');
 
-			// We have compressed versions only for JS files
-			if (extension == "js" && aRequest.get_header("Accept-Encoding").find("gzip") != string::npos) {
-				request += ".gz";
-				headers_.emplace_back("Content-Encoding", "gzip");
-			}
-
 			if (extension != "html" && aResource != "/sw.js") {
 				// File versioning is done with hashes in filenames (except for the index file and service worker)
 				HttpUtil::addCacheControlHeader(headers_, 365);
+			} else {
+				// Must be revalidated with the ETag
+				headers_.emplace_back("Cache-Control", "no-cache");
 			}
 		} else {
 			// Forward all requests for non-static files to index
@@ -109,7 +110,7 @@ namespace webserver {
 			request = "index.html";
 
 			// The main chunk name may change and it's stored in the HTML file
-			HttpUtil::addCacheControlHeader(headers_, 0);
+			headers_.emplace_back("Cache-Control", "no-cache");
 		}
 
 		// Avoid double separators because of assertions
@@ -205,11 +206,11 @@ namespace webserver {
 	}
 
 	websocketpp::http::status_code::value FileServer::handleRequest(const HttpRequest& aRequest,
-		string& output_, StringPairList& headers_, const FileDeferredHandler& aDeferF) {
+		string& output_, StringPairList& headers_, unique_ptr<FileStream>& stream_, const FileDeferredHandler& aDeferF) {
 
 		const auto& httpRequest = aRequest.httpRequest;
 		if (httpRequest.get_method() == "GET") {
-			return handleGetRequest(httpRequest, output_, headers_, aRequest.session, aDeferF);
+			return handleGetRequest(httpRequest, output_, headers_, stream_, aRequest.session, aDeferF);
 		} else if (httpRequest.get_method() == "POST") {
 			return handlePostRequest(httpRequest, output_, headers_, aRequest.session);
 		}
@@ -219,7 +220,7 @@ namespace webserver {
 	}
 
 	websocketpp::http::status_code::value FileServer::handleGetRequest(const websocketpp::http::parser::request& aRequest,
-		string& output_, StringPairList& headers_, const SessionPtr& aSession, const FileDeferredHandler& aDeferF) {
+		string& output_, StringPairList& headers_, unique_ptr<FileStream>& stream_, const SessionPtr& aSession, const FileDeferredHandler& aDeferF) {
 
 		const auto& requestUrl = aRequest.get_uri();
 		dcdebug("Requesting file %s\n", requestUrl.c_str());
@@ -254,16 +255,32 @@ namespace webserver {
 			return e.getCode();
 		}
 
+		if (!isViewFile && aRequest.get_header("Range").empty()) {
+			auto resource = resourceCache.getResource(filePath);
+			if (resource) {
+				return handleCachedResource(resource, filePath, aRequest, output_, headers_);
+			}
+		}
+
 		auto fileSize = File::getSize(filePath);
 		int64_t startPos = 0, endPos = fileSize - 1;
 
 		auto partialContent = HttpUtil::parsePartialRange(aRequest.get_header("Range"), startPos, endPos);
 
+		// Text files need to be converted in memory
+		const auto ext = PathUtil::getFileExt(filePath);
+		const auto convertEncoding = ext == ".nfo";
+
 		// Read file
 		try {
-			File f(filePath, File::READ, File::OPEN);
-			f.setPos(startPos);
-			output_ = f.read(static_cast<size_t>(endPos) + 1);
+			auto f = make_unique<File>(filePath, File::READ, File::OPEN);
+			auto length = max<int64_t>(endPos - startPos + 1, 0);
+			if (!convertEncoding && length > STREAM_MIN_SIZE) {
+				stream_ = make_unique<FileStream>(std::move(f), startPos, length);
+			} else {
+				f->setPos(startPos);
+				output_ = f->read(static_cast<size_t>(length));
+			}
 		} catch (const FileException& e) {
 			dcdebug("Failed to serve the file %s: %s\n", filePath.c_str(), e.getError().c_str());
 
@@ -277,8 +294,7 @@ namespace webserver {
 		}
 
 		{
-			const auto ext = PathUtil::getFileExt(filePath);
-			if (ext == ".nfo") {
+			if (convertEncoding) {
 				string encoding;
 
 				// Platform-independent encoding conversion function could be added if there is more use for it
@@ -292,9 +308,7 @@ namespace webserver {
 		}
 
 		{
-			// Get the mime type (but get it from the original request with gzipped content)
-			auto usingEncoding = ranges::find(headers_ | views::keys, "Content-Encoding").base() != headers_.end();
-			auto type = HttpUtil::getMimeType(usingEncoding ? requestUrl : filePath);
+			auto type = HttpUtil::getMimeType(filePath);
 			if (type) {
 				headers_.emplace_back("Content-Type", type);
 			}
@@ -309,6 +323,35 @@ namespace webserver {
 		return websocketpp::http::status_code::ok;
 	}
 
+	websocketpp::http::status_code::value FileServer::handleCachedResource(const WebResourceCache::ResourcePtr& aResource, const string& aFilePath,
+		const websocketpp::http::parser::request& aRequest, string& output_, StringPairList& headers_) const noexcept {
+
+		// Each encoding has its own ETag so that caches won't mix the variants
+		auto useGzip = !aResource->gzipContent.empty() && aRequest.get_header("Accept-Encoding").find("gzip") != string::npos;
+		const auto& etag = useGzip ? aResource->gzipEtag : aResource->etag;
+
+		headers_.emplace_back("ETag", etag);
+		headers_.emplace_back("Vary", "Accept-Encoding");
+
+		if (HttpUtil::matchesETag(aRequest.get_header("If-None-Match"), etag)) {
+			return websocketpp::http::status_code::not_modified;
+		}
+
+		if (useGzip) {
+			output_ = aResource->gzipContent;
+			headers_.emplace_back("Content-Encoding", "gzip");
+		} else {
+			output_ = aResource->content;
+		}
+
+		auto type = HttpUtil::getMimeType(aFilePath);
+		if (type) {
+			headers_.emplace_back("Content-Type", type);
+		}
+
+		return websocketpp::http::status_code::ok;
+	}
+
 	websocketpp::http::status_code::value FileServer::handleProxyDownload(const string& aRequestUrl, string& output_, const FileDeferredHandler& aDeferF) noexcept {
 		string protocol, host, port, path, query, fragment;
 		LinkUtil::decodeUrl(aRequestUrl, protocol, host, port, path, query, fragment);
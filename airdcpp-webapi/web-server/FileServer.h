@@ -21,7 +21,10 @@
 
 #include "forward.h"
 
+#include <web-server/WebResourceCache.h>
+
 #include <airdcpp/core/header/typedefs.h>
+#include <airdcpp/core/io/File.h>
 #include <airdcpp/core/thread/CriticalSection.h>
 
 
@@ -32,13 +35,21 @@ namespace webserver {
 		FileServer();
 		~FileServer();
 
+		// File range that should be sent directly from disk instead of the output buffer
+		struct FileStream {
+			unique_ptr<File> file;
+			int64_t startPos = 0;
+			int64_t length = 0;
+		};
+
 		void setResourcePath(const string& aPath) noexcept;
 
 		// Get location of the file server root directory (Web UI files)
 		const string& getResourcePath() const noexcept;
 
+		// stream_ is set for large files (output_ is empty in that case)
 		websocketpp::http::status_code::value handleRequest(const HttpRequest& aRequest, 
-			std::string& output_, StringPairList& headers_, const FileDeferredHandler& aDeferF);
+			std::string& output_, StringPairList& headers_, unique_ptr<FileStream>& stream_, const FileDeferredHandler& aDeferF);
 
 		string getTempFilePath(const string& fileId) const noexcept;
 		void stop() noexcept;
@@ -47,7 +58,7 @@ namespace webserver {
 		FileServer& operator=(FileServer&) = delete;
 	private:
 		websocketpp::http::status_code::value handleGetRequest(const websocketpp::http::parser::request& aRequest,
-			std::string& output_, StringPairList& headers_, const SessionPtr& aSession, const FileDeferredHandler& aDeferF);
+			std::string& output_, StringPairList& headers_, unique_ptr<FileStream>& stream_, const SessionPtr& aSession, const FileDeferredHandler& aDeferF);
 
 		websocketpp::http::status_code::value handleProxyDownload(const string& aUrl, string& output_, const FileDeferredHandler& aDeferF) noexcept;
 		void onProxyDownloadCompleted(int64_t aDownloadId, const HTTPFileCompletionF& aCompletionF) noexcept;
@@ -56,6 +67,7 @@ namespace webserver {
 			std::string& output_, StringPairList& headers_, const SessionPtr& aSession) noexcept;
 
 		string resourcePath;
+		WebResourceCache resourceCache;
 
 		string parseResourcePath(const string& aResource, const websocketpp::http::parser::request& aRequest, StringPairList& headers_) const;
 		string parseViewFilePath(const string& aResource, StringPairList& headers_, const SessionPtr& aSession) const;
@@ -63,6 +75,10 @@ namespace webserver {
 
 		static string getExtension(const string& aResource) noexcept;
 
+		// Serve an unmodified resource file from memory
+		websocketpp::http::status_code::value handleCachedResource(const WebResourceCache::ResourcePtr& aResource, const string& aFilePath, 
+			const websocketpp::http::parser::request& aRequest, std::string& output_, StringPairList& headers_) const noexcept;
+
 		mutable SharedMutex cs;
 		StringMap tempFiles;
 
@@ -0,0 +1,180 @@
+/*
+* Copyright (C) 2011-2024 AirDC++ Project
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+*/
+
+#ifndef DCPLUSPLUS_WEBSERVER_HTTP_FILE_RESPONSE_H
+#define DCPLUSPLUS_WEBSERVER_HTTP_FILE_RESPONSE_H
+
+#include "stdinc.h"
+
+#include <airdcpp/core/classes/Exception.h>
+#include <airdcpp/core/io/File.h>
+
+#include <boost/asio/write.hpp>
+
+#ifdef __linux__
+#include <sys/sendfile.h>
+#endif
+
+namespace webserver {
+	// Sends the response headers followed by a range of the file without loading the file in memory
+	// The next chunk is read only after the previous one has been written to the socket,
+	// so the memory usage stays at CHUNK_SIZE regardless of the file size or the client speed
+	template<class SocketT>
+	class HttpFileResponse : public std::enable_shared_from_this<HttpFileResponse<SocketT>> {
+	public:
+		using CompletionF = std::function<void(const boost::system::error_code& aError, int64_t aBytesSent)>;
+
+		static const size_t CHUNK_SIZE = 256 * 1024;
+
+		HttpFileResponse(SocketT& aSocket, unique_ptr<File>&& aFile, int64_t aStartPos, int64_t aLength, string&& aHeaders, CompletionF&& aCompletionF) :
+			socket(aSocket), file(std::move(aFile)), pos(aStartPos), bytesLeft(aLength), headers(std::move(aHeaders)), completionF(std::move(aCompletionF)) {
+
+		}
+
+		void start() noexcept {
+			boost::asio::async_write(socket, boost::asio::buffer(headers), [self = this->shared_from_this()](const boost::system::error_code& aError, size_t) {
+				if (aError) {
+					self->finish(aError);
+					return;
+				}
+
+				self->sendContent();
+			});
+		}
+
+		HttpFileResponse(HttpFileResponse&) = delete;
+		HttpFileResponse& operator=(HttpFileResponse&) = delete;
+	private:
+		void sendContent() noexcept {
+#ifdef __linux__
+			if constexpr (std::is_same_v<SocketT, boost::asio::ip::tcp::socket>) {
+				// Plain connections can let the kernel copy the data
+				boost::system::error_code ec;
+				socket.native_non_blocking(true, ec);
+				if (!ec) {
+					sendFileChunk();
+					return;
+				}
+			}
+#endif
+
+			readChunk();
+		}
+
+#ifdef __linux__
+		void sendFileChunk() noexcept {
+			while (bytesLeft > 0) {
+				off_t offset = static_cast<off_t>(pos);
+				auto sent = ::sendfile(socket.native_handle(), file->getNativeHandle(), &offset, static_cast<size_t>(std::min<int64_t>(bytesLeft, CHUNK_SIZE)));
+				if (sent > 0) {
+					onSent(static_cast<size_t>(sent));
+					continue;
+				}
+
+				if (sent == 0) {
+					// The file was truncated
+					finish(boost::asio::error::eof);
+					return;
+				}
+
+				if (errno == EINTR) {
+					continue;
+				}
+
+				if (errno == EAGAIN || errno == EWOULDBLOCK) {
+					// Wait until the client has received the previous data
+					socket.async_wait(boost::asio::ip::tcp::socket::wait_write, [self = this->shared_from_this()](const boost::system::error_code& aError) {
+						if (aError) {
+							self->finish(aError);
+							return;
+						}
+
+						self->sendFileChunk();
+					});
+					return;
+				}
+
+				finish(boost::system::error_code(errno, boost::system::system_category()));
+				return;
+			}
+
+			finish(boost::system::error_code());
+		}
+#endif
+
+		void readChunk() noexcept {
+			if (bytesLeft == 0) {
+				finish(boost::system::error_code());
+				return;
+			}
+
+			if (buffer.empty()) {
+				buffer.resize(static_cast<size_t>(std::min<int64_t>(bytesLeft, CHUNK_SIZE)));
+			}
+
+			size_t len = 0;
+			try {
+				len = file->readAt(buffer.data(), static_cast<size_t>(std::min<int64_t>(bytesLeft, buffer.size())), pos);
+			} catch (const FileException& e) {
+				dcdebug("HttpFileResponse: failed to read the file (%s)\n", e.getError().c_str());
+				finish(boost::asio::error::broken_pipe);
+				return;
+			}
+
+			if (len == 0) {
+				finish(boost::asio::error::eof);
+				return;
+			}
+
+			boost::asio::async_write(socket, boost::asio::buffer(buffer.data(), len), [self = this->shared_from_this()](const boost::system::error_code& aError, size_t aBytesWritten) {
+				if (aError) {
+					self->finish(aError);
+					return;
+				}
+
+				self->onSent(aBytesWritten);
+				self->readChunk();
+			});
+		}
+
+		void onSent(size_t aBytes) noexcept {
+			pos += aBytes;
+			bytesLeft -= aBytes;
+			bytesSent += aBytes;
+		}
+
+		void finish(const boost::system::error_code& aError) noexcept {
+			file.reset();
+			completionF(aError, bytesSent);
+		}
+
+		SocketT& socket;
+		unique_ptr<File> file;
+
+		int64_t pos;
+		int64_t bytesLeft;
+		int64_t bytesSent = 0;
+
+		string headers;
+		ByteVector buffer;
+
+		const CompletionF completionF;
+	};
+}
+
+#endif
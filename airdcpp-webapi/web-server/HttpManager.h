@@ -23,6 +23,7 @@
 
 #include "FileServer.h"
 
+#include "HttpFileResponse.h"
 #include "HttpRequest.h"
 #include "HttpUtil.h"
 #include "WebServerManager.h"
@@ -145,7 +146,7 @@ namespace webserver {
 
 				con->append_header("Connection", "close"); // Workaround for https://github.com/zaphoyd/websocketpp/issues/890
 
-				if (HttpUtil::isStatusOk(aStatus)) {
+				if (HttpUtil::isStatusOk(aStatus) || aStatus == websocketpp::http::status_code::not_modified) {
 					// Don't set any incomplete/invalid headers in case of errors...
 					for (const auto& [name, value] : aHeaders) {
 						con->append_header(name, value);
@@ -170,12 +171,53 @@ namespace webserver {
 				};
 			};
 
-			auto status = fileServer.handleRequest(aRequest, output, headers, deferredF);
-			if (!isDeferred) {
+			unique_ptr<FileServer::FileStream> stream;
+			auto status = fileServer.handleRequest(aRequest, output, headers, stream, deferredF);
+			if (stream && HttpUtil::isStatusOk(status)) {
+				dcassert(!isDeferred);
+				streamHttpFile(con, status, headers, std::move(*stream), aRequest.ip);
+			} else if (!isDeferred) {
 				responseF(status, output, headers);
 			}
 		}
 
+		// Write the response directly to the socket (websocketpp requires the whole body to be in memory)
+		// The deferred response is completed via websocketpp afterwards so that the connection gets terminated normally (including the TLS shutdown)
+		template <typename ConnType>
+		void streamHttpFile(const ConnType& con, websocketpp::http::status_code::value aStatus, const StringPairList& aHeaders, FileServer::FileStream&& aStream, const string& aIp) {
+			con->defer_http_response();
+
+			// Used for the access log of websocketpp
+			con->set_status(aStatus);
+
+			string responseHeaders = "HTTP/1.1 " + Util::toString(aStatus) + " " + websocketpp::http::status_code::get_string(aStatus) + "\r\n";
+			for (const auto& [name, value] : aHeaders) {
+				responseHeaders += name + ": " + value + "\r\n";
+			}
+
+			responseHeaders += "Content-Length: " + Util::toString(aStream.length) + "\r\n";
+			responseHeaders += "Connection: close\r\n\r\n";
+
+			using SocketType = std::remove_reference_t<decltype(con->get_socket())>;
+			auto response = std::make_shared<HttpFileResponse<SocketType>>(
+				con->get_socket(), std::move(aStream.file), aStream.startPos, aStream.length, std::move(responseHeaders),
+				[this, con, ip = aIp, status = aStatus](const boost::system::error_code& aError, int64_t aBytesSent) {
+					wsm->onData(
+						con->get_request().get_method() + " " + con->get_resource() + ": " + Util::toString(status) + " (" + Util::formatBytes(aBytesSent) + ", streamed" + (aError ? ", " + aError.message() : Util::emptyString) + ")",
+						TransportType::TYPE_HTTP_FILE,
+						Direction::OUTGOING,
+						ip
+					);
+
+					// The response has been written already, let websocketpp finish the request as if it had written it
+					// Non-websocket connections are terminated after the response
+					con->handle_write_http_response(aError ? websocketpp::error::make_error_code(websocketpp::error::general) : websocketpp::lib::error_code());
+				}
+			);
+
+			response->start();
+		}
+
 		template <typename EndpointType>
 		void handleHttpRequest(EndpointType* s, bool aIsSecure, websocketpp::connection_hdl hdl) {
 			// Blocking HTTP Handler
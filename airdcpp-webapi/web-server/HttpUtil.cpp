@@ -25,6 +25,7 @@
 #include <airdcpp/util/Util.h>
 
 #include "boost/algorithm/string/replace.hpp"
+#include "boost/algorithm/string/trim.hpp"
 
 
 namespace webserver {
@@ -130,6 +131,23 @@ namespace webserver {
 		headers_.emplace_back("Cache-Control", aDaysValid == 0 ? "no-store" : "max-age=" + Util::toString(aDaysValid * 24 * 60 * 60));
 	}
 
+	bool HttpUtil::matchesETag(const string& aIfNoneMatch, const string& aETag) noexcept {
+		for (auto tag: StringTokenizer<string>(aIfNoneMatch, ',').getTokens()) {
+			boost::algorithm::trim(tag);
+
+			// Weak comparison is used for conditional GET requests
+			if (tag.starts_with("W/")) {
+				tag = tag.substr(2);
+			}
+
+			if (tag == "*" || tag == aETag) {
+				return true;
+			}
+		}
+
+		return false;
+	}
+
 	string HttpUtil::formatPartialRange(int64_t aStartPos, int64_t aEndPos, int64_t aFileSize) noexcept {
 		dcassert(aEndPos < aFileSize);
 		return "bytes " + Util::toString(aStartPos) + "-" + Util::toString(aEndPos) + "/" + Util::toString(aFileSize);
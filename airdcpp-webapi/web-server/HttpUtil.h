@@ -40,6 +40,9 @@ namespace webserver {
 
 		static void addCacheControlHeader(StringPairList& headers_, int aDaysValid) noexcept;
 
+		// Returns true if the If-None-Match header value contains the given (quoted) entity tag
+		static bool matchesETag(const string& aIfNoneMatch, const string& aETag) noexcept;
+
 		static bool isStatusOk(int aCode) noexcept;
 		static bool parseStatus(const string& aResponse, int& code_, string& text_) noexcept;
 		static string parseAuthToken(const websocketpp::http::parser::request& aRequest) noexcept;
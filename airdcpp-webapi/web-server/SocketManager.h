@@ -52,6 +52,7 @@ namespace webserver {
 			aEndpoint.set_message_handler(
 				std::bind_front(&SocketManager::handleSocketMessage<EndpointType>, this));
 
+			aEndpoint.set_validate_handler(std::bind_front(&SocketManager::handleValidateSocket<EndpointType>, this, &aEndpoint));
 			aEndpoint.set_close_handler(std::bind_front(&SocketManager::handleSocketDisconnected, this));
 			aEndpoint.set_open_handler(std::bind_front(&SocketManager::handleSocketConnected<EndpointType>, this, &aEndpoint, aIsSecure));
 
@@ -61,6 +62,20 @@ namespace webserver {
 		void onAuthenticated(const SessionPtr& aSession, const WebSocketPtr& aSocket) noexcept;
 
 		// Websocketpp event handlers
+		template <typename EndpointType>
+		bool handleValidateSocket(EndpointType* aServer, websocketpp::connection_hdl hdl) {
+			// Select the preferred message encoding
+			auto con = aServer->get_con_from_hdl(hdl);
+			for (const auto& subprotocol: con->get_requested_subprotocols()) {
+				if (WebSocket::parseEncoding(subprotocol)) {
+					con->select_subprotocol(subprotocol);
+					break;
+				}
+			}
+
+			return true;
+		}
+
 		template <typename EndpointType>
 		void handleSocketConnected(EndpointType* aServer, bool aIsSecure, websocketpp::connection_hdl hdl) {
 			auto con = aServer->get_con_from_hdl(hdl);
@@ -86,7 +101,8 @@ namespace webserver {
 				return;
 			}
 
-			socket->onData(msg->get_payload(), [&socket, this](const SessionPtr& aSession) {
+			auto isBinary = msg->get_opcode() == websocketpp::frame::opcode::binary;
+			socket->onData(msg->get_payload(), isBinary, [&socket, this](const SessionPtr& aSession) {
 				onAuthenticated(aSession, socket);
 			});
 		}
@@ -0,0 +1,215 @@
+/*
+* Copyright (C) 2011-2024 AirDC++ Project
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+*/
+
+#include "stdinc.h"
+
+#include <web-server/WebResourceCache.h>
+
+#include <airdcpp/core/classes/Exception.h>
+#include <airdcpp/core/io/File.h>
+#include <airdcpp/hash/value/MerkleTree.h>
+#include <airdcpp/util/PathUtil.h>
+
+#include <zlib.h>
+
+// The UI bundle is a few megabytes, larger files (e.g. source maps) are read from disk
+#define MAX_RESOURCE_SIZE (10 * 1024 * 1024)
+#define MAX_CACHE_SIZE (100 * 1024 * 1024)
+
+namespace webserver {
+	using namespace dcpp;
+
+	void WebResourceCache::load(const string& aDirectory) noexcept {
+		clear();
+
+		StringList directories = { aDirectory };
+		while (!directories.empty()) {
+			auto directory = std::move(directories.back());
+			directories.pop_back();
+
+			try {
+				File::forEachFile(directory, "*", [&](const FilesystemItem& aInfo) {
+					auto path = aInfo.getPath(directory);
+					if (aInfo.isDirectory) {
+						directories.push_back(path);
+					} else if (PathUtil::getFileExt(path) != ".gz") {
+						// Compressed variants are loaded with the original file
+						getResource(path);
+					}
+				});
+			} catch (const FileException& e) {
+				dcdebug("WebResourceCache: failed to list %s (%s)\n", directory.c_str(), e.getError().c_str());
+			}
+		}
+
+		auto stats = getStats();
+		dcdebug("WebResourceCache: %d files cached (%s, %s compressed)\n", static_cast<int>(stats.files), Util::formatBytes(stats.size).c_str(), Util::formatBytes(stats.compressedSize).c_str());
+	}
+
+	void WebResourceCache::clear() noexcept {
+		WLock l(cs);
+		resources.clear();
+		totalSize = 0;
+	}
+
+	WebResourceCache::Stats WebResourceCache::getStats() const noexcept {
+		Stats stats;
+
+		RLock l(cs);
+		for (const auto& resource: resources | views::values) {
+			stats.files++;
+			stats.size += resource->size;
+			stats.compressedSize += resource->gzipContent.empty() ? resource->size : static_cast<int64_t>(resource->gzipContent.size());
+		}
+
+		return stats;
+	}
+
+	WebResourceCache::ResourcePtr WebResourceCache::getResource(const string& aPath) noexcept {
+		int64_t size;
+		time_t lastModified;
+		try {
+			FileItem item(aPath);
+			if (item.isDirectory()) {
+				removeResource(aPath);
+				return nullptr;
+			}
+
+			size = item.getSize();
+			lastModified = item.getLastWriteTime();
+		} catch (const FileException&) {
+			// Don't keep serving deleted files
+			removeResource(aPath);
+			return nullptr;
+		}
+
+		ResourcePtr oldResource;
+
+		{
+			RLock l(cs);
+			auto i = resources.find(aPath);
+			if (i != resources.end()) {
+				if (i->second->size == size && i->second->lastModified == lastModified) {
+					return i->second;
+				}
+
+				oldResource = i->second;
+			}
+		}
+
+		if (size > MAX_RESOURCE_SIZE) {
+			removeResource(aPath);
+			return nullptr;
+		}
+
+		ResourcePtr resource;
+		try {
+			resource = loadResource(aPath, size, lastModified);
+		} catch (const Exception& e) {
+			dcdebug("WebResourceCache: failed to load %s (%s)\n", aPath.c_str(), e.getError().c_str());
+			removeResource(aPath);
+			return nullptr;
+		}
+
+		{
+			WLock l(cs);
+			if (oldResource && resources.erase(aPath) > 0) {
+				totalSize -= oldResource->size;
+			}
+
+			if (totalSize + size <= MAX_CACHE_SIZE && resources.try_emplace(aPath, resource).second) {
+				totalSize += size;
+			}
+		}
+
+		return resource;
+	}
+
+	void WebResourceCache::removeResource(const string& aPath) noexcept {
+		WLock l(cs);
+		auto i = resources.find(aPath);
+		if (i != resources.end()) {
+			totalSize -= i->second->size;
+			resources.erase(i);
+		}
+	}
+
+	WebResourceCache::ResourcePtr WebResourceCache::loadResource(const string& aPath, int64_t aSize, time_t aLastModified) {
+		auto resource = make_shared<Resource>();
+		resource->size = aSize;
+		resource->lastModified = aLastModified;
+		resource->content = File(aPath, File::READ, File::OPEN).read();
+
+		if (isCompressible(aPath)) {
+			// Use the variant precompressed by the UI build when available
+			auto compressedPath = aPath + ".gz";
+			if (PathUtil::fileExists(compressedPath)) {
+				resource->gzipContent = File(compressedPath, File::READ, File::OPEN).read();
+			} else {
+				resource->gzipContent = compress(resource->content);
+			}
+
+			if (resource->gzipContent.size() >= resource->content.size() * 9 / 10) {
+				resource->gzipContent.clear();
+			}
+		}
+
+		TigerHash hash;
+		hash.update(resource->content.data(), resource->content.size());
+		auto contentHash = TTHValue(hash.finalize()).toBase32();
+		resource->etag = "\"" + contentHash + "\"";
+		if (!resource->gzipContent.empty()) {
+			resource->gzipEtag = "\"" + contentHash + "-gz\"";
+		}
+		return resource;
+	}
+
+	bool WebResourceCache::isCompressible(const string& aPath) noexcept {
+		static const StringList extensions = { ".js", ".css", ".html", ".json", ".svg", ".txt", ".map", ".ico", ".webmanifest" };
+
+		auto ext = Text::toLower(PathUtil::getFileExt(aPath));
+		return ranges::find(extensions, ext) != extensions.end();
+	}
+
+	string WebResourceCache::compress(const string& aContent) {
+		z_stream zs;
+		memset(&zs, 0, sizeof(zs));
+
+		// Add 16 to the window bits for gzip headers
+		if (deflateInit2(&zs, Z_BEST_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+			throw Exception("Failed to initialize zlib");
+		}
+
+		string ret(deflateBound(&zs, static_cast<uLong>(aContent.size())), 0);
+
+		zs.next_in = (Bytef*)aContent.data();
+		zs.avail_in = static_cast<uInt>(aContent.size());
+		zs.next_out = (Bytef*)ret.data();
+		zs.avail_out = static_cast<uInt>(ret.size());
+
+		auto err = deflate(&zs, Z_FINISH);
+		ret.resize(zs.total_out);
+		deflateEnd(&zs);
+
+		if (err != Z_STREAM_END) {
+			throw Exception("Compression failed");
+		}
+
+		return ret;
+	}
+}
@@ -0,0 +1,76 @@
+/*
+* Copyright (C) 2011-2024 AirDC++ Project
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+*/
+
+#ifndef DCPLUSPLUS_WEBSERVER_WEB_RESOURCE_CACHE_H
+#define DCPLUSPLUS_WEBSERVER_WEB_RESOURCE_CACHE_H
+
+#include "forward.h"
+
+#include <airdcpp/core/header/typedefs.h>
+#include <airdcpp/core/thread/CriticalSection.h>
+
+
+namespace webserver {
+	// In-memory cache for the static Web UI files
+	// Entries are validated against the file on disk for each request so that updated resources are picked up without a restart
+	class WebResourceCache {
+	public:
+		struct Resource {
+			string content;
+
+			// Empty if compression isn't useful for the file
+			string gzipContent;
+
+			// Quoted content hash (the compressed variant has a separate tag)
+			string etag;
+			string gzipEtag;
+
+			int64_t size = 0;
+			time_t lastModified = 0;
+		};
+
+		using ResourcePtr = std::shared_ptr<const Resource>;
+
+		// Cache all files in the resource directory
+		void load(const string& aDirectory) noexcept;
+		void clear() noexcept;
+
+		// Returns nullptr if the file doesn't exist or it's too large to be cached
+		ResourcePtr getResource(const string& aPath) noexcept;
+
+		struct Stats {
+			size_t files = 0;
+			int64_t size = 0;
+			int64_t compressedSize = 0;
+		};
+
+		Stats getStats() const noexcept;
+	private:
+		static ResourcePtr loadResource(const string& aPath, int64_t aSize, time_t aLastModified);
+		void removeResource(const string& aPath) noexcept;
+
+		static string compress(const string& aContent);
+		static bool isCompressible(const string& aPath) noexcept;
+
+		mutable SharedMutex cs;
+		unordered_map<string, ResourcePtr> resources;
+		int64_t totalSize = 0;
+	};
+}
+
+#endif
@@ -32,6 +32,21 @@
 
 
 namespace webserver {
+#define SUBPROTOCOL_CBOR "airdcpp-cbor"
+#define SUBPROTOCOL_MSGPACK "airdcpp-msgpack"
+
+	optional<WebSocket::Encoding> WebSocket::parseEncoding(const string& aSubprotocol) noexcept {
+		if (aSubprotocol.empty()) {
+			return Encoding::JSON;
+		} else if (aSubprotocol == SUBPROTOCOL_CBOR) {
+			return Encoding::CBOR;
+		} else if (aSubprotocol == SUBPROTOCOL_MSGPACK) {
+			return Encoding::MSGPACK;
+		}
+
+		return nullopt;
+	}
+
 	WebSocket::WebSocket(bool aIsSecure, websocketpp::connection_hdl aHdl, const websocketpp::http::parser::request& aRequest, server_plain* aServer, WebServerManager* aWsm) : WebSocket(aIsSecure, aHdl, aRequest, aWsm) {
 		plainServer = aServer;
 	}
@@ -45,19 +60,24 @@ namespace webserver {
 	{
 		debugMessage("Websocket created");
 
-		// Parse remote IP
+		// Parse remote IP and the negotiated message encoding
+		string subprotocol;
 		try {
 			if (secure) {
 				auto conn = tlsServer->get_con_from_hdl(hdl);
+				subprotocol = conn->get_subprotocol();
 				ip = conn->get_raw_socket().remote_endpoint().address().to_string();
 			} else {
 				auto conn = plainServer->get_con_from_hdl(hdl);
+				subprotocol = conn->get_subprotocol();
 				ip = conn->get_raw_socket().remote_endpoint().address().to_string();
 			}
 		} catch (const boost::system::system_error& e) {
 			dcdebug("WebSocket::getIp failed: %s\n", e.what());
 		}
 
+		encoding = parseEncoding(subprotocol).value_or(Encoding::JSON);
+
 		// Parse URL
 		url = aRequest.get_uri();
 		if (!url.empty() && url.back() != '/') {
@@ -117,22 +137,66 @@ namespace webserver {
 		dcdebug(string(aMessage + " (%s)\n").c_str(), session ? session->getAuthToken().c_str() : "no session");
 	}
 
+	string WebSocket::serialize(const json& aJson) const {
+		string ret;
+		switch (encoding) {
+			case Encoding::CBOR: json::to_cbor(aJson, ret); break;
+			case Encoding::MSGPACK: json::to_msgpack(aJson, ret); break;
+			default: ret = aJson.dump(); break;
+		}
+
+		return ret;
+	}
+
+	string WebSocket::createEventMessage(const string& aSubscription, const string& aSerializedData) const {
+		// Same output as when serializing the whole message object (the properties are sorted by name)
+		if (encoding == Encoding::JSON) {
+			return R"({"data":)" + aSerializedData + R"(,"event":)" + serialize(aSubscription) + "}";
+		}
+
+		// Map with two items
+		string ret(1, encoding == Encoding::CBOR ? '\xA2' : '\x82');
+		ret += serialize("data");
+		ret += aSerializedData;
+		ret += serialize("event");
+		ret += serialize(aSubscription);
+		return ret;
+	}
+
+	json WebSocket::deserialize(const string& aMessage, bool aIsBinary) const {
+		if (aIsBinary) {
+			switch (encoding) {
+				case Encoding::CBOR: return json::from_cbor(aMessage);
+				case Encoding::MSGPACK: return json::from_msgpack(aMessage);
+				default: break;
+			}
+		}
+
+		return json::parse(aMessage);
+	}
+
 	void WebSocket::sendPlain(const json& aJson) {
 		string str;
 		try {
-			str = aJson.dump();
+			str = serialize(aJson);
 		} catch (const json::exception& e) {
 			logError("Failed to convert data to JSON: " + string(e.what()), websocketpp::log::elevel::fatal);
 			throw;
 		}
 
-		wsm->onData(str, TransportType::TYPE_SOCKET, Direction::OUTGOING, getIp());
+		sendSerialized(str);
+	}
 
+	void WebSocket::sendSerialized(const string& aMessage) noexcept {
+		auto isBinary = encoding != Encoding::JSON;
+		wsm->onData(isBinary ? "(binary message, " + Util::formatBytes(static_cast<int64_t>(aMessage.size())) + ")" : aMessage, TransportType::TYPE_SOCKET, Direction::OUTGOING, getIp());
+
+		auto opcode = isBinary ? websocketpp::frame::opcode::binary : websocketpp::frame::opcode::text;
 		try {
 			if (secure) {
-				tlsServer->send(hdl, str, websocketpp::frame::opcode::text);
+				tlsServer->send(hdl, aMessage, opcode);
 			} else {
-				plainServer->send(hdl, str, websocketpp::frame::opcode::text);
+				plainServer->send(hdl, aMessage, opcode);
 			}
 		} catch (const websocketpp::exception& e) {
 			logError("Failed to send data: " + string(e.what()), websocketpp::log::elevel::fatal);
@@ -173,26 +237,24 @@ namespace webserver {
 		}
 	}
 
-	void WebSocket::parseRequest(const string& aRequest, int& callbackId_, string& method_, string& path_, json& data_) {
-		const auto requestJson = json::parse(aRequest);
-
+	void WebSocket::parseRequest(const json& requestJson, int& callbackId_, string& method_, string& path_, json& data_) {
 		callbackId_ = JsonUtil::getOptionalFieldDefault<int>("callback_id", requestJson, -1);
 		path_ = requestJson.at("path");
 		data_ = JsonUtil::getOptionalRawField("data", requestJson);
 		method_ = requestJson.at("method");
 	}
 
-	void WebSocket::onData(const string& aMessage, const SessionCallback& aAuthCallback) {
+	void WebSocket::onData(const string& aMessage, bool aIsBinary, const SessionCallback& aAuthCallback) {
 		// Logging
-		wsm->onData(aMessage, TransportType::TYPE_SOCKET, Direction::INCOMING, getIp());
-		dcdebug("Received socket request: %s\n", Util::truncate(aMessage, 500).c_str());
+		wsm->onData(aIsBinary ? "(binary message, " + Util::formatBytes(static_cast<int64_t>(aMessage.size())) + ")" : aMessage, TransportType::TYPE_SOCKET, Direction::INCOMING, getIp());
+		dcdebug("Received socket request: %s\n", aIsBinary ? "(binary)" : Util::truncate(aMessage, 500).c_str());
 
 		// Parse request
 		int callbackId = -1;
 		string method, path;
 		json data;
 		try {
-			parseRequest(aMessage, callbackId, method, path, data);
+			parseRequest(deserialize(aMessage, aIsBinary), callbackId, method, path, data);
 		} catch (const json::exception& e) {
 			sendApiResponse(nullptr, ApiRequest::toResponseErrorStr("Failed to parse JSON: " + string(e.what())), websocketpp::http::status_code::bad_request, callbackId);
 			return;
@@ -32,6 +32,16 @@ namespace webserver {
 
 	class WebSocket {
 	public:
+		// Message encodings, binary ones can be requested with the matching WebSocket subprotocol
+		enum class Encoding {
+			JSON,
+			CBOR,
+			MSGPACK,
+		};
+
+		// Returns nullopt for unsupported subprotocols
+		static optional<Encoding> parseEncoding(const string& aSubprotocol) noexcept;
+
 		WebSocket(bool aIsSecure, websocketpp::connection_hdl aHdl, const websocketpp::http::parser::request& aRequest, server_plain* aServer, WebServerManager* aWsm);
 		WebSocket(bool aIsSecure, websocketpp::connection_hdl aHdl, const websocketpp::http::parser::request& aRequest, server_tls* aServer, WebServerManager* aWsm);
 		~WebSocket();
@@ -47,9 +57,24 @@ namespace webserver {
 		// NMDC code can't be trusted to parse the incoming messages without incorrectly 
 		// splitting multibyte character sequences in malformed received data...
 		void sendPlain(const json& aJson);
+
+		// Send a message that has been serialized with the encoding of this socket
+		void sendSerialized(const string& aMessage) noexcept;
+
+		// Throws json::exception on conversion errors
+		string serialize(const json& aJson) const;
+
+		// Create a message from event data that has been serialized with the encoding of this socket
+		// Throws json::exception on conversion errors
+		string createEventMessage(const string& aSubscription, const string& aSerializedData) const;
+
+		Encoding getEncoding() const noexcept {
+			return encoding;
+		}
 		void sendApiResponse(const json& aJsonResponse, const json& aErrorJson, websocketpp::http::status_code::value aCode, int aCallbackId) noexcept;
 
-		void onData(const string& aPayload, const SessionCallback& aAuthCallback);
+		// Binary messages are decoded with the encoding of this socket
+		void onData(const string& aPayload, bool aIsBinary, const SessionCallback& aAuthCallback);
 
 		WebSocket(WebSocket&) = delete;
 		WebSocket& operator=(WebSocket&) = delete;
@@ -74,7 +99,7 @@ namespace webserver {
 		const websocketpp::http::parser::request& getRequest() noexcept;
 
 		// Throws json exception (from the json library) in case of invalid JSON, ArgumentException in case of invalid properties
-		static void parseRequest(const string& aRequest, int& callbackId_, string& method_, string& path_, json& data_);
+		static void parseRequest(const json& aRequestJson, int& callbackId_, string& method_, string& path_, json& data_);
 	protected:
 		WebSocket(bool aIsSecure, websocketpp::connection_hdl aHdl, const websocketpp::http::parser::request& aRequest, WebServerManager* aWsm);
 	private:
@@ -89,6 +114,9 @@ namespace webserver {
 		const time_t timeCreated;
 		string url;
 		string ip;
+		Encoding encoding = Encoding::JSON;
+
+		json deserialize(const string& aMessage, bool aIsBinary) const;
 	};
 }
 